@@ -0,0 +1,161 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Archive.h
+ * 
+ * Summary:	Lays out saved games as a versioned binary container, which is
+ *		mapped into memory and validated in place when loaded
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Sections follow one another in order, each rounded up to four bytes
+ *	Header			Magic, version, players, section counts, and checksum of whole archive
+ *	Block			Current position, as location of each piece
+ *	Exchanges		Exchange restrictions in effect
+ *	Origin			Position game is recorded from, in notation
+ *	Entries			Actions performed since, packed along with their tokens
+ *	Repetitions		Positions to have occurred post initial arrangement (optional)
+ * 
+ * Values are in byte order of machine that wrote them, which is checked by
+ * order mark of header
+ * Checksum is taken over header as well, with checksum itself zeroed
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "Game/Mapping.h"
+#include "Game/Notation.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define ARCHIVE_VERSION 2
+#define ARCHIVE_ORDER 0x0102
+
+#define ARCHIVE_REPETITIONS 0x1 // Flag of header set if repetitions are included
+#define ARCHIVE_EMPTY 0xFF // Placeholder of tiers without piece
+
+static const char ARCHIVE_MAGIC[] = { 'G', '3', 'D', 'A', };
+
+class Archive
+{
+public:
+	enum Location { NONE = 0, BOARD = 1, BLACK_HAND = 2, WHITE_HAND = 3, };
+
+	struct Header
+	{
+		char magic[4];
+
+		std::uint16_t version;
+		std::uint16_t order;
+		std::uint32_t flags;
+
+		std::int32_t turn;
+
+		std::uint8_t levels[2]; // Black and white
+		std::uint8_t backends[2];
+		std::uint8_t evaluations[2];
+		std::uint8_t padding[2];
+
+		std::uint32_t exchanges;
+		std::uint32_t origin; // Characters
+		std::uint32_t entries;
+		std::uint32_t repetitions;
+
+		std::uint32_t checksum; // Of whole archive, taken while zeroed
+	};
+
+	// Where piece lies, indices of squares and slots counted as x + y * columns
+	struct Placement
+	{
+		std::uint8_t location;
+		std::uint8_t index;
+		std::uint8_t tier; // From bottom of stack
+		std::uint8_t side;
+	};
+
+	struct Block
+	{
+		Placement placements[NUM_PIECES]; // By identifier
+	};
+
+	struct Exchange
+	{
+		std::int32_t square; // Identifier
+		std::int32_t turn;
+	};
+
+	struct Entry
+	{
+		Player::Word word;
+		char token[NOTATION_MOVE_SIZE]; // Null terminated unless of full length
+	};
+
+	struct Repetition
+	{
+		std::int32_t count;
+		std::uint8_t IDs[BOARD_COLS * BOARD_ROWS][MAX_HEIGHT]; // Face and color, bottom to top, or placeholder
+		std::uint8_t padding[1];
+	};
+
+	// Sections as gathered from game, which are laid out apart from it
+	struct Contents
+	{
+		Header header;
+		Block block;
+
+		std::vector<Exchange> exchanges;
+		std::string origin;
+		std::vector<Entry> entries;
+		std::vector<Repetition> repetitions;
+	};
+
+	// Member functions
+	// ----------------
+	inline const Header* getHeaderPtr() { return reinterpret_cast<const Header*>(this->m_mapping.getData()); }
+	inline const Block* getBlockPtr() { return reinterpret_cast<const Block*>(this->m_mapping.getData() + this->m_block); }
+	inline const Exchange* getExchangesPtr() { return reinterpret_cast<const Exchange*>(this->m_mapping.getData() + this->m_exchanges); }
+	inline const char* getOriginPtr() { return this->m_mapping.getData() + this->m_origin; }
+	inline const Entry* getEntriesPtr() { return reinterpret_cast<const Entry*>(this->m_mapping.getData() + this->m_entries); }
+	inline const Repetition* getRepetitionsPtr() { return reinterpret_cast<const Repetition*>(this->m_mapping.getData() + this->m_repetitions); }
+
+	inline bool map(const std::string &p_path_ref) { return this->m_mapping.map(p_path_ref); } // Maps specified file into memory, whatever it holds
+	inline void unmap() { this->m_mapping.unmap(); }
+
+	bool recognize(); // Determines if mapped file opens as archive does
+	bool validate(); // Determines if mapped file is archive of this version whose sections are whole and unaltered
+
+	static void write(std::vector<char> &p_buffer_ref, const Archive::Contents &p_contents_ref); // Lays out sections, filling in counts and checksum of header
+
+	static void writeBlock(Block &p_block_ref, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr);
+	static bool readBlock(const Block &p_block_ref, Set *p_set_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr); // Sets pieces onto emptied hands and board, unless placements are inconsistent
+
+	static std::uint32_t checksum(const char *p_first, const char *p_last, std::uint32_t p_hash = 2166136261u); // FNV-1a, carrying on from specified hash
+
+private:
+	static inline std::size_t align(std::size_t p_size) { return ((p_size + 3) & ~static_cast<std::size_t>(3)); }
+
+	// Member variables
+	// ----------------
+	Mapping m_mapping;
+
+	// Offsets of sections
+	std::size_t m_block = 0;
+	std::size_t m_exchanges = 0;
+	std::size_t m_origin = 0;
+	std::size_t m_entries = 0;
+	std::size_t m_repetitions = 0;
+};
+
+#endif // ARCHIVE_H
@@ -22,7 +22,10 @@
 
 #include "Game/Hand.h"
 #include "Game/MRE.h"
-#include "World/Animation.h"
+#include "Game/Observer.h"
+
+#include <bitset>
+#include <cstdint>
 
 #define MAX_HEIGHT 3
 #define INITIAL_ARRANGEMENT 46
@@ -41,27 +44,38 @@ struct Selection
 	bool settable[BOARD_COLS][BOARD_ROWS];
 };
 
+// Droppable squares of single piece in hand, as bits indexed by x + y * BOARD_COLS
+struct Drops
+{
+	game::Piece *piece_ptr;
+	std::bitset<BOARD_COLS * BOARD_ROWS> squares;
+};
+
 struct Exchange
 {
 	game::Square *square_ptr;
 	int turn;
 };
 
+class Precomputer;
+
 class Board
 {
+	friend class Precomputer;
+
 public:
 	// Class functions
 	// ---------------
 	// Constructor
-	Board(int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr);
+	Board(int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Context *p_context_ptr);
 
 	// Copy constructor
 	Board(const Board &p_board_ref);
+	Board(const Board &p_board_ref, Context *p_context_ptr); // Copies onto specified context, for thread searching away from that of original
 
 	// Member functions
 	// ----------------
 	inline std::vector<Exchange>& getExchangesRef() { return this->m_exchanges; }
-	inline std::vector<Animation>* getAnimationsPtr() { return &this->m_animations; }
 
 	inline bool& getBlackCheckRef() { return this->m_black_check; }
 	inline bool& getWhiteCheckRef() { return this->m_white_check; }
@@ -75,6 +89,11 @@ public:
 
 	inline bool& getAnimateRef() { return this->m_animate; }
 
+	inline Context* getContextPtr() { return this->m_context_ptr; }
+
+	inline void setObserverPtr(Observer *p_observer_ptr) { this->m_observer_ptr = p_observer_ptr; } // Observer is notified of changes while animate is set
+	inline void setPrecomputerPtr(Precomputer *p_precomputer_ptr) { this->m_precomputer_ptr = p_precomputer_ptr; } // Legal actions are determined in background by precomputer while set
+
 	inline std::vector<game::Piece*>& getStackRef(int x, int y) { return this->m_piece_ptrs[x][y]; }
 	inline std::vector<game::Piece*>& getStackRef(game::Square *p_square_ptr) { return this->m_piece_ptrs[p_square_ptr->getX()][p_square_ptr->getY()]; }
 
@@ -89,13 +108,15 @@ public:
 	inline int getHeight(int x, int y) { return this->m_piece_ptrs[x][y].size(); }
 	inline int getHeight(game::Square *p_square_ptr) { return this->m_piece_ptrs[p_square_ptr->getX()][p_square_ptr->getY()].size(); }
 
-	inline bool checkmate(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr) { return (this->checkmate(p_turn, p_active_hand_ptr, p_passive_hand_ptr, false) && this->checkmate(p_turn, p_active_hand_ptr, p_passive_hand_ptr, true)); }
-
 	void init();
 	void build(Set &p_set_ref); // Sets squares in their relative positions
 
 	void clear();
 
+	void precompute(); // Determines legal actions of current position in background
+	void cancel(); // Stops determining legal actions, as position is about to change
+	void poll(); // Adopts legal actions once determined, for display of any awaiting them
+
 	game::Piece* getMREPiecePtr(int x, int y); // Returns pointer to MRE imparting piece in tower at specified coordinates
 
 	game::Square* getSelSquarePtr(); // Returns pointer to currently selected square
@@ -110,7 +131,7 @@ public:
 	void insertPiecePtr(game::Piece *p_piece_ptr, int x, int y, int z); // Inserts specified piece in stack at specified coordinates at specified index
 	void insertPiecePtr(game::Piece *p_piece_ptr, game::Square *p_square_ptr, int z); // Inserts specified piece in stack at specified square at specified index
 
-	void flipPiecePtr(int x, int y, int z);
+	void flipPiecePtr(int x, int y, int z); // Turns over piece at specified coordinates by exchanging it for its counterpart
 	void flipPiecePtr(game::Square *p_square_ptr, int z);
 
 	void removePiecePtr(int x, int y, int z);
@@ -127,7 +148,9 @@ public:
 	void clearActions();
 	void clearExchanges(int p_turn);
 
-	std::vector<Move> getMoves(int x, int y); // Returns set of all in bound moves of topmost piece at specified coordinates
+	inline std::vector<Move> getMoves(int x, int y) { std::vector<Move> moves; this->getMoves(x, y, moves); return moves; } // Returns set of all in bound moves of topmost piece at specified coordinates
+
+	void getMoves(int x, int y, std::vector<Move> &p_moves_ref); // Appends all in bound moves of topmost piece at specified coordinates to specified list
 
 	void setPlaceable(); // Sets color of all squares current piece can place into
 	void setDroppable(); // Sets color of all squares current piece can drop into
@@ -168,8 +191,9 @@ public:
 	void recoverSim(int x, int y, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr);
 	void recoverSim(game::Piece::Color p_color, int x, Hand *p_hand_ptr);
 
-	void switchHandsSim(Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr);
+	void switchHandsSim(game::Piece *p_piece_ptr, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Returns specified captured piece to hand of its owner
 	void handleRecoverySim(int x, int y, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr);
+	void standSim(game::Piece *p_piece_ptr, int x, int y, Hand *p_active_hand_ptr); // Recovers striking piece, leaving struck piece imparting MRE in its place
 
 	bool rearrangeableLat(int x1, int y1, int x2, int y2, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr);
 	bool rearrangeableVert(int x, int y, int z1, int z2, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr);
@@ -179,6 +203,10 @@ public:
 	bool placeable(game::Piece *p_piece_ptr, int x, int y); // Determines if placing specified piece at specified coordinates is valid
 	bool droppable(game::Piece *p_piece_ptr, int x, int y, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Determines if dropping specified piece at specified coordinates is valid
 
+	std::vector<Drops> getDrops(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Determines droppable squares of each piece in active hand in a single pass
+
+	bool blocked(int x1, int y1, int x2, int y2); // Determines if path between specified coordinates is obstructed
+
 	bool moveable(int x1, int y1, int x2, int y2); // Determines if move between specified coordinates is possible
 	bool moveable(int x1, int y1, int x2, int y2, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Determines if moving between specified coordinates is valid
 
@@ -192,7 +220,14 @@ public:
 
 	bool check(game::Piece::Color p_color); // Determines if specified color is in check
 
+	bool checkmate(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Determines if active color on specified turn is checkmated, remembering result by position
+	bool hasAction(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, bool p_deferred); // Determines if active color on specified turn has any legal action, trying cheapest first
+
+	std::uint64_t getHash(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Returns hash of position as far as legality of actions on specified turn is concerned
+
 private:
+	inline std::uint64_t scramble(std::uint64_t p_hash, std::uint64_t p_value) { p_hash = (p_hash ^ p_value) * 0xBF58476D1CE4E5B9; return p_hash ^ (p_hash >> 31); } // Mixes value into hash
+
 	inline Hand* getHandPtr(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? this->m_white_hand_ptr : this->m_black_hand_ptr); }
 
 	inline game::Piece::Color getActiveColor(int p_turn) { return (p_turn % 2 ? game::Piece::BLACK : game::Piece::WHITE); }
@@ -201,6 +236,8 @@ private:
 	inline int getLowerBound(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? LOWER_BOUND : BLACK_TERRITORY); }
 	inline int getUpperBound(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? WHITE_TERRITORY : UPPER_BOUND); }
 	
+	bool adopt(); // Merges published legal actions into caches if they are of current position
+
 	void setMoveable(int x, int y, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Sets color of all squares in range of topmost piece at specified coordinates
 	void setMRERange(int x, int y); // Sets color of all squares in range of MRE imparting piece in tower at specified coordinates
 
@@ -241,12 +278,11 @@ private:
 	bool recoverable(int x, int y); // Determines if topmost piece at specified coordinates is immoveable
 	bool recoverable(game::Piece::Color p_color, int x, int y); // Determines if topmost piece at specified coordinates is immoveable as a result of MRE of specified color being removed
 
-	bool checkmate(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, bool p_deferred); // Determines if active color on specified turn is checkmated
+	bool getDrops(std::vector<Drops> &p_drops_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, bool p_any); // Determines droppable squares of specified pieces, stopping at first found if that is all that is needed
 
 	bool dropLeavesInCheck(game::Piece *p_piece_ptr, int x, int y); // Determines if dropping specified piece at specified coordinates leaves in check
 	bool dropCheckmates(game::Piece *p_piece_ptr, int x, int y, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr); // Determines if dropping specified piece at specified coordinates attains checkmate
 
-	bool blocked(int x1, int y1, int x2, int y2);
 	bool MREBlocked(game::Piece::Color p_alignment, int x, int y); // Determines if topmost piece at specified coordinates is not aligned and is within own MRE
 
 	bool territoryFull(game::Piece::Color p_color);
@@ -262,13 +298,9 @@ private:
 	int openings(game::Piece::Color p_color, int x); // Calculates number of occupiable spaces in specified file within specified color's territory
 	int fullTowers(game::Piece::Color p_color, int x); // Calculates number of fully occupied towers in specified file within specified color's territory
 
-	glm::vec3 getWorldCoords(game::Square *p_square_ptr, int z);
-
-	void addAnimation(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, game::Square *p_mid_square_ptr, int z1, int z2, int z3);
-	void addAnimation(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, int z1, int z2);
-	void addAnimation(game::Square *p_square_ptr, int z);
-
-	void endAnimation(game::Piece *p_piece_ptr);
+	void notify(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, game::Square *p_mid_square_ptr, int z1, int z2, int z3);
+	void notify(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, int z1, int z2);
+	void notify(game::Square *p_square_ptr, int z);
 
 	// Member variables
 	// ----------------
@@ -278,8 +310,10 @@ private:
 
 	std::vector<Selection> m_selections;
 	std::vector<Exchange> m_exchanges;
-	std::vector<Animation> m_animations;
-	std::vector<game::Piece> m_temp_pieces;
+
+	// Legal actions determined in background
+	bool m_adopted = true;
+	bool m_rearranging = false; // Rearrangement squares await publication
 
 	MRE m_MRE;
 
@@ -291,6 +325,11 @@ private:
 
 	bool m_animate;
 
+	Observer *m_observer_ptr;
+	Precomputer *m_precomputer_ptr;
+
+	Context *m_context_ptr; // Counted into and remembered within by board and its copies
+
 	// Game state references
 	int *m_turn_ptr;
 
@@ -0,0 +1,51 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Context.h
+ * 
+ * Summary:	Counters, memo and random engine that rules engine and search
+ *		draw upon, owned by session or by single search thread
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Boards and hands reach context through pointer carried over to their copies,
+ * so that simulations count into and remember within context of position they
+ * were copied from
+ * 
+ * Context is only ever touched by one thread at a time, so it needs no
+ * synchronization; threads searching away from session copy position onto
+ * context of their own first
+ */
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "Game/Piece.h"
+#include "Game/Stats.h"
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#define MATE_MEMO_SIZE 65536 // Checkmate determinations remembered by each context, as power of two
+
+struct Context
+{
+	Counters counters;
+
+	std::vector<std::pair<std::uint64_t, bool>> mates; // Checkmate determinations by position hash, sized upon first use
+	std::vector<Move> targets; // Moves of single piece while determining check, whose capacity is kept between calls
+
+	std::default_random_engine RNG; // Random engine of playouts, seeded from session as each search begins
+};
+
+#endif // CONTEXT_H
@@ -0,0 +1,118 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Explorer.h
+ * 
+ * Summary:	Looks up actions played from positions in an index of games,
+ *		which is mapped into memory and searched in place
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Sections follow one another in order
+ *	Header			Magic, version, and counts of games, positions, and actions
+ *	Stats			Statistics of actions, grouped by position in order of hash
+ *	Keys			Hash of each position along with its first statistic, and one more key closing last group
+ * 
+ * Positions are hashed as far as legality of actions is concerned, and
+ * results and scores are of player performing action
+ * 
+ * Values are in byte order of machine that wrote them, which is checked by
+ * order mark of header
+ */
+
+#ifndef EXPLORER_H
+#define EXPLORER_H
+
+#include "Game/Mapping.h"
+#include "Game/State.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define EXPLORER_VERSION 1
+#define EXPLORER_ORDER 0x0102
+
+static const char EXPLORER_MAGIC[] = { 'G', '3', 'D', 'X', };
+
+class Explorer
+{
+public:
+	struct Header
+	{
+		char magic[4];
+
+		std::uint16_t version;
+		std::uint16_t order;
+
+		std::uint64_t games;
+		std::uint64_t positions;
+		std::uint64_t stats;
+	};
+
+	// Statistics of action played from position
+	struct Stat
+	{
+		Player::Word word;
+
+		std::uint32_t games;
+
+		std::uint32_t wins;
+		std::uint32_t draws;
+		std::uint32_t losses; // Games left unfinished count toward none of results
+
+		std::uint32_t padding;
+
+		std::int64_t score; // Sum of material evaluations of positions reached
+	};
+
+	struct Key
+	{
+		std::uint64_t hash;
+		std::uint64_t first; // Index of first statistic of position
+	};
+
+	// Statistic along with position it belongs to, as collected from games before they are indexed
+	struct Record
+	{
+		std::uint64_t hash;
+		Stat stat;
+	};
+
+	// Member functions
+	// ----------------
+	inline const Header* getHeaderPtr() { return reinterpret_cast<const Header*>(this->m_mapping.getData()); }
+	inline const Stat* getStatsPtr() { return reinterpret_cast<const Stat*>(this->m_mapping.getData() + sizeof(Header)); }
+	inline const Key* getKeysPtr() { return reinterpret_cast<const Key*>(this->m_mapping.getData() + sizeof(Header) + this->getHeaderPtr()->stats * sizeof(Stat)); }
+
+	inline bool mapped() { return (this->m_mapping.getData() != nullptr); }
+
+	bool map(const std::string &p_path_ref); // Maps specified index into memory, unless it is not one of this version
+	void unmap();
+
+	std::size_t find(std::uint64_t p_hash, const Stat *&p_stats_ref); // Returns number of actions played from position of specified hash, pointing to first of them
+
+	static bool collect(State *p_state_ptr, std::vector<Record> &p_records_ref); // Appends records of game loaded into state, replaying it from its origin
+
+	static inline bool precedes(const Record &p_lhs_ref, const Record &p_rhs_ref) { return (p_lhs_ref.hash < p_rhs_ref.hash || (p_lhs_ref.hash == p_rhs_ref.hash && p_lhs_ref.stat.word < p_rhs_ref.stat.word)); } // Orders records by position, then action
+	static inline bool matches(const Record &p_lhs_ref, const Record &p_rhs_ref) { return (p_lhs_ref.hash == p_rhs_ref.hash && p_lhs_ref.stat.word == p_rhs_ref.stat.word); } // Determines if records are of same action from same position
+
+	static void combine(Stat &p_dest_ref, const Stat &p_src_ref); // Adds statistics of same action together
+	static std::size_t reduce(std::vector<Record> &p_records_ref); // Sorts records, combining those of same action from same position, and returns number left
+
+private:
+	// Member variables
+	// ----------------
+	Mapping m_mapping;
+};
+
+#endif // EXPLORER_H
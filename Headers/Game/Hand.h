@@ -19,6 +19,7 @@
 #ifndef HAND_H
 #define HAND_H
 
+#include "Game/Context.h"
 #include "Game/Set.h"
 #include "Game/Square.h"
 
@@ -30,7 +31,11 @@ public:
 	// Class functions
 	// ---------------
 	// Constructor
-	Hand(game::Piece::Color p_color, game::Square::Location p_location, int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp);
+	Hand(game::Piece::Color p_color, game::Square::Location p_location, int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp, Context *p_context_ptr);
+
+	// Copy constructor
+	Hand(const Hand &p_hand_ref);
+	Hand(const Hand &p_hand_ref, Context *p_context_ptr); // Copies onto specified context, for thread searching away from that of original
 	
 	// Member functions
 	// ----------------
@@ -55,6 +60,10 @@ public:
 	inline void remove(int x, int y) { this->m_piece_ptrs[x][y].pop_back(); } // Removes topmost piece at specified coordinates
 	inline void remove(game::Square *p_square_ptr) { this->m_piece_ptrs[p_square_ptr->getX()][p_square_ptr->getY()].pop_back(); } // Removes topmost piece at specified square
 
+	inline game::Piece::Color getColor() { return this->m_color; }
+
+	inline Context* getContextPtr() { return this->m_context_ptr; }
+
 	inline bool accessible(int p_turn) { return (this->m_color == (p_turn % 2 ? game::Piece::BLACK : game::Piece::WHITE)); }
 
 	void init(Set &p_set_ref); // Sets pieces in their initial positions
@@ -95,6 +104,8 @@ private:
 
 	game::Piece **m_curr_piece_pp;
 	game::Square **m_curr_square_pp;
+
+	Context *m_context_ptr;
 };
 
 #endif // HAND_H
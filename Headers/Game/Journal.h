@@ -0,0 +1,104 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Journal.h
+ * 
+ * Summary:	Appends each action of game in progress to file as fixed size
+ *		record from background thread, so that game survives crashes
+ *		without being saved in full after every action
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Journal opens with checkpoint record, naming by checksum archive of game
+ * kept alongside it, followed by action records in order of turn
+ * 
+ * Checkpoints are written out in full before journal is started over from
+ * them, so that whichever file is found complete after crash leads to game
+ * as it last stood
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include "Game/Archive.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define JOURNAL_CHECKPOINT 0x4B434A47 // Kind of checkpoint records
+#define JOURNAL_ACTION 0x41434A47 // Kind of action records
+
+#define JOURNAL_CHECKPOINT_INTERVAL 64 // Actions appended before game is checkpointed and journal compacted
+#define JOURNAL_SYNC_INTERVAL 200 // Milliseconds records are gathered before being synced together
+
+static const std::string JOURNAL_CHECKPOINT_SUFFIX = ".checkpoint";
+
+class Journal
+{
+public:
+	struct Record
+	{
+		std::uint32_t kind;
+		std::int32_t turn; // Turn action was performed on
+		std::uint32_t value; // Packed action, or checksum of checkpoint
+		std::uint32_t checksum; // Of fields above
+	};
+
+	// Class functions
+	// ---------------
+	// Destructor
+	~Journal();
+
+	// Member functions
+	// ----------------
+	inline bool due() { return (this->m_actions >= JOURNAL_CHECKPOINT_INTERVAL); } // Enough actions have been appended since last checkpoint
+
+	bool open(const std::string &p_path_ref); // Begins writing in background, journal being started over at first checkpoint
+	void close(); // Writes out pending records before writing ends
+
+	void append(const Player::Move &p_move_ref, int p_turn);
+	void checkpoint(std::vector<char> &p_archive_ref); // Takes over archive of game as it stands, superseding records pending before it
+
+	static bool read(const std::string &p_path_ref, std::vector<Record> &p_records_ref); // Reads records up to first torn or altered one
+
+private:
+	void work(); // Writes records and checkpoints as they arrive
+
+	bool compact(const std::vector<char> &p_archive_ref); // Writes out checkpoint, then starts journal over from it
+	bool write(const std::vector<Record> &p_records_ref);
+
+	static Record make(std::uint32_t p_kind, int p_turn, std::uint32_t p_value);
+
+	// Member variables
+	// ----------------
+	std::string m_path;
+
+	int m_descriptor = -1; // Journal open for appending, owned by writing thread
+	int m_actions = 0; // Appended since last checkpoint
+
+	// Guarded by mutex
+	std::vector<Record> m_pending;
+	std::vector<char> m_archive;
+
+	bool m_checkpoint = false;
+	bool m_stop = false;
+
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+
+	std::thread m_thread;
+};
+
+#endif // JOURNAL_H
@@ -0,0 +1,146 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	MCTS.h
+ * 
+ * Summary:	Handles the game's AI by Monte Carlo tree search as an alternative
+ *		to the full width minimax search performed by the player
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef MCTS_H
+#define MCTS_H
+
+#include "Game/Player.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <deque>
+#include <mutex>
+
+#define MCTS_TIME_UNIT 1000 // Milliseconds of search allotted per level
+#define MCTS_MAX_NODES 2000000 // Nodes are no longer expanded beyond this size, unless otherwise bounded
+
+#define MCTS_UCT 1.4f // Exploration constant for UCT
+#define MCTS_PUCT 2.5f // Exploration constant for PUCT
+#define MCTS_PRIOR_SCALE 400.0f // Victim weight which triples prior probability of strike
+
+#define MCTS_VIRTUAL_LOSS 3 // Losses temporarily charged to nodes being explored by other threads
+
+#define MCTS_PLAYOUT_DEPTH 16 // Plies simulated before playout is evaluated statically
+#define MCTS_PLAYOUT_TRIES 48 // Random candidates sampled before falling back to full move generation
+#define MCTS_PLAYOUT_WIDTH 4 // Legal candidates compared by light heuristic
+#define MCTS_PLAYOUT_NOISE 150 // Random weight added to candidates so that quiet moves are not starved
+
+#define MCTS_EVAL_SCALE 800.0f // Material advantage corresponding to roughly three in four expected result
+#define MCTS_RESOLUTION 1000 // Fixed point scale of accumulated results
+
+class MCTS
+{
+public:
+	enum Policy { UCT, PUCT, };
+	enum Parallelism { ROOT, TREE, };
+
+	// Class functions
+	// ---------------
+	// Constructor
+	MCTS();
+
+	// Member functions
+	// ----------------
+	inline Policy getPolicy() { return this->m_policy; }
+	inline Parallelism getParallelism() { return this->m_parallelism; }
+
+	inline int getThreads() { return this->m_threads; }
+	inline int getBudget() { return this->m_budget; }
+
+	inline Counters getCounters() { std::lock_guard<std::mutex> lock(this->m_mutex); return this->m_counters; } // Counts of search threads during last search
+
+	inline void setPolicy(Policy p_policy) { this->m_policy = p_policy; }
+	inline void setParallelism(Parallelism p_parallelism) { this->m_parallelism = p_parallelism; }
+
+	inline void setThreads(int p_threads) { this->m_threads = (p_threads > 0 ? p_threads : 1); }
+	inline void setBudget(int p_budget) { this->m_budget = p_budget; } // Milliseconds per move, or zero for time allotted by level
+
+	inline void setMaxNodes(int p_nodes) { this->m_max_nodes = (p_nodes > 0 ? p_nodes : MCTS_MAX_NODES); } // Nodes beyond which trees are no longer expanded, or zero for default
+
+	void init(); // Discards all trees
+
+	bool search(Player *p_player_ptr, int p_level, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, Player::Move &p_move_ref); // Determines most visited move within time allotted by specified level
+
+private:
+	struct Node
+	{
+		Player::Move move;
+		float prior = 1.0f;
+
+		std::vector<Node> children; // Written once upon expansion
+
+		std::atomic<int> visits { 0 };
+		std::atomic<int> score { 0 }; // Accumulated results for player who made move
+		std::atomic<int> virtual_loss { 0 };
+
+		std::atomic<bool> expanded { false };
+		std::mutex mutex; // Guards expansion
+	};
+
+	struct Tree
+	{
+		Node root;
+		std::vector<std::pair<std::vector<int>, Node*>> successors; // Keys of positions anticipated after next opposing move and nodes representing them
+	};
+
+	typedef std::chrono::steady_clock::time_point Deadline;
+
+	void reset(Node &p_node_ref);
+	void adopt(Node &p_dest_ref, Node &p_src_ref); // Replaces node with one of its own descendants
+
+	void reuse(Tree &p_tree_ref, const std::vector<int> &p_key_ref, Counters &p_counters_ref); // Probes and hits are counted into specified counters
+	void anticipate(Tree &p_tree_ref, Node &p_node_ref, Player *p_player_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+
+	void work(Player *p_player_ptr, Tree *p_tree_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, Deadline p_deadline, unsigned int p_seed);
+	void iterate(Player *p_player_ptr, Node &p_root_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, std::vector<Node*> &p_path_ref);
+
+	bool expand(Player *p_player_ptr, Node &p_node_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+
+	Node* select(Node &p_node_ref);
+
+	float playout(Player *p_player_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Determines expected result for active color on specified turn
+	bool sample(Player *p_player_ptr, Player::Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Chooses playout move from randomly sampled legal candidates
+
+	int getVictimWeight(Player::Move p_move, Board *p_board_ptr);
+	int count(Node &p_node_ref);
+
+	std::vector<int> getKey(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Identifies position on specified turn, so that tree is only carried over to position it anticipated
+
+	bool equals(Player::Move p_move1, Player::Move p_move2);
+
+	// Member variables
+	// ----------------
+	std::deque<Tree> m_trees; // Single shared tree or one tree per thread depending on parallelism
+
+	std::atomic<int> m_nodes { 0 };
+
+	Policy m_policy = PUCT;
+	Parallelism m_parallelism = TREE;
+
+	int m_threads;
+	int m_budget = 0;
+	int m_max_nodes = MCTS_MAX_NODES;
+
+	Counters m_counters;
+	std::mutex m_mutex; // Guards counters
+};
+
+#endif // MCTS_H
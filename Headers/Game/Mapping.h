@@ -0,0 +1,48 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Mapping.h
+ * 
+ * Summary:	Maps files into memory for reading in place
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef MAPPING_H
+#define MAPPING_H
+
+#include <cstddef>
+#include <string>
+
+class Mapping
+{
+public:
+	// Class functions
+	// ---------------
+	// Destructor
+	~Mapping();
+
+	// Member functions
+	// ----------------
+	inline const char* getData() { return this->m_data; }
+	inline std::size_t getSize() { return this->m_size; }
+
+	bool map(const std::string &p_path_ref); // Maps specified file into memory, whatever it holds
+	void unmap();
+
+private:
+	// Member variables
+	// ----------------
+	const char *m_data = nullptr;
+	std::size_t m_size = 0;
+};
+
+#endif // MAPPING_H
@@ -0,0 +1,104 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	NNUE.h
+ * 
+ * Summary:	Evaluates positions by an efficiently updatable neural network as
+ *		an alternative to the player's material and mobility heuristics
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef NNUE_H
+#define NNUE_H
+
+#include "Game/Board.h"
+#include "Game/Hand.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#define NNUE_PATH "./Resources/Networks/Gungi.nnue"
+
+#define NNUE_MAGIC 0x554E4E47 // "GNNU" read as little endian
+#define NNUE_VERSION 1
+
+#define NNUE_FACES 20 // Number of distinct piece faces excluding blank
+#define NNUE_HAND_DEPTH 4 // Number of pieces of same face in hand distinguished by input features
+
+#define NNUE_BOARD_FEATURES (BOARD_COLS * BOARD_ROWS * MAX_HEIGHT * NNUE_FACES * 2) // Tower slot, piece face, and alignment relative to perspective
+#define NNUE_HAND_FEATURES (NNUE_FACES * NNUE_HAND_DEPTH * 2) // Piece face and count threshold for own and opposing hand
+#define NNUE_FEATURES (NNUE_BOARD_FEATURES + NNUE_HAND_FEATURES)
+
+#define NNUE_MAX_ACTIVE NUM_PIECES // Each piece activates at most one feature per perspective
+#define NNUE_MAX_ALTERED 5 // Squares single action may alter, being source, destination, rearrangement, and two recovered upon fortress being removed
+
+#define NNUE_HIDDEN 128 // Accumulator width per perspective
+#define NNUE_LAYER 32 // Width of hidden layer following accumulators
+
+#define NNUE_ACTIVATION_MAX 127 // Quantized equivalent of one after clipping
+#define NNUE_WEIGHT_SHIFT 6 // Dense layer weights are quantized by 64
+#define NNUE_EVAL_UNIT 100 // Evaluation equivalent of network output of one
+
+class NNUE
+{
+public:
+	// Input layer output for both perspectives along with hands it was computed from
+	struct Accumulator
+	{
+		alignas(32) std::int16_t values[2][NNUE_HIDDEN];
+
+		int hands[2][NNUE_FACES]; // Pieces of each face in black and white hand
+	};
+
+	// Member functions
+	// ----------------
+	inline bool loaded() { return this->m_loaded; }
+
+	bool load(const std::string &p_path_ref); // Restore network weights from binary file
+
+	void refresh(Accumulator &p_accumulator_ref, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr); // Computes accumulator from scratch
+	void update(Accumulator &p_accumulator_ref, const Accumulator &p_parent_ref, const Coords2D *p_squares_ptr, int p_count, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_parent_board_ptr, Board *p_board_ptr); // Computes accumulator from that of preceding position, which differs only at specified squares and in hands
+
+	int evaluate(const Accumulator &p_accumulator_ref, game::Piece::Color p_color); // Scores position from perspective of specified color
+
+	void writeSample(std::ostream &p_stream_ref, float p_result, game::Piece::Color p_color, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr); // Records training sample with result for specified color
+
+private:
+	inline int getPerspective(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? 1 : 0); }
+
+	int getFeatures(int *p_features_ptr, game::Piece::Color p_color, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr); // Lists active features from perspective of specified color
+	int getFeatures(int *p_features_ptr, game::Piece::Color p_color, int x, int y, Board *p_board_ptr); // Lists active features of tower at specified coordinates from perspective of specified color
+
+	void count(int *p_counts_ptr, Hand *p_hand_ptr); // Counts pieces of each face in specified hand
+
+	void addFeature(std::int16_t *p_values_ptr, int p_feature);
+	void subFeature(std::int16_t *p_values_ptr, int p_feature);
+
+	void transform(std::uint8_t *p_output_ptr, const std::int16_t *p_input_ptr); // Clips accumulator to activation range
+	int dot(const std::uint8_t *p_input_ptr, const std::int8_t *p_weights_ptr, int p_size);
+
+	// Member variables
+	// ----------------
+	std::vector<std::int16_t> m_input_biases;
+	std::vector<std::int16_t> m_input_weights; // Contiguous row of accumulator weights per feature
+
+	std::vector<std::int32_t> m_hidden_biases;
+	std::vector<std::int8_t> m_hidden_weights; // Contiguous row of weights per hidden neuron
+
+	std::int32_t m_output_bias;
+	std::vector<std::int8_t> m_output_weights;
+
+	bool m_loaded = false;
+};
+
+#endif // NNUE_H
@@ -0,0 +1,89 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Notation.h
+ * 
+ * Summary:	Writes and reads actions as compact text tokens and positions as
+ *		single lines, for driving the game from outside of the client
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Squares are written as file letter and rank number, a1 being (0, 0)
+ * 
+ * Actions
+ *	P*e5, +P*e5		Set piece of kind from hand, back side up if prefixed
+ *	e5e4			Move
+ *	e5xe4, e5xe4/a1		Strike, followed by rearrangement if any
+ *	e5-2, e5+1/a1		Strike down or up by piece of tier counted from one
+ *	e5=			Exchange
+ *	e5~			Substitute
+ * 
+ * Kinds
+ *	C Commander		A Captain/Pistol	S Samurai/Pike
+ *	Y Spy/Clandestinite	T Catapult/Lance	F Fortress/Lance
+ *	D Hidden Dragon/Dragon King			R Prodigy/Phoenix
+ *	B Bow/Arrow		P Pawn/Bronze		V Pawn/Silver
+ *	G Pawn/Gold
+ * 
+ * Positions are written as five fields separated by spaces, e.g. at outset
+ *	9/9/9/9/9/9/9/9/9 C2A2S3YTFDR2B7PVG/c2a2s3ytfdr2b7pvg b 1 -
+ * 
+ *	Ranks from ninth to first separated by slashes, each running from file
+ *	a and counting empty squares by digit, towers of several pieces being
+ *	enclosed in brackets from bottom to top, e.g. 4(Pa)3+s
+ *	Black hand and white hand separated by slash, each as counts of pieces
+ *	before them, or dash if empty
+ *	Side to move, b or w
+ *	Turn
+ *	Exchange restrictions as square and turn pairs separated by commas, e.g.
+ *	e5:48,c3:51, or dash if none
+ * 
+ * Pieces are written by kind, uppercase if black and lowercase if white, and
+ * prefixed with plus if back side is up
+ */
+
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include "Game/Player.h"
+#include "Game/Set.h"
+
+#define NOTATION_MOVE_SIZE 8 // Longest action token, e.g. e5xe4/a1
+#define NOTATION_POSITION_SIZE 1024 // Buffer size required to write position, besides room for exchanges
+
+#define NUM_KINDS 12
+
+class Notation
+{
+public:
+	// Class functions
+	// ---------------
+	static char* writeMove(char *p_first, char *p_last, const Player::Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Writes token of action about to be performed, returning end of it, or null if buffer is too small
+	static bool readMove(const char *p_first, const char *p_last, Player::Move &p_move_ref, Hand *p_active_hand_ptr); // Parses token of action of active color, leaving legality to caller
+
+	static char* writePosition(char *p_first, char *p_last, int p_turn, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr); // Writes position, returning end of it, or null if buffer is too small
+	static bool readPosition(const char *p_first, const char *p_last, int &p_turn_ref, Set *p_set_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr); // Sets pieces of written position onto emptied hands and board
+
+	static int getKind(game::Piece *p_piece_ptr); // Returns index of kind of specified piece, whichever side is up
+	static char getLetter(game::Piece *p_piece_ptr); // Returns letter of kind of specified piece, whichever side is up
+
+private:
+	static char* writeSquare(char *p_first, int x, int y);
+	static const char* readSquare(const char *p_first, const char *p_last, int &x, int &y); // Returns end of square, or null if there is none
+
+	static char* writePiece(char *p_first, game::Piece *p_piece_ptr);
+	static const char* readPiece(const char *p_first, const char *p_last, game::Piece *&p_piece_ref, Set *p_set_ptr, int p_taken[][NUM_KINDS]); // Takes next unused piece of written kind from set, returning end of it, or null if there is none
+
+	static char* writeHand(char *p_first, Hand *p_hand_ptr);
+	static const char* readHand(const char *p_first, const char *p_last, Hand *p_hand_ptr, Set *p_set_ptr, int p_taken[][NUM_KINDS]);
+};
+
+#endif // NOTATION_H
@@ -0,0 +1,45 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Observer.h
+ * 
+ * Summary:	Receives notice of pieces changing place or side on the game board
+ *		so as to allow presentation without the game logic depending on it
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef OBSERVER_H
+#define OBSERVER_H
+
+#include "Game/Piece.h"
+#include "Game/Square.h"
+
+// Notices are issued by the board while a change is underway, so they must not alter game state
+class Observer
+{
+public:
+	// Class functions
+	// ---------------
+	// Destructor
+	virtual ~Observer() {}
+
+	// Member functions
+	// ----------------
+	virtual void moved(game::Piece *p_piece_ptr, game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, game::Square *p_mid_square_ptr, int z1, int z2, int z3) = 0; // Piece travels by way of middle square before reaching end, or without turning over if there is none
+	virtual void moved(game::Piece *p_piece_ptr, game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, int z1, int z2) = 0; // Piece travels directly from source to end
+
+	virtual void flipped(game::Piece *p_piece_ptr, game::Square *p_square_ptr, int z) = 0; // Piece turns over in place
+
+	virtual void reset() = 0; // Board has been cleared, so any pending notices are void
+};
+
+#endif // OBSERVER_H
@@ -0,0 +1,72 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Perft.h
+ * 
+ * Summary:	Counts leaves of the legal move tree to a given depth, broken
+ *		down by the kind of action reaching them, for measuring and
+ *		verifying move generation
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef PERFT_H
+#define PERFT_H
+
+#include "Game/Player.h"
+
+#include <cstdint>
+
+class Perft
+{
+public:
+	struct Counts
+	{
+		std::uint64_t nodes = 0; // Leaves of move tree
+		std::uint64_t functions[NUM_FUNCTIONS] = {}; // Leaves by function of action reaching them
+		std::uint64_t rearrangements = 0; // Leaves reached by strike which rearranged
+
+		void add(const Counts &p_counts_ref);
+	};
+
+	// Counts beneath single action from root
+	struct Division
+	{
+		Player::Move move;
+		bool rearranged;
+
+		Counts counts;
+	};
+
+	// Class functions
+	// ---------------
+	// Constructor
+	Perft();
+
+	// Member functions
+	// ----------------
+	inline int getThreads() { return this->m_threads; }
+	inline void setThreads(int p_threads) { this->m_threads = (p_threads > 0 ? p_threads : 1); }
+
+	Counts count(Player *p_player_ptr, int p_depth, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Counts leaves at specified depth of position with specified turn to act
+	std::vector<Division> divide(Player *p_player_ptr, int p_depth, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Counts leaves beneath each action from root, which are split among threads
+
+private:
+	void search(Counts &p_counts_ref, Player *p_player_ptr, int p_depth, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+
+	bool rearranged(const Player::Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Determines if strike is followed by rearrangement
+
+	// Member variables
+	// ----------------
+	int m_threads;
+};
+
+#endif // PERFT_H
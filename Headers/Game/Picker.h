@@ -0,0 +1,68 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Picker.h
+ * 
+ * Summary:	Yields legal actions of a position one at a time in stages, most
+ *		likely to cause cutoffs first, so that search stopping early does
+ *		not pay for determining legality of the rest
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef PICKER_H
+#define PICKER_H
+
+#include "Game/Player.h"
+
+class Picker
+{
+public:
+	enum Stage { KILLERS, STRIKES, MOVES, DROPS, OTHERS, REARRANGEMENTS, DONE, };
+
+	// Class functions
+	// ---------------
+	// Constructor
+	Picker(Player *p_player_ptr, Player::Ply *p_ply_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+
+	// Member functions
+	// ----------------
+	inline Stage getStage() { return this->m_stage; }
+
+	bool next(Player::Move &p_move_ref); // Yields next legal action, determining its legality only once pulled
+
+private:
+	void generate(); // Lists candidates of current stage, which may yet prove illegal
+
+	bool legal(Player::Word p_word, const Player::Move &p_move_ref); // Determines if candidate of current stage is legal, setting aside strikes followed by rearrangement
+	bool valid(const Player::Move &p_move_ref); // Determines if killer move from another position is legal in this one
+
+	bool yielded(Player::Word p_word); // Determines if specified action was already yielded as killer move
+
+	// Member variables
+	// ----------------
+	Stage m_stage;
+
+	unsigned int m_index;
+
+	int m_turn;
+
+	// Position references
+	Player *m_player_ptr;
+	Player::Ply *m_ply_ptr; // Buffers of depth being searched, which hold every list of candidates
+
+	Hand *m_active_hand_ptr;
+	Hand *m_passive_hand_ptr;
+
+	Board *m_board_ptr;
+};
+
+#endif // PICKER_H
@@ -19,19 +19,14 @@
 #ifndef GAME_PIECE_H
 #define GAME_PIECE_H
 
+#include "Game/Weights.h"
+
+#include <string>
 #include <vector>
 
 #define LOWER_BOUND 0
 #define UPPER_BOUND 8
 
-// Weight values corresponding to piece front and back faces
-static const int WEIGHTS[] =
-{
-	0,
-	0, 700, 550, 450, 900, 850, 1000, 950, 750, 100, 150, 200,
-	300, 350, 800, 650, 600, 1100, 1050, 400, 50, 250, 500,
-};
-
 // String literals corresponding to face identifiers
 static const std::string FACE_STRINGS[] =
 {
@@ -63,8 +58,6 @@ public:
 
 	// Member functions
 	// ----------------
-	inline void init() { this->m_side = FRONT; }
-
 	inline int getID() { return this->m_ID; }
 
 	inline Face getFront() { return this->m_front; }
@@ -86,7 +79,7 @@ public:
 	inline std::string getSideUpString() { return FACE_STRINGS[this->getSideUp()]; }
 	inline std::string getSideDownString() { return FACE_STRINGS[this->getSideDown()]; }
 
-	inline void flip() { this->m_side = (this->m_side == BACK ? FRONT : BACK); }
+	inline Piece* getFlippedPtr() { return this->m_flipped_ptr; } // Returns pointer to same piece turned over
 
 	inline bool jumps() { return (this->getSideUp() == SPY || this->getSideUp() == BOW || this->getSideUp() == CLANDESTINITE); }
 
@@ -100,24 +93,31 @@ public:
 
 	inline bool accessible(int p_turn) { return (this->getAlignment() == (p_turn % 2 ? BLACK : WHITE)); }
 
-	void build(int p_ID, Face p_front, Face p_back, Color p_color);
+	// Pieces are never altered once built, so that positions referring to them may be copied and searched freely
+	// Turning piece over instead exchanges it for its counterpart with other side up
+	void build(int p_ID, Face p_front, Face p_back, Color p_color, Side p_side, Piece *p_flipped_ptr);
 
 	bool shallowEquals(Piece *p_piece_ptr);
 	bool equals(Piece *p_piece_ptr);
 
-	int getWeight();
+	inline int getWeight() { return WEIGHTS[this->getWeightIndex()]; }
+
+	int getWeightIndex(); // Returns index of weight corresponding to face currently up
 
-	std::vector<Move> getMoves(int x, int y, int z);
-	std::vector<Move> getGoldMoves(int x, int y);
+	inline std::vector<Move> getMoves(int x, int y, int z) { std::vector<Move> moves; this->getMoves(moves, x, y, z); return moves; }
+	inline std::vector<Move> getGoldMoves(int x, int y) { std::vector<Move> moves; this->getGoldMoves(moves, x, y); return moves; }
+
+	void getMoves(std::vector<Move> &p_moves_ref, int x, int y, int z); // Appends moves to specified list, so that callers may reuse its capacity
+	void getGoldMoves(std::vector<Move> &p_moves_ref, int x, int y);
 
 private:
 	inline void addMove(std::vector<Move> &p_moves_ref, int x, int y) { if (x >= LOWER_BOUND && x <= UPPER_BOUND && y >= LOWER_BOUND && y <= UPPER_BOUND) p_moves_ref.push_back({ x, y }); }
 
-	std::vector<Move> getDiagonalMoves(int x, int y);
-	std::vector<Move> getOrthogonalMoves(int x, int y);
+	void addDiagonalMoves(std::vector<Move> &p_moves_ref, int x, int y);
+	void addOrthogonalMoves(std::vector<Move> &p_moves_ref, int x, int y);
 
-	std::vector<Move> getExtendedDiagonalMoves(int x, int y);
-	std::vector<Move> getExtendedOrthogonalMoves(int x, int y);
+	void addExtendedDiagonalMoves(std::vector<Move> &p_moves_ref, int x, int y);
+	void addExtendedOrthogonalMoves(std::vector<Move> &p_moves_ref, int x, int y);
 
 	// Member variables
 	// ----------------
@@ -129,6 +129,8 @@ private:
 	Color m_color;
 
 	Side m_side;
+
+	Piece *m_flipped_ptr; // Same piece with other side up
 };
 
 #endif // GAME_PIECE_H
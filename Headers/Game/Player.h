@@ -22,10 +22,27 @@
 
 #include "Game/Board.h"
 #include "Game/Hand.h"
+#include "Game/NNUE.h"
+#include "Game/Stats.h"
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <random>
 
 #define HUMAN 0
 #define CHECKMATE 1000000000
 
+#define NUM_FUNCTIONS 7
+
+#define MAX_KILLERS 2 // Quiet actions kept per depth for having caused cutoffs
+
+// String literals corresponding to function identifiers
+static const std::string FUNCTION_STRINGS[] = { "Set", "Move", "Strike", "Down", "Up", "Exchange", "Substitute", };
+
+class MCTS;
+class Picker;
+
 struct Coords3D
 {
 	int x;
@@ -35,7 +52,12 @@ struct Coords3D
 
 class Player
 {
+	friend class MCTS;
+	friend class Picker;
+
 public:
+	enum Backend { MINIMAX, MONTE_CARLO, };
+	enum Evaluation { HANDCRAFTED, NEURAL, };
 	enum Function { SET, MOVE, STRIKE, DOWN, UP, EXCHANGE, SUBSTITUTE, };
 
 	struct Move
@@ -49,24 +71,78 @@ public:
 		int score;
 	};
 
+	// Action packed into single word, leaving out score
+	// Bits hold function (3), source (7), destination (7), tier (2), and rearrangement square (7), squares indexed as x + y * BOARD_COLS
+	typedef std::uint32_t Word;
+
+	// Actions listed at single depth of search, cleared but never freed so that every node at that depth reuses their capacity
+	struct Ply
+	{
+		std::vector<Word> candidates;
+
+		std::vector<Word> quiet; // Moves found while listing strikes
+		std::vector<Word> rearranging; // Strikes followed by rearrangement, which are expanded last
+
+		std::vector<Word> killers; // Quiet actions which caused cutoffs, most recent first
+		std::vector<Word> yielded; // Killer moves already yielded at current node
+
+		std::vector<Move> expansions; // Rearrangements of single strike
+		std::vector<::Move> targets; // In bound moves of single piece
+
+		NNUE::Accumulator accumulator; // Of position searched at this depth, derived from that of depth above as each action is simulated
+	};
+
 	// Class functions
 	// ---------------
 	// Constructor
-	Player(game::Piece::Color p_color, int *p_turn_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr);
+	Player(game::Piece::Color p_color, int *p_turn_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr, MCTS *p_mcts_ptr, NNUE *p_network_ptr, std::default_random_engine *p_RNG_ptr);
 	
 	// Member functions
 	// ----------------
 	inline int getLevel() { return this->m_level; }
+	inline Backend getBackend() { return this->m_backend; }
+	inline Evaluation getEvaluation() { return this->m_evaluation; }
+
+	inline void setBackend(Backend p_backend) { this->m_backend = p_backend; }
+	inline void switchBackend() { this->m_backend = (this->m_backend == MINIMAX ? MONTE_CARLO : MINIMAX); }
+
+	inline void setEvaluation(Evaluation p_evaluation) { this->m_evaluation = p_evaluation; }
+	inline void setNetworkPtr(NNUE *p_network_ptr) { this->m_network_ptr = p_network_ptr; }
+	inline void switchEvaluation() { this->m_evaluation = (this->m_evaluation == HANDCRAFTED ? NEURAL : HANDCRAFTED); }
 
 	inline bool evaluating() { return this->m_eval; }
 	inline bool ready() { return this->m_ready; }
 
 	inline bool controllable() { return (this->m_level == HUMAN); }
 
+	inline Stats* getStatsPtr() { return &this->m_stats; } // Statistics of last completed evaluation
+
+	inline std::vector<Move>& getChoicesRef() { return this->m_moves; } // Actions found best by last evaluation, among which act chooses
+
+	inline void setStopPtr(const std::atomic<bool> *p_stop_ptr) { this->m_stop_ptr = p_stop_ptr; } // Search ends early once specified flag is raised
+	inline void setMaxNodes(std::uint64_t p_nodes) { this->m_max_nodes = p_nodes; } // Nodes searched by minimax before it ends early, or zero for no limit
+
 	void init(int p_level);
 
 	void eval();
-	bool act();
+	bool act(Move &p_move_ref); // Performs one of best actions found by evaluation, passing it back
+
+	void play(Move p_move); // Performs specified action on game board and passes turn
+
+	bool legal(Move p_move, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Determines if specified action is legal for active color on specified turn, placements included
+
+	std::vector<Move> getMoves(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Lists all legal actions of active color on specified turn
+	void actSim(Move p_move, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Performs specified action on copy of game board
+
+	static Word pack(const Move &p_move_ref);
+	static Move unpack(Word p_word);
+
+	static int getMate(int p_score, int p_level); // Returns actions until checkmate if minimax at specified level scored it, negative if active color is checkmated, or zero if score is none
+
+	int evalMaterial(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+	int evalMobility(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+
+	void writeSample(std::ostream &p_stream_ref, float p_result, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Records material terms of position with result for active color on specified turn
 
 private:
 	inline Hand* getHandPtr(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? this->m_white_hand_ptr : this->m_black_hand_ptr); }
@@ -77,6 +153,11 @@ private:
 	inline int getLowerBound(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? LOWER_BOUND : BLACK_TERRITORY); }
 	inline int getUpperBound(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? WHITE_TERRITORY : UPPER_BOUND); }
 
+	inline bool neural() { return (this->m_evaluation == NEURAL && this->m_network_ptr->loaded()); } // Network is only used once successfully loaded
+
+	inline bool interrupted() { return (this->m_stop_ptr != nullptr && this->m_stop_ptr->load(std::memory_order_relaxed)); } // Stop flag has been raised
+	inline bool exhausted() { return (this->interrupted() || this->m_context.counters.nodes >= this->m_node_limit); } // Search was stopped or has used up its nodes
+
 	void place1();
 	void place2();
 	void place3();
@@ -89,14 +170,14 @@ private:
 
 	void genRearrangements(Move p_move, std::vector<Move> &p_moves_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
 
-	void actSim(Move p_move, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+	int minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, const NNUE::Accumulator *p_accumulator_ptr); // Accumulator is that of position searched, if it is evaluated by network
 
-	int minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+	void addKiller(Word p_word, int p_depth); // Keeps quiet action which caused cutoff at specified depth
 
-	int evalMaterial(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
-	int evalMobility(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+	void accumulate(NNUE::Accumulator &p_accumulator_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr); // Computes accumulator from scratch
+	void accumulate(NNUE::Accumulator &p_accumulator_ref, const NNUE::Accumulator &p_parent_ref, const Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_parent_board_ptr, Board *p_board_ptr); // Computes accumulator from that of position specified action was simulated upon
 
-	std::vector<Move> getMoves(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr);
+	int getAltered(Coords2D *p_squares_ptr, const Move &p_move_ref, int p_turn, Board *p_board_ptr); // Lists squares specified action may alter, given board preceding it
 
 	std::vector<game::Square*> getPlaceSquarePtrs(game::Piece *p_piece_ptr, int x, int y, bool p_stack);
 
@@ -113,11 +194,24 @@ private:
 	game::Piece::Color m_color;
 
 	int m_level = HUMAN;
+	Backend m_backend = MINIMAX;
+	Evaluation m_evaluation = HANDCRAFTED;
 
 	bool m_eval;
 	bool m_ready;
 
 	std::vector<Move> m_moves;
+	std::vector<Ply> m_plies; // Action buffers by depth of search, which only the searching thread touches
+
+	Stats m_stats;
+
+	Context m_context; // Counters and memo of search, which runs upon copies of position away from thread of session
+
+	// Search limits
+	const std::atomic<bool> *m_stop_ptr = nullptr;
+
+	std::uint64_t m_max_nodes = 0;
+	std::uint64_t m_node_limit = UINT64_MAX; // Count of nodes of search at which minimax ends early
 	
 	// State references
 	int *m_turn_ptr;
@@ -126,6 +220,11 @@ private:
 	Hand *m_white_hand_ptr;
 
 	Board *m_board_ptr;
+
+	MCTS *m_mcts_ptr;
+	NNUE *m_network_ptr;
+
+	std::default_random_engine *m_RNG_ptr; // Random engine of session, by which one of best actions is chosen
 };
 
 #endif // PLAYER_H
@@ -0,0 +1,73 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Precomputer.h
+ * 
+ * Summary:	Determines legal actions of position awaiting interaction on
+ *		worker thread, publishing them for board to adopt
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Worker acts upon snapshot of board and hands, which shares nothing but
+ * immutable pieces with current position, so play may continue meanwhile
+ * 
+ * Each position is numbered by generation, advanced upon cancelling, and map
+ * is only handed out if published for generation of current position
+ */
+
+#ifndef PRECOMPUTER_H
+#define PRECOMPUTER_H
+
+#include "Game/Board.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Legal actions of position awaiting interaction, as determined away from render thread
+struct ActionMap
+{
+	Action actions[BOARD_COLS][BOARD_ROWS]; // Hover color of each square, along with targets of those which may be selected
+	std::vector<Selection> selections; // Drop squares of each distinct piece in active hand
+};
+
+class Precomputer
+{
+public:
+	// Class functions
+	// ---------------
+	// Destructor
+	~Precomputer();
+
+	// Member functions
+	// ----------------
+	void start(Board &p_board_ref, Hand &p_active_hand_ref, Hand &p_passive_hand_ref, int p_turn); // Determines legal actions of snapshot of position
+	void cancel(); // Stops determining legal actions, as position is about to change
+
+	const ActionMap* getMapPtr(); // Returns pointer to legal actions of current position, or null if they are yet to be published
+
+private:
+	void compute(Board p_board, Hand p_active_hand, Hand p_passive_hand, int p_turn, int p_generation); // Determines legal actions of snapshot and publishes them unless cancelled
+
+	// Member variables
+	// ----------------
+	std::thread m_worker;
+	std::atomic<bool> m_cancel { false };
+
+	ActionMap m_map; // Written by worker alone, and no longer once its generation is published
+
+	Context m_context; // Counted into and remembered within by worker alone, while it runs
+
+	std::atomic<int> m_published { -1 }; // Generation of published map
+	int m_generation = 0; // Generation of current position, as far as legal actions are concerned
+};
+
+#endif // PRECOMPUTER_H
@@ -20,8 +20,8 @@
 #ifndef SET_H
 #define SET_H
 
-#include "Game\Piece.h"
-#include "Game\Square.h"
+#include "Game/Piece.h"
+#include "Game/Square.h"
 
 #define NUM_PIECES 46
 #define NUM_SQUARES 129
@@ -36,17 +36,19 @@ public:
 
 	// Member functions
 	// ----------------
-	inline game::Piece* getPiecePtr(int p_index) { return &this->m_pieces[p_index]; }
+	inline game::Piece* getPiecePtr(int p_index) { return &this->m_pieces[p_index]; } // Returns pointer to piece with front side up
 	inline game::Square* getSquarePtr(int p_index) { return &this->m_squares[p_index]; }
 
 	void init();
 
 private:
 	void buildPieces(game::Piece::Color p_color);
+	void buildPiece(int p_ID, game::Piece::Face p_front, game::Piece::Face p_back, game::Piece::Color p_color); // Builds piece with each side up, each referring to the other
 
 	// Member variables
 	// ----------------
 	game::Piece m_pieces[NUM_PIECES];
+	game::Piece m_flipped_pieces[NUM_PIECES]; // Same pieces with back side up
 	game::Square m_squares[NUM_SQUARES];
 };
 
@@ -19,24 +19,11 @@
 #ifndef GAME_SQUARE_H
 #define GAME_SQUARE_H
 
-#include <glm/glm.hpp>
-
 #include <string>
 
 #define HAND_COLS 4
 #define BOARD_COLS 9
 
-// RGBA values corresponding to color identifiers
-static const glm::vec4 RGBA[] =
-{
-	glm::vec4(0.0f,   0.0f,   0.0f,   0.0f), // CLEAR
-	glm::vec4(1.0f,   0.025f, 0.025f, 1.0f), // RED
-	glm::vec4(0.0f,   0.5f,   0.1f,   1.0f), // GREEN
-	glm::vec4(0.0f,   0.1f,   0.5f,   1.0f), // BLUE
-	glm::vec4(0.25f,  0.1f,   0.5f,   1.0f), // PURPLE
-	glm::vec4(0.5f,   0.5f,   0.5f,   1.0f), // GRAY
-};
-
 // String literals corresponding to color identifiers
 static const std::string COLOR_STRINGS[] = { "Clear", "Red", "Green", "Blue", "Purple", "Gray", };
 
@@ -57,7 +44,6 @@ public:
 	inline Location getLocation() { return this->m_location; }
 	inline Color getColor() { return this->m_color; }
 
-	inline glm::vec4 getRGBA() { return RGBA[this->m_color]; }
 	inline std::string getColorString() { return COLOR_STRINGS[this->m_color]; }
 
 	inline int getX() { return (this->m_ID - this->m_location) % this->getNumCols(); }
@@ -5,6 +5,9 @@
  * 
  * Summary:	Manages all of the objects that collectively act as the logical
  *		representation of the game as well as handle saving and loading
+ *		Games are saved as binary archives of the position they stand in
+ *		and the actions leading to it, or exported as text records of the
+ *		position they start from followed by a token per action
  * 
  * Origin:	N/A
  * 
@@ -20,8 +23,23 @@
 #ifndef STATE_H
 #define STATE_H
 
+#include "Game/Archive.h"
+#include "Game/Journal.h"
+#include "Game/MCTS.h"
+#include "Game/NNUE.h"
+#include "Game/Notation.h"
 #include "Game/Player.h"
 #include "Game/Position.h"
+#include "Game/Precomputer.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <istream>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
 
 #define MOUSE_BUTTON_1 0
 #define MOUSE_BUTTON_2 1
@@ -31,9 +49,54 @@
 
 #define STALEMATE 4
 
+#define RECORD_VERSION 1
+#define RECORD_TOKENS_PER_LINE 16
+
+static const std::string RECORD_HEADER = "Gungi3D Record"; // Opens first line of game records, which legacy saves never do
+
 class State
 {
 public:
+	// Action recorded along with its token, as written against position preceding it
+	struct Entry
+	{
+		Player::Move move;
+		char token[NOTATION_MOVE_SIZE + 1]; // Null terminated
+	};
+
+	// Bounds of search of active player, as driven by tools playing headlessly
+	struct Limits
+	{
+		int level; // Searched up to, and set again once search ends
+		int depth = 0; // Plies minimax deepens to at most, or zero for those of level
+		std::uint64_t nodes = 0; // Or zero for no limit
+	};
+
+	// Best action of deepest level completed
+	struct Search
+	{
+		bool found = false;
+		bool deepens = false; // Minimax deepened level by level, rather than placements or tree search being carried out once
+		bool scored = false; // Score of best action is that of completed depth
+
+		Player::Move best;
+
+		int level = 0;
+		int depth = 0;
+		int mate = 0; // Actions until checkmate if scored as one, as Player::getMate gives
+
+		std::uint64_t nodes = 0;
+	};
+
+	// Class functions
+	// ---------------
+	// Constructor
+	State() = default;
+
+	// Members refer to one another by pointer, so state is neither copied nor moved from where it is built
+	State(const State&) = delete;
+	State& operator=(const State&) = delete;
+
 	// Member functions
 	// ----------------
 	inline int getTurn() { return this->m_turn; }
@@ -50,6 +113,9 @@ public:
 
 	inline Board* getBoardPtr() { return &this->m_board; }
 
+	inline MCTS* getBlackMCTSPtr() { return &this->m_black_mcts; }
+	inline MCTS* getWhiteMCTSPtr() { return &this->m_white_mcts; }
+
 	inline Player* getBlackPlayerPtr() { return &this->m_black_player; }
 	inline Player* getWhitePlayerPtr() { return &this->m_white_player; }
 
@@ -58,19 +124,47 @@ public:
 
 	inline void setCurrSquarePtr(game::Square *p_square_ptr) { this->m_curr_square_ptr = p_square_ptr; }
 
+	inline Journal* getJournalPtr() { return this->m_journal_ptr; }
+	void setJournalPtr(Journal *p_journal_ptr); // Journal is checkpointed at once, then appended each action
+
+	inline const std::string& getOriginRef() { return this->m_origin; } // Position game is recorded from, in notation
+	inline const std::vector<Entry>& getRecordRef() { return this->m_record; } // Actions performed since
+
+	inline NNUE* getNetworkPtr() { return this->m_network_ptr; } // Network evaluating for both players, whether own or shared
+
+	inline void seed(unsigned int p_seed) { this->m_RNG.seed(p_seed); } // Seeds random engine of session, by which players choose among equally scored actions
+	int random(int p_min, int p_max); // Draws from random engine of session, uniformly within specified bounds
+
 	inline bool stalemate() { return this->m_stalemate; }
 	inline bool gameOver() { return (this->m_stalemate || this->m_board.getWhiteCheckmateRef() || this->m_board.getBlackCheckmateRef()); }
 
 	void init(int *p_settings_ptr = nullptr);
-	void build();
+	void build(NNUE *p_network_ptr = nullptr); // Shares specified network among sessions, as its weights are never changed once loaded, or loads one of its own
 
 	void mouseClick(int p_button);
 
 	void handleHandMB1();
 	bool handleAI();
 
+	void play(Player::Move p_move); // Performs specified action of active player, as if chosen through interaction
+
 	void save(const std::string &p_path_ref); // Record current game representation to file
-	void load(const std::string &p_path_ref); // Restore previously recorded game from file
+	bool load(const std::string &p_path_ref); // Restore previously recorded game from file, unless it cannot be read, being false as well if replay stops short
+
+	void archive(Archive::Contents &p_contents_ref); // Gathers sections of game as it stands, to be laid out and written out apart from state
+	static bool write(const std::string &p_path_ref, const Archive::Contents &p_contents_ref); // Lays out and writes out gathered sections, which may be done from any thread
+
+	void saveRecord(const std::string &p_path_ref); // Record actions of game as text to file, for reading and training
+
+	bool recover(const std::string &p_path_ref); // Restore game left in journal at specified path, if any
+
+	char* writePosition(char *p_first, char *p_last); // Writes current position in notation, returning end of it, or null if buffer is too small
+	bool readPosition(const char *p_first, const char *p_last); // Sets up position written in notation, discarding game so far
+
+	void suspend(); // Stops determining legal actions in background, as pieces are about to be moved or reset outside of interaction
+
+	bool search(const Limits &p_limits_ref, const std::atomic<bool> *p_stop_ptr, Search &p_search_ref, const std::function<void(const Search&)> &p_report_ref = nullptr); // Searches for best action of active player until specified flag is raised, reporting each level completed
+	std::string format(const Player::Move &p_move_ref); // Writes action of active color in current position, or ? if it cannot be written
 
 private:
 	inline Player* getPlayerPtr(game::Piece::Color p_color) { return (p_color == game::Piece::WHITE ? &this->m_white_player : &this->m_black_player); }
@@ -78,7 +172,27 @@ private:
 	inline game::Piece::Color getActiveColor(int p_turn) { return (p_turn % 2 ? game::Piece::BLACK : game::Piece::WHITE); }
 	inline game::Piece::Color getPassiveColor(int p_turn) { return (p_turn % 2 ? game::Piece::WHITE : game::Piece::BLACK); }
 
-	void updatePositions();
+	void resume(); // Determines check and checkmate of restored game, and awaits interaction as it would have
+
+	void originate(); // Records game as starting from current position
+	void snapshot(); // Keeps position preceding next action, against which it is recorded
+
+	void advance(const Player::Move &p_move_ref); // Performs specified action of active player, counting position it leads to and recording it
+	void record(const Player::Move &p_move_ref); // Records action just performed against position preceding it
+	bool determine(Player::Move &p_move_ref); // Determines action just performed through interaction from position preceding it
+
+	bool matches(Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr); // Determines if pieces are arranged as they are in game
+
+	void gather(Archive::Contents &p_contents_ref);
+	void checkpoint(); // Hands journal archive of game as it stands
+
+	bool loadArchive(Archive &p_archive_ref); // Restores game from validated archive, taking position as is, unless players or placements are malformed
+	bool loadRecord(std::istream &p_stream_ref); // Restores game by replaying actions of record, unless players or origin are malformed, being false if replay stops short
+	void loadLegacy(std::istream &p_stream_ref); // Restores game from full position dumps of saves prior to records
+
+	void updatePositions(); // Counts current position toward repetition, once past initial arrangement
+
+	void prepare(); // Determines legal actions ahead of interaction if controlled player is to act
 
 	std::string XOR(const std::string &p_line_ref); // For encryption and decryption of game files
 
@@ -92,17 +206,43 @@ private:
 
 	Set m_set; // Set of all game pieces and game squares
 
+	Context m_context; // Counters and memo of session, which its position and any copies made of it on thread of session draw upon
+
 	// Hands
-	Hand m_black_hand = Hand(game::Piece::BLACK, game::Square::BLACK_HAND, &this->m_turn, &this->m_curr_piece_ptr, &this->m_curr_square_ptr);
-	Hand m_white_hand = Hand(game::Piece::WHITE, game::Square::WHITE_HAND, &this->m_turn, &this->m_curr_piece_ptr, &this->m_curr_square_ptr);
+	Hand m_black_hand = Hand(game::Piece::BLACK, game::Square::BLACK_HAND, &this->m_turn, &this->m_curr_piece_ptr, &this->m_curr_square_ptr, &this->m_context);
+	Hand m_white_hand = Hand(game::Piece::WHITE, game::Square::WHITE_HAND, &this->m_turn, &this->m_curr_piece_ptr, &this->m_curr_square_ptr, &this->m_context);
 
 	// Board
-	Board m_board = Board(&this->m_turn, &this->m_curr_piece_ptr, &this->m_curr_square_ptr, &this->m_black_hand, &this->m_white_hand);
+	Board m_board = Board(&this->m_turn, &this->m_curr_piece_ptr, &this->m_curr_square_ptr, &this->m_black_hand, &this->m_white_hand, &this->m_context);
+	Precomputer m_precomputer; // Determines legal actions of board in background, apart from board so that copies of it carry none of its state
 	std::vector<Position> m_positions; // Set of all board positions to have occurred post initial arrangement
 
+	// Record
+	std::string m_origin; // Position game is recorded from, in notation
+	std::vector<Entry> m_record; // Actions performed since
+
+	// Position preceding next action
+	int m_prior_turn = 0;
+
+	std::optional<Hand> m_prior_black_hand;
+	std::optional<Hand> m_prior_white_hand;
+
+	std::optional<Board> m_prior_board;
+
+	Journal *m_journal_ptr = nullptr;
+
+	// Search trees
+	MCTS m_black_mcts;
+	MCTS m_white_mcts;
+
+	NNUE m_network; // Evaluation network of own, unless one is shared
+	NNUE *m_network_ptr = &this->m_network;
+
+	std::default_random_engine m_RNG; // Random engine of session, so that sessions neither share draws nor contend for them
+
 	// Players
-	Player m_black_player = Player(game::Piece::BLACK, &this->m_turn, &this->m_black_hand, &this->m_white_hand, &this->m_board);
-	Player m_white_player = Player(game::Piece::WHITE, &this->m_turn, &this->m_black_hand, &this->m_white_hand, &this->m_board);
+	Player m_black_player = Player(game::Piece::BLACK, &this->m_turn, &this->m_black_hand, &this->m_white_hand, &this->m_board, &this->m_black_mcts, &this->m_network, &this->m_RNG);
+	Player m_white_player = Player(game::Piece::WHITE, &this->m_turn, &this->m_black_hand, &this->m_white_hand, &this->m_board, &this->m_white_mcts, &this->m_network, &this->m_RNG);
 };
 
 #endif // STATE_H
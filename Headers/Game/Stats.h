@@ -0,0 +1,66 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Stats.h
+ * 
+ * Summary:	Counts work done by the rules engine and search within each
+ *		context, aggregated into statistics of a single search once it
+ *		finishes
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <cstdint>
+#include <ostream>
+
+#define STATS_CUTOFFS 8 // Cutoffs are counted by index of move causing them, the last counting all beyond
+
+struct Counters
+{
+	std::uint64_t board_copies = 0;
+	std::uint64_t hand_copies = 0;
+
+	std::uint64_t checks = 0;
+	std::uint64_t checkmates = 0;
+	std::uint64_t mates_cached = 0; // Checkmate determinations remembered from same position
+	std::uint64_t drops = 0; // Evaluations of droppable
+
+	std::uint64_t nodes = 0;
+	std::uint64_t iterations = 0; // Root moves searched by minimax, or playouts by MCTS
+
+	std::uint64_t probes = 0; // Lookups of positions among those anticipated by previous search
+	std::uint64_t hits = 0;
+
+	std::uint64_t cutoffs[STATS_CUTOFFS] = {};
+
+	int depth = 0; // Deepest ply reached
+
+	void add(const Counters &p_counters_ref);
+	Counters since(const Counters &p_counters_ref) const; // Returns counts accrued after specified snapshot of same context
+};
+
+struct Stats
+{
+	Counters counters; // Aggregated from all threads taking part in search
+
+	int turn = 0;
+	double ms = 0.0; // Time spent searching
+
+	double getBranchingFactor() const; // Effective branching factor, as root of nodes by deepest ply
+	double getIterationTime() const; // Milliseconds per iteration
+
+	void write(std::ostream &p_stream_ref) const; // Writes as single line of JSON
+};
+
+#endif // STATS_H
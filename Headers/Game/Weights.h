@@ -0,0 +1,34 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Weights.h
+ * 
+ * Summary:	Maintains the material weights used in evaluation, as generated
+ *		by the tuner in Tools/Tuner from labelled self-play positions
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#ifndef WEIGHTS_H
+#define WEIGHTS_H
+
+#define NUM_WEIGHTS 24
+#define HAND_PERCENT 50 // Portion of weight credited to pieces in hand
+
+// Weight values corresponding to piece front and back faces
+static const int WEIGHTS[] =
+{
+	0,
+	0, 700, 550, 450, 900, 850, 1000, 950, 750, 100, 150, 200,
+	300, 350, 800, 650, 600, 1100, 1050, 400, 50, 250, 500,
+};
+
+#endif // WEIGHTS_H
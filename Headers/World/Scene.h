@@ -21,6 +21,7 @@
 #define SCENE_H
 
 #include "Game/State.h"
+#include "World/Animation.h"
 #include "World/Light.h"
 #include "World/Square.h"
 #include "World/Picture.h"
@@ -28,16 +29,21 @@
 
 static const glm::vec3 SQUARE_NORMAL = glm::vec3(0.0f, 1.0f, 0.0f);
 
-class Scene
+class Scene : public Observer
 {
 public:
 	// Member functions
 	// ----------------
-	inline State* getStatePtr() { return &this->m_state; }
+	inline State* getStatePtr() { return this->m_state_ptr; }
+	inline State* getStagingPtr() { return (this->m_state_ptr == &this->m_states[0] ? &this->m_states[1] : &this->m_states[0]); } // Games are loaded into staging state in background, while current one is shown
+
 	inline Light* getLightPtr() { return &this->m_light; }
+	inline std::vector<Animation>* getAnimationsPtr() { return &this->m_animations; }
 
 	void init();
-	void build();
+	void build(unsigned int p_seed); // Seeds each state apart, sharing network of first with second
+
+	void promote(); // Shows staging state in place of current one, which is staged in turn
 
 	bool update(double p_delta_time); // Updates queued animations and determines if they all have complete
 
@@ -47,6 +53,14 @@ public:
 
 	void mousePick(glm::vec3 p_position, glm::vec3 p_direction); // Determine which square (if any) mouse cursor is over
 
+	// Board notices queue animations
+	void moved(game::Piece *p_piece_ptr, game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, game::Square *p_mid_square_ptr, int z1, int z2, int z3) override;
+	void moved(game::Piece *p_piece_ptr, game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, int z1, int z2) override;
+
+	void flipped(game::Piece *p_piece_ptr, game::Square *p_square_ptr, int z) override;
+
+	void reset() override;
+
 private:
 	void renderBoardPieces(const Shader &p_shader_ref);
 	void renderHandPieces(const Shader &p_shader_ref, game::Piece::Color p_color);
@@ -61,9 +75,16 @@ private:
 
 	bool pickSquare(glm::vec3 p_position, glm::vec3 p_direction, game::Square *p_square_ptr);
 
+	glm::vec3 getWorldCoords(game::Square *p_square_ptr, int z);
+
+	void endAnimation(game::Piece *p_piece_ptr);
+
 	// Member variables
 	// ----------------
-	State m_state; // Current representation of game
+	State m_states[2]; // Current representation of game, and staging one
+	State *m_state_ptr = &this->m_states[0];
+
+	std::vector<Animation> m_animations;
 
 	Light m_light;
 
@@ -22,6 +22,17 @@
 
 #include "Renderer/Shader.h"
 
+// RGBA values corresponding to game square color identifiers
+static const glm::vec4 RGBA[] =
+{
+	glm::vec4(0.0f,   0.0f,   0.0f,   0.0f), // CLEAR
+	glm::vec4(1.0f,   0.025f, 0.025f, 1.0f), // RED
+	glm::vec4(0.0f,   0.5f,   0.1f,   1.0f), // GREEN
+	glm::vec4(0.0f,   0.1f,   0.5f,   1.0f), // BLUE
+	glm::vec4(0.25f,  0.1f,   0.5f,   1.0f), // PURPLE
+	glm::vec4(0.5f,   0.5f,   0.5f,   1.0f), // GRAY
+};
+
 static const std::vector<float> SQUARE_VERTICES
 {
 	-0.975f,  0.0f, -0.975f,
@@ -0,0 +1,252 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Archive.cpp
+ * 
+ * Summary:	Lays out saved games as a versioned binary container, which is
+ *		mapped into memory and validated in place when loaded
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Archive.h"
+
+#include <cstring>
+
+// Member functions
+// ----------------
+// Determines if mapped file opens as archive does
+bool Archive::recognize()
+{
+	return (this->m_mapping.getSize() >= sizeof(ARCHIVE_MAGIC) && std::memcmp(this->m_mapping.getData(), ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC)) == 0);
+}
+
+// Determines if mapped file is archive of this version whose sections are whole and unaltered
+// Sections are located as they are checked, so that none is read past end of file
+bool Archive::validate()
+{
+	const char *data = this->m_mapping.getData();
+	std::size_t size = this->m_mapping.getSize();
+
+	if (!this->recognize() || size < sizeof(Header))
+		return false;
+
+	const Header *header_ptr = this->getHeaderPtr();
+
+	if (header_ptr->version != ARCHIVE_VERSION || header_ptr->order != ARCHIVE_ORDER)
+		return false;
+
+	// Counts are bounded before offsets are summed, so that sum cannot wrap around
+	if (header_ptr->exchanges > BOARD_COLS * BOARD_ROWS || header_ptr->origin > NOTATION_POSITION_SIZE * 2 || header_ptr->entries > size || header_ptr->repetitions > size)
+		return false;
+
+	if (!(header_ptr->flags & ARCHIVE_REPETITIONS) && header_ptr->repetitions != 0)
+		return false;
+
+	this->m_block = Archive::align(sizeof(Header));
+	this->m_exchanges = this->m_block + Archive::align(sizeof(Block));
+	this->m_origin = this->m_exchanges + Archive::align(header_ptr->exchanges * sizeof(Exchange));
+	this->m_entries = this->m_origin + Archive::align(header_ptr->origin);
+	this->m_repetitions = this->m_entries + Archive::align(static_cast<std::size_t>(header_ptr->entries) * sizeof(Entry));
+
+	std::size_t end = this->m_repetitions + static_cast<std::size_t>(header_ptr->repetitions) * sizeof(Repetition);
+
+	if (end != size)
+		return false;
+
+	// Header is checksummed as written, before checksum was filled in
+	Header header = *header_ptr;
+	header.checksum = 0;
+
+	std::uint32_t hash = Archive::checksum(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(Header));
+
+	return (Archive::checksum(data + sizeof(Header), data + end, hash) == header_ptr->checksum);
+}
+
+// Lays out sections, filling in counts and checksum of header
+void Archive::write(std::vector<char> &p_buffer_ref, const Archive::Contents &p_contents_ref)
+{
+	Header header = p_contents_ref.header;
+
+	const std::vector<Exchange> &exchanges_ref = p_contents_ref.exchanges;
+	const std::string &origin_ref = p_contents_ref.origin;
+	const std::vector<Entry> &entries_ref = p_contents_ref.entries;
+	const std::vector<Repetition> &repetitions_ref = p_contents_ref.repetitions;
+
+	std::memcpy(header.magic, ARCHIVE_MAGIC, sizeof(ARCHIVE_MAGIC));
+
+	header.version = ARCHIVE_VERSION;
+	header.order = ARCHIVE_ORDER;
+
+	header.exchanges = static_cast<std::uint32_t>(exchanges_ref.size());
+	header.origin = static_cast<std::uint32_t>(origin_ref.size());
+	header.entries = static_cast<std::uint32_t>(entries_ref.size());
+	header.repetitions = static_cast<std::uint32_t>(repetitions_ref.size());
+
+	if (!repetitions_ref.empty())
+		header.flags |= ARCHIVE_REPETITIONS;
+
+	std::size_t block = Archive::align(sizeof(Header));
+	std::size_t exchanges = block + Archive::align(sizeof(Block));
+	std::size_t origin = exchanges + Archive::align(exchanges_ref.size() * sizeof(Exchange));
+	std::size_t entries = origin + Archive::align(origin_ref.size());
+	std::size_t repetitions = entries + Archive::align(entries_ref.size() * sizeof(Entry));
+
+	// Padding between sections is left zeroed
+	p_buffer_ref.assign(repetitions + repetitions_ref.size() * sizeof(Repetition), 0);
+
+	char *data = p_buffer_ref.data();
+
+	std::memcpy(data + block, &p_contents_ref.block, sizeof(Block));
+	std::memcpy(data + exchanges, exchanges_ref.data(), exchanges_ref.size() * sizeof(Exchange));
+	std::memcpy(data + origin, origin_ref.data(), origin_ref.size());
+	std::memcpy(data + entries, entries_ref.data(), entries_ref.size() * sizeof(Entry));
+	std::memcpy(data + repetitions, repetitions_ref.data(), repetitions_ref.size() * sizeof(Repetition));
+
+	header.checksum = 0;
+	std::memcpy(data, &header, sizeof(Header));
+
+	header.checksum = Archive::checksum(data, data + p_buffer_ref.size());
+	std::memcpy(data, &header, sizeof(Header));
+}
+
+void Archive::writeBlock(Block &p_block_ref, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	// Pieces out of play, as before hands are filled, are left without location
+	std::memset(&p_block_ref, 0, sizeof(Block));
+
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			std::vector<game::Piece*> &stack = p_board_ptr->getStackRef(j, i);
+
+			for (unsigned int k = 0; k < stack.size(); ++k)
+				p_block_ref.placements[stack[k]->getID()] = { BOARD, static_cast<std::uint8_t>(j + i * BOARD_COLS), static_cast<std::uint8_t>(k), static_cast<std::uint8_t>(stack[k]->getSide()) };
+		}
+	}
+
+	for (int i = 0; i < HAND_ROWS; ++i)
+	{
+		for (int j = 0; j < HAND_COLS; ++j)
+		{
+			std::vector<game::Piece*> &black_stack = p_black_hand_ptr->getStackRef(j, i);
+			std::vector<game::Piece*> &white_stack = p_white_hand_ptr->getStackRef(j, i);
+
+			for (unsigned int k = 0; k < black_stack.size(); ++k)
+				p_block_ref.placements[black_stack[k]->getID()] = { BLACK_HAND, static_cast<std::uint8_t>(j + i * HAND_COLS), static_cast<std::uint8_t>(k), static_cast<std::uint8_t>(black_stack[k]->getSide()) };
+
+			for (unsigned int k = 0; k < white_stack.size(); ++k)
+				p_block_ref.placements[white_stack[k]->getID()] = { WHITE_HAND, static_cast<std::uint8_t>(j + i * HAND_COLS), static_cast<std::uint8_t>(k), static_cast<std::uint8_t>(white_stack[k]->getSide()) };
+		}
+	}
+}
+
+// Sets pieces onto emptied hands and board, unless placements are inconsistent
+// Every tier of each stack must be held by exactly one piece, with none above height allowed on board, and hands only hold pieces aligned with them
+bool Archive::readBlock(const Block &p_block_ref, Set *p_set_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	// Pieces by location, stack, and tier
+	std::uint8_t stacks[4][BOARD_COLS * BOARD_ROWS][NUM_PIECES];
+	std::memset(stacks, ARCHIVE_EMPTY, sizeof(stacks));
+
+	int heights[4][BOARD_COLS * BOARD_ROWS] = {};
+
+	for (int i = 0; i < NUM_PIECES; ++i)
+	{
+		const Placement &placement = p_block_ref.placements[i];
+
+		if (placement.location == NONE)
+			continue;
+
+		if (placement.location > WHITE_HAND || (placement.side != game::Piece::FRONT && placement.side != game::Piece::BACK))
+			return false;
+
+		if (placement.index >= (placement.location == BOARD ? BOARD_COLS * BOARD_ROWS : HAND_COLS * HAND_ROWS))
+			return false;
+
+		if (placement.tier >= (placement.location == BOARD ? MAX_HEIGHT : NUM_PIECES))
+			return false;
+
+		game::Piece *piece_ptr = p_set_ptr->getPiecePtr(i);
+
+		if (placement.side == game::Piece::BACK)
+			piece_ptr = piece_ptr->getFlippedPtr();
+
+		if (placement.location != BOARD && piece_ptr->getAlignment() != (placement.location == BLACK_HAND ? game::Piece::BLACK : game::Piece::WHITE))
+			return false;
+
+		std::uint8_t &slot = stacks[placement.location][placement.index][placement.tier];
+
+		if (slot != ARCHIVE_EMPTY)
+			return false;
+
+		slot = static_cast<std::uint8_t>(i);
+		++heights[placement.location][placement.index];
+	}
+
+	for (int i = BOARD; i <= WHITE_HAND; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS * BOARD_ROWS; ++j)
+		{
+			for (int k = 0; k < heights[i][j]; ++k)
+			{
+				if (stacks[i][j][k] == ARCHIVE_EMPTY)
+					return false;
+			}
+		}
+	}
+
+	for (int i = BOARD; i <= WHITE_HAND; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS * BOARD_ROWS; ++j)
+		{
+			for (int k = 0; k < heights[i][j]; ++k)
+			{
+				game::Piece *piece_ptr = p_set_ptr->getPiecePtr(stacks[i][j][k]);
+
+				if (p_block_ref.placements[stacks[i][j][k]].side == game::Piece::BACK)
+					piece_ptr = piece_ptr->getFlippedPtr();
+
+				switch (i)
+				{
+				case BOARD:
+					p_board_ptr->setPiecePtr(piece_ptr, j % BOARD_COLS, j / BOARD_COLS);
+					break;
+
+				case BLACK_HAND:
+					p_black_hand_ptr->getStackRef(j % HAND_COLS, j / HAND_COLS).push_back(piece_ptr);
+					break;
+
+				case WHITE_HAND:
+					p_white_hand_ptr->getStackRef(j % HAND_COLS, j / HAND_COLS).push_back(piece_ptr);
+					break;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+// FNV-1a, carrying on from specified hash
+std::uint32_t Archive::checksum(const char *p_first, const char *p_last, std::uint32_t p_hash)
+{
+	std::uint32_t hash = p_hash;
+
+	for (const char *it = p_first; it != p_last; ++it)
+	{
+		hash ^= static_cast<unsigned char>(*it);
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
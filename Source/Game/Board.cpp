@@ -18,11 +18,12 @@
  */
 
 #include "Game/Board.h"
+#include "Game/Precomputer.h"
 
 // Class functions
 // ---------------
 // Constructor
-Board::Board(int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr)
+Board::Board(int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Context *p_context_ptr)
 {
 	this->m_turn_ptr = p_turn_ptr;
 
@@ -33,10 +34,19 @@ Board::Board(int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_
 	this->m_white_hand_ptr = p_white_hand_ptr;
 
 	this->m_animate = true;
+	this->m_observer_ptr = nullptr;
+	this->m_precomputer_ptr = nullptr;
+
+	this->m_context_ptr = p_context_ptr;
 }
 
 // Copy constructor
-Board::Board(const Board &p_board_ref)
+Board::Board(const Board &p_board_ref) : Board(p_board_ref, p_board_ref.m_context_ptr)
+{
+}
+
+// Copies onto specified context, for thread searching away from that of original
+Board::Board(const Board &p_board_ref, Context *p_context_ptr)
 {
 	std::copy(&p_board_ref.m_piece_ptrs[0][0], &p_board_ref.m_piece_ptrs[0][0] + BOARD_ROWS * BOARD_COLS, &this->m_piece_ptrs[0][0]);
 	std::copy(&p_board_ref.m_square_ptrs[0][0], &p_board_ref.m_square_ptrs[0][0] + BOARD_ROWS * BOARD_COLS, &this->m_square_ptrs[0][0]);
@@ -50,6 +60,14 @@ Board::Board(const Board &p_board_ref)
 
 	this->m_black_checkmate = p_board_ref.m_black_checkmate;
 	this->m_white_checkmate = p_board_ref.m_white_checkmate;
+
+	this->m_animate = false;
+	this->m_observer_ptr = nullptr;
+	this->m_precomputer_ptr = nullptr;
+
+	this->m_context_ptr = p_context_ptr;
+
+	++this->m_context_ptr->counters.board_copies;
 }
 
 // Member functions
@@ -61,7 +79,9 @@ void Board::init()
 
 	this->m_selections.clear();
 	this->m_exchanges.clear();
-	this->m_animations.clear();
+
+	if (this->m_observer_ptr != nullptr)
+		this->m_observer_ptr->reset();
 
 	this->m_black_check = false;
 	this->m_white_check = false;
@@ -82,12 +102,47 @@ void Board::build(Set &p_set_ref)
 
 void Board::clear()
 {
+	this->cancel();
+
 	this->m_selections.clear();
 
 	this->clearActions();
 	this->clearExchanges(*this->m_turn_ptr);
 }
 
+// Determines legal actions of current position in background
+// Copies have no precomputer, so that search never determines any
+void Board::precompute()
+{
+	this->cancel();
+
+	if (this->m_precomputer_ptr == nullptr || *this->m_turn_ptr <= INITIAL_ARRANGEMENT)
+		return;
+
+	Hand *active_hand_ptr = this->getHandPtr(this->getActiveColor(*this->m_turn_ptr));
+	Hand *passive_hand_ptr = this->getHandPtr(this->getPassiveColor(*this->m_turn_ptr));
+
+	this->m_adopted = false;
+	this->m_precomputer_ptr->start(*this, *active_hand_ptr, *passive_hand_ptr, *this->m_turn_ptr);
+}
+
+// Stops determining legal actions, as position is about to change
+void Board::cancel()
+{
+	if (this->m_precomputer_ptr != nullptr)
+		this->m_precomputer_ptr->cancel();
+
+	this->m_adopted = true;
+	this->m_rearranging = false;
+}
+
+// Adopts legal actions once determined, for display of any awaiting them
+void Board::poll()
+{
+	if (this->adopt() && this->m_rearranging)
+		this->setRearrangeable();
+}
+
 // Returns pointer to MRE imparting piece in tower at specified coordinates
 game::Piece* Board::getMREPiecePtr(int x, int y)
 {
@@ -191,21 +246,15 @@ void Board::insertPiecePtr(game::Piece *p_piece_ptr, game::Square *p_square_ptr,
 	this->m_MRE.setRange(p_piece_ptr, x, y);
 }
 
+// Turns over piece at specified coordinates by exchanging it for its counterpart, leaving shared pieces unaltered
 void Board::flipPiecePtr(int x, int y, int z)
 {
-	this->m_MRE.removeRange(this->m_piece_ptrs[x][y][z]);
-	this->m_piece_ptrs[x][y][z]->flip();
-	this->m_MRE.setRange(this->m_piece_ptrs[x][y][z], x, y);
+	this->setPiecePtr(this->m_piece_ptrs[x][y][z]->getFlippedPtr(), x, y, z);
 }
 
 void Board::flipPiecePtr(game::Square *p_square_ptr, int z)
 {
-	int x = p_square_ptr->getX();
-	int y = p_square_ptr->getY();
-
-	this->m_MRE.removeRange(this->m_piece_ptrs[x][y][z]);
-	this->m_piece_ptrs[x][y][z]->flip();
-	this->m_MRE.setRange(this->m_piece_ptrs[x][y][z], x, y);
+	this->flipPiecePtr(p_square_ptr->getX(), p_square_ptr->getY(), z);
 }
 
 void Board::removePiecePtr(int x, int y, int z)
@@ -297,11 +346,9 @@ void Board::clearExchanges(int p_turn)
 	}
 }
 
-// Returns set of all in bound moves of topmost piece at specified coordinates
-std::vector<Move> Board::getMoves(int x, int y)
+// Appends all in bound moves of topmost piece at specified coordinates to specified list
+void Board::getMoves(int x, int y, std::vector<Move> &p_moves_ref)
 {
-	std::vector<Move> moves;
-
 	if (int height = this->getHeight(x, y))
 	{
 		if (height == 1 || this->m_piece_ptrs[x][y][height - 2]->getAlignment() == this->m_piece_ptrs[x][y][height - 1]->getAlignment())
@@ -317,14 +364,12 @@ std::vector<Move> Board::getMoves(int x, int y)
 			else if (!this->m_MRE.inRange(this->m_piece_ptrs[x][y][height - 1]->getAlignment(), x, y))
 				mod = 1;
 
-			moves = this->m_piece_ptrs[x][y][height - 1]->getMoves(x, y, height - mod);
+			this->m_piece_ptrs[x][y][height - 1]->getMoves(p_moves_ref, x, y, height - mod);
 		}
 
 		else
-			moves = this->m_piece_ptrs[x][y][height - 1]->getGoldMoves(x, y);
+			this->m_piece_ptrs[x][y][height - 1]->getGoldMoves(p_moves_ref, x, y);
 	}
-
-	return moves;
 }
 
 // Sets color of all squares current piece can place into
@@ -373,6 +418,8 @@ void Board::setDroppable()
 	Hand *active_hand_ptr = this->getHandPtr(this->getActiveColor(*this->m_turn_ptr));
 	Hand *passive_hand_ptr = this->getHandPtr(this->getPassiveColor(*this->m_turn_ptr));
 
+	this->adopt();
+
 	for (auto &elem : this->m_selections)
 	{
 		if (elem.piece_ptr->shallowEquals(*this->m_curr_piece_pp))
@@ -390,6 +437,9 @@ void Board::setDroppable()
 		}
 	}
 
+	std::vector<Drops> drops = { { *this->m_curr_piece_pp } };
+	this->getDrops(drops, *this->m_turn_ptr, active_hand_ptr, passive_hand_ptr, false);
+
 	Selection selection;
 	selection.piece_ptr = *this->m_curr_piece_pp;
 
@@ -397,7 +447,7 @@ void Board::setDroppable()
 	{
 		for (int j = 0; j < BOARD_COLS; ++j)
 		{
-			if (selection.settable[j][i] = this->droppable(*this->m_curr_piece_pp, j, i, *this->m_turn_ptr, active_hand_ptr, passive_hand_ptr))
+			if (selection.settable[j][i] = drops[0].squares[j + i * BOARD_COLS])
 				this->m_square_ptrs[j][i]->setColor(game::Square::BLUE);
 		}
 	}
@@ -406,6 +456,7 @@ void Board::setDroppable()
 }
 
 // Sets color of all squares previously captured MRE piece can occupy
+// Squares are colored upon being polled if they are still being determined in background
 void Board::setRearrangeable()
 {
 	game::Piece::Color active = this->getActiveColor(*this->m_turn_ptr);
@@ -413,6 +464,32 @@ void Board::setRearrangeable()
 	Hand *active_hand_ptr = this->getHandPtr(active);
 	Hand *passive_hand_ptr = this->getHandPtr(this->getPassiveColor(*this->m_turn_ptr));
 
+	this->adopt();
+
+	for (auto &elem : this->m_selections)
+	{
+		if (elem.piece_ptr->shallowEquals(*this->m_curr_piece_pp))
+		{
+			for (int i = this->getLowerBound(active); i <= this->getUpperBound(active); ++i)
+			{
+				for (int j = 0; j < BOARD_COLS; ++j)
+				{
+					if (elem.settable[j][i])
+						this->m_square_ptrs[j][i]->setColor(game::Square::BLUE);
+				}
+			}
+
+			this->m_rearranging = false;
+			return;
+		}
+	}
+
+	if (!this->m_adopted)
+	{
+		this->m_rearranging = true;
+		return;
+	}
+
 	for (int i = this->getLowerBound(active); i <= this->getUpperBound(active); ++i)
 	{
 		for (int j = 0; j < BOARD_COLS; ++j)
@@ -439,6 +516,8 @@ void Board::mouseOver()
 
 	else
 	{
+		this->adopt();
+
 		if (*this->m_curr_piece_pp == nullptr)
 		{
 			if (this->m_actions[x][y].color != game::Square::CLEAR)
@@ -564,7 +643,7 @@ void Board::mouseButton5()
 void Board::set(int x1, int y1, int x2, int y2, Hand *p_hand_ptr)
 {
 	this->setPiecePtr(p_hand_ptr->getPiecePtr(x1, y1), x2, y2);
-	this->addAnimation(p_hand_ptr->getSquarePtr(x1, y1), this->m_square_ptrs[x2][y2], p_hand_ptr->getHeight(x1, y1) - 1, this->getHeight(x2, y2) - 1);
+	this->notify(p_hand_ptr->getSquarePtr(x1, y1), this->m_square_ptrs[x2][y2], p_hand_ptr->getHeight(x1, y1) - 1, this->getHeight(x2, y2) - 1);
 	p_hand_ptr->remove(x1, y1);
 }
 
@@ -689,7 +768,7 @@ void Board::strikeUp(int x, int y, int z, Hand *p_active_hand_ptr, Hand *p_passi
 
 void Board::exchange(int x, int y, Hand *p_hand_ptr)
 {
-	this->addAnimation(this->m_square_ptrs[x][y], this->m_square_ptrs[x][y], 2, 0);
+	this->notify(this->m_square_ptrs[x][y], this->m_square_ptrs[x][y], 2, 0);
 
 	if (this->recoverable(this->m_piece_ptrs[x][y][0], x, y, true))
 	{
@@ -705,7 +784,7 @@ void Board::exchange(int x, int y, Hand *p_hand_ptr)
 	{
 		game::Piece *piece_ptr = this->m_piece_ptrs[x][y][2];
 
-		this->addAnimation(this->m_square_ptrs[x][y], this->m_square_ptrs[x][y], 0, 2);
+		this->notify(this->m_square_ptrs[x][y], this->m_square_ptrs[x][y], 0, 2);
 		this->setPiecePtr(this->m_piece_ptrs[x][y][0], x, y, 2);
 		this->setPiecePtr(piece_ptr, x, y, 0);
 	}
@@ -721,8 +800,8 @@ void Board::substitute(int x, int y)
 	{
 		int z = this->getHeight(square_ptr) - 1;
 
-		this->addAnimation(square_ptr, this->m_square_ptrs[x][y], z, 0);
-		this->addAnimation(this->m_square_ptrs[x][y], square_ptr, 0, z);
+		this->notify(square_ptr, this->m_square_ptrs[x][y], z, 0);
+		this->notify(this->m_square_ptrs[x][y], square_ptr, 0, z);
 
 		this->setPiecePtr(this->getPiecePtr(square_ptr, z), x, y, 0);
 		this->setPiecePtr(piece_ptr, square_ptr, z);
@@ -748,13 +827,12 @@ void Board::moveSim(int x1, int y1, int x2, int y2, int p_turn, Hand *p_active_h
 
 void Board::strikeSim(int x1, int y1, int x2, int y2, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
 {
-	this->m_temp_pieces.push_back(*this->getPiecePtr(x2, y2));
+	game::Piece *piece_ptr = this->getPiecePtr(x2, y2)->getFlippedPtr();
 
 	bool bronze = this->getPiecePtr(x1, y1)->getSideUp() == game::Piece::BRONZE;
 	bool fortress = this->contains(game::Piece::FORTRESS, x2, y2);
 
-	this->m_temp_pieces.back().flip();
-	p_active_hand_ptr->add(&this->m_temp_pieces.back());
+	p_active_hand_ptr->add(piece_ptr);
 
 	this->removePiecePtr(x2, y2);
 	this->setPiecePtr(this->getPiecePtr(x1, y1), x2, y2);
@@ -764,12 +842,18 @@ void Board::strikeSim(int x1, int y1, int x2, int y2, int p_turn, Hand *p_active
 
 	if (this->recoverable(x2, y2))
 	{
-		this->switchHandsSim(p_active_hand_ptr, p_passive_hand_ptr);
-		this->handleRecoverySim(x2, y2, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+		if (piece_ptr->getFlippedPtr()->impartsMRE())
+			this->standSim(piece_ptr, x2, y2, p_active_hand_ptr);
+
+		else
+		{
+			this->switchHandsSim(piece_ptr, p_active_hand_ptr, p_passive_hand_ptr);
+			this->handleRecoverySim(x2, y2, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+		}
 	}
 
-	else if (this->m_temp_pieces.back().impartsMRE() && (bronze || !this->rearrangeable(&this->m_temp_pieces.back(), p_turn, p_active_hand_ptr, p_passive_hand_ptr)))
-		this->switchHandsSim(p_active_hand_ptr, p_passive_hand_ptr);
+	else if (piece_ptr->impartsMRE() && (bronze || !this->rearrangeable(piece_ptr, p_turn, p_active_hand_ptr, p_passive_hand_ptr)))
+		this->switchHandsSim(piece_ptr, p_active_hand_ptr, p_passive_hand_ptr);
 
 	if (bronze)
 		this->betrayalSim(x2, y2, p_turn);
@@ -780,24 +864,29 @@ void Board::strikeSim(int x1, int y1, int x2, int y2, int p_turn, Hand *p_active
 
 void Board::strikeDownSim(int x, int y, int z, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
 {
-	this->m_temp_pieces.push_back(*this->getPiecePtr(x, y, z - 1));
+	game::Piece *piece_ptr = this->getPiecePtr(x, y, z - 1)->getFlippedPtr();
 
 	bool bronze = this->getPiecePtr(x, y, z)->getSideUp() == game::Piece::BRONZE;
 	bool fortress = this->contains(game::Piece::FORTRESS, x, y);
 
-	this->m_temp_pieces.back().flip();
-	p_active_hand_ptr->add(&this->m_temp_pieces.back());
+	p_active_hand_ptr->add(piece_ptr);
 
 	this->removePiecePtr(x, y, z - 1);
 
 	if (z == this->getHeight(x, y) && this->recoverable(x, y))
 	{
-		this->switchHandsSim(p_active_hand_ptr, p_passive_hand_ptr);
-		this->handleRecoverySim(x, y, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+		if (piece_ptr->getFlippedPtr()->impartsMRE())
+			this->standSim(piece_ptr, x, y, p_active_hand_ptr);
+
+		else
+		{
+			this->switchHandsSim(piece_ptr, p_active_hand_ptr, p_passive_hand_ptr);
+			this->handleRecoverySim(x, y, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+		}
 	}
 
-	else if (this->m_temp_pieces.back().impartsMRE() && (bronze || !this->rearrangeable(&this->m_temp_pieces.back(), p_turn, p_active_hand_ptr, p_passive_hand_ptr)))
-		this->switchHandsSim(p_active_hand_ptr, p_passive_hand_ptr);
+	else if (piece_ptr->impartsMRE() && (bronze || !this->rearrangeable(piece_ptr, p_turn, p_active_hand_ptr, p_passive_hand_ptr)))
+		this->switchHandsSim(piece_ptr, p_active_hand_ptr, p_passive_hand_ptr);
 
 	this->recoverSim(x, y, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
 
@@ -810,24 +899,23 @@ void Board::strikeDownSim(int x, int y, int z, int p_turn, Hand *p_active_hand_p
 
 void Board::strikeUpSim(int x, int y, int z, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
 {
-	this->m_temp_pieces.push_back(*this->getPiecePtr(x, y, z + 1));
+	game::Piece *piece_ptr = this->getPiecePtr(x, y, z + 1)->getFlippedPtr();
 
 	bool bronze = this->getPiecePtr(x, y, z)->getSideUp() == game::Piece::BRONZE;
 	bool fortress = this->contains(game::Piece::FORTRESS, x, y);
 
-	this->m_temp_pieces.back().flip();
-	p_active_hand_ptr->add(&this->m_temp_pieces.back());
+	p_active_hand_ptr->add(piece_ptr);
 
 	this->removePiecePtr(x, y, z + 1);
 
 	if (z == this->getHeight(x, y) - 1 && this->recoverable(x, y))
 	{
-		this->switchHandsSim(p_active_hand_ptr, p_passive_hand_ptr);
+		this->switchHandsSim(piece_ptr, p_active_hand_ptr, p_passive_hand_ptr);
 		this->handleRecoverySim(x, y, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
 	}
 
-	else if (this->m_temp_pieces.back().impartsMRE() && (bronze || !this->rearrangeable(&this->m_temp_pieces.back(), p_turn, p_active_hand_ptr, p_passive_hand_ptr)))
-		this->switchHandsSim(p_active_hand_ptr, p_passive_hand_ptr);
+	else if (piece_ptr->impartsMRE() && (bronze || !this->rearrangeable(piece_ptr, p_turn, p_active_hand_ptr, p_passive_hand_ptr)))
+		this->switchHandsSim(piece_ptr, p_active_hand_ptr, p_passive_hand_ptr);
 
 	this->recoverSim(x, y, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
 
@@ -882,11 +970,8 @@ void Board::betrayalSim(int x, int y, int p_turn)
 		if (this->m_piece_ptrs[x][y][i]->getSideUp() == game::Piece::LANCE && (i > 0 || (alignment == game::Piece::WHITE ? (y > WHITE_TERRITORY) : (y < BLACK_TERRITORY))))
 			continue;
 
-		this->m_temp_pieces.push_back(*this->m_piece_ptrs[x][y][i]);
-		this->m_temp_pieces.back().flip();
-
-		if (!this->contains(&this->m_temp_pieces.back(), x, y))
-			this->setPiecePtr(&this->m_temp_pieces.back(), x, y, i);
+		if (!this->contains(this->m_piece_ptrs[x][y][i]->getFlippedPtr(), x, y))
+			this->flipPiecePtr(x, y, i);
 	}
 }
 
@@ -922,11 +1007,21 @@ void Board::recoverSim(game::Piece::Color p_MRE_color, int x, Hand *p_hand_ptr)
 	}
 }
 
-void Board::switchHandsSim(Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
+// Returns specified captured piece to hand of its owner
+void Board::switchHandsSim(game::Piece *p_piece_ptr, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
 {
-	p_active_hand_ptr->remove(&this->m_temp_pieces.back());
-	this->m_temp_pieces.back().flip();
-	p_passive_hand_ptr->add(&this->m_temp_pieces.back());
+	p_active_hand_ptr->remove(p_piece_ptr);
+	p_passive_hand_ptr->add(p_piece_ptr->getFlippedPtr());
+}
+
+// Recovers striking piece from top of specified square, leaving struck piece imparting MRE standing as strike does
+void Board::standSim(game::Piece *p_piece_ptr, int x, int y, Hand *p_active_hand_ptr)
+{
+	p_active_hand_ptr->remove(p_piece_ptr);
+	p_active_hand_ptr->add(this->getPiecePtr(x, y));
+
+	this->removePiecePtr(x, y);
+	this->setPiecePtr(p_piece_ptr->getFlippedPtr(), x, y);
 }
 
 void Board::handleRecoverySim(int x, int y, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
@@ -1039,6 +1134,8 @@ bool Board::placeable(game::Piece *p_piece_ptr, int x, int y)
 // Determines if dropping specified piece at specified coordinates is valid
 bool Board::droppable(game::Piece *p_piece_ptr, int x, int y, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
 {
+	++this->m_context_ptr->counters.drops;
+
 	// Piece cannot drop into tower it cannot stack in
 	if (!this->stackable(p_piece_ptr, x, y))
 		return false;
@@ -1081,6 +1178,19 @@ bool Board::droppable(game::Piece *p_piece_ptr, int x, int y, int p_turn, Hand *
 	return true;
 }
 
+// Determines droppable squares of each piece in active hand in a single pass
+std::vector<Drops> Board::getDrops(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
+{
+	std::vector<Drops> drops;
+
+	for (auto &elem : p_active_hand_ptr->getPiecePtrs())
+		drops.push_back({ elem });
+
+	this->getDrops(drops, p_turn, p_active_hand_ptr, p_passive_hand_ptr, false);
+
+	return drops;
+}
+
 // Determines if move between specified coordinates is possible
 bool Board::moveable(int x1, int y1, int x2, int y2)
 {
@@ -1201,7 +1311,8 @@ bool Board::exchangeable(int x, int y, int p_turn, Hand *p_active_hand_ptr, Hand
 	for (auto &elem : this->m_exchanges)
 	{
 		// Exchange cannot occur multiple times consecutively at same square
-		if (elem.square_ptr == this->m_square_ptrs[x][y])
+		// Exchanges before preceding two turns have expired, though simulation does not clear them
+		if (elem.square_ptr == this->m_square_ptrs[x][y] && elem.turn >= p_turn - 2)
 			return false;
 	}
 
@@ -1327,6 +1438,8 @@ bool Board::upwards(int x, int y, int z, int p_turn, Hand *p_active_hand_ptr, Ha
 // Determines if specified color is in check
 bool Board::check(game::Piece::Color p_color)
 {
+	++this->m_context_ptr->counters.checks;
+
 	game::Square *comm_square_ptr = this->getCommSquarePtr(p_color);
 
 	if (!comm_square_ptr)
@@ -1340,6 +1453,8 @@ bool Board::check(game::Piece::Color p_color)
 	if (z > 0 && this->m_piece_ptrs[x][y][z - 1]->getAlignment() != p_color && this->m_piece_ptrs[x][y][z - 1]->getSideUp() != game::Piece::FORTRESS)
 		return true;
 
+	std::vector<Move> &targets = this->m_context_ptr->targets;
+
 	for (int i = 0; i < BOARD_ROWS; ++i)
 	{
 		for (int j = 0; j < BOARD_COLS; ++j)
@@ -1352,12 +1467,12 @@ bool Board::check(game::Piece::Color p_color)
 			if (this->m_piece_ptrs[j][i][height - 1]->getAlignment() == p_color)
 				continue;
 
-			for (auto &elem : this->getMoves(j, i))
-			{
-				if (!this->moveable(j, i, elem.x, elem.y))
-					continue;
+			targets.clear();
+			this->getMoves(j, i, targets);
 
-				if (elem.x == x && elem.y == y)
+			for (auto &elem : targets)
+			{
+				if (elem.x == x && elem.y == y && this->moveable(j, i, elem.x, elem.y))
 					return true;
 			}
 		}
@@ -1369,6 +1484,8 @@ bool Board::check(game::Piece::Color p_color)
 // Sets color of all squares in range of topmost piece at specified coordinates
 void Board::setMoveable(int x, int y, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
 {
+	this->adopt();
+
 	if (this->m_actions[x][y].selected)
 	{
 		for (int i = 0; i < BOARD_ROWS; ++i)
@@ -1396,6 +1513,34 @@ void Board::setMoveable(int x, int y, Hand *p_active_hand_ptr, Hand *p_passive_h
 	}
 }
 
+// Merges published legal actions into caches if they are of current position
+// Anything already cached was determined the same way, so it is simply overwritten
+bool Board::adopt()
+{
+	if (this->m_adopted || this->m_precomputer_ptr == nullptr)
+		return this->m_adopted;
+
+	const ActionMap *map_ptr = this->m_precomputer_ptr->getMapPtr();
+
+	if (map_ptr == nullptr)
+		return false;
+
+	std::copy(&map_ptr->actions[0][0], &map_ptr->actions[0][0] + BOARD_ROWS * BOARD_COLS, &this->m_actions[0][0]);
+
+	for (auto &elem1 : map_ptr->selections)
+	{
+		bool found = false;
+
+		for (auto &elem2 : this->m_selections)
+			found = (found || elem2.piece_ptr->shallowEquals(elem1.piece_ptr));
+
+		if (!found)
+			this->m_selections.push_back(elem1);
+	}
+
+	return (this->m_adopted = true);
+}
+
 // Sets color of all squares in range of MRE piece in tower at specified coordinates
 void Board::setMRERange(int x, int y)
 {
@@ -1537,13 +1682,10 @@ void Board::betrayal(int x, int y, int z)
 		if (this->m_piece_ptrs[x][y][i]->getSideUp() == game::Piece::LANCE && (i > 0 || (active == game::Piece::WHITE ? (y > WHITE_TERRITORY) : (y < BLACK_TERRITORY))))
 			continue;
 
-		game::Piece temp_piece = *this->m_piece_ptrs[x][y][i];
-		temp_piece.flip();
-
-		if (!this->contains(&temp_piece, x, y))
+		if (!this->contains(this->m_piece_ptrs[x][y][i]->getFlippedPtr(), x, y))
 		{
 			this->flipPiecePtr(x, y, i);
-			this->addAnimation(this->m_square_ptrs[x][y], i);
+			this->notify(this->m_square_ptrs[x][y], i);
 		}
 	}
 }
@@ -1576,7 +1718,7 @@ void Board::recover(game::Piece::Color p_color, int x)
 void Board::transferLat(int x1, int y1, int x2, int y2)
 {
 	this->setPiecePtr(this->getPiecePtr(x1, y1), x2, y2);
-	this->addAnimation(this->m_square_ptrs[x1][y1], this->m_square_ptrs[x2][y2], this->getHeight(x1, y1) - 1, this->getHeight(x2, y2) - 1);
+	this->notify(this->m_square_ptrs[x1][y1], this->m_square_ptrs[x2][y2], this->getHeight(x1, y1) - 1, this->getHeight(x2, y2) - 1);
 	this->removePiecePtr(x1, y1);
 }
 
@@ -1585,7 +1727,7 @@ void Board::transferVert(int x, int y, int z1, int z2)
 	game::Piece *piece_ptr = this->m_piece_ptrs[x][y][z2];
 	
 	this->setPiecePtr(this->m_piece_ptrs[x][y][z1], x, y, z2);
-	this->addAnimation(this->m_square_ptrs[x][y], this->m_square_ptrs[x][y], z1, z2);
+	this->notify(this->m_square_ptrs[x][y], this->m_square_ptrs[x][y], z1, z2);
 	this->setPiecePtr(piece_ptr, x, y, z2);
 }
 
@@ -1593,17 +1735,12 @@ void Board::remove(int x, int y, int z, bool p_flip, Hand *p_hand_ptr)
 {
 	if (p_flip)
 	{
-		game::Piece temp_piece = *this->m_piece_ptrs[x][y][z];
-		temp_piece.flip();
-
-		game::Square *square_ptr = p_hand_ptr->getSquarePtr(&temp_piece);
-		p_hand_ptr->add(&temp_piece, square_ptr);
-
-		this->addAnimation(this->m_square_ptrs[x][y], square_ptr, z, p_hand_ptr->getHeight(square_ptr) - 1);
-		p_hand_ptr->remove(square_ptr);
-
 		this->flipPiecePtr(x, y, z);
+
+		game::Square *square_ptr = p_hand_ptr->getSquarePtr(this->m_piece_ptrs[x][y][z]);
 		p_hand_ptr->add(this->m_piece_ptrs[x][y][z], square_ptr);
+
+		this->notify(this->m_square_ptrs[x][y], square_ptr, z, p_hand_ptr->getHeight(square_ptr) - 1);
 		this->removePiecePtr(x, y, z);
 	}
 
@@ -1612,7 +1749,7 @@ void Board::remove(int x, int y, int z, bool p_flip, Hand *p_hand_ptr)
 		game::Square *square_ptr = p_hand_ptr->getSquarePtr(this->m_piece_ptrs[x][y][z]);
 		p_hand_ptr->add(this->m_piece_ptrs[x][y][z], square_ptr);
 
-		this->addAnimation(this->m_square_ptrs[x][y], square_ptr, nullptr, z, p_hand_ptr->getHeight(square_ptr) - 1, NULL);
+		this->notify(this->m_square_ptrs[x][y], square_ptr, nullptr, z, p_hand_ptr->getHeight(square_ptr) - 1, 0);
 		this->removePiecePtr(x, y, z);
 	}
 }
@@ -1624,7 +1761,7 @@ void Board::removeLat(int x1, int y1, int x2, int y2, Hand *p_hand_ptr)
 	this->setPiecePtr(this->getPiecePtr(x1, y1), x2, y2);
 	p_hand_ptr->add(this->getPiecePtr(x1, y1), square_ptr);
 
-	this->addAnimation(this->m_square_ptrs[x1][y1], square_ptr, this->m_square_ptrs[x2][y2], this->getHeight(x1, y1) - 1, p_hand_ptr->getHeight(square_ptr) - 1, this->getHeight(x2, y2) - 1);
+	this->notify(this->m_square_ptrs[x1][y1], square_ptr, this->m_square_ptrs[x2][y2], this->getHeight(x1, y1) - 1, p_hand_ptr->getHeight(square_ptr) - 1, this->getHeight(x2, y2) - 1);
 
 	this->removePiecePtr(x1, y1);
 	this->removePiecePtr(x2, y2);
@@ -1638,7 +1775,7 @@ void Board::removeVert(int x, int y, int z1, int z2, Hand *p_hand_ptr)
 	this->setPiecePtr(this->m_piece_ptrs[x][y][z1], x, y, z2);
 	p_hand_ptr->add(this->m_piece_ptrs[x][y][z1], square_ptr);
 
-	this->addAnimation(this->m_square_ptrs[x][y], square_ptr, this->m_square_ptrs[x][y], z1, p_hand_ptr->getHeight(square_ptr) - 1, z2);
+	this->notify(this->m_square_ptrs[x][y], square_ptr, this->m_square_ptrs[x][y], z1, p_hand_ptr->getHeight(square_ptr) - 1, z2);
 
 	this->setPiecePtr(piece_ptr, x, y, z2);
 	this->removePiecePtr(x, y, z1);
@@ -1656,6 +1793,10 @@ void Board::endTurn()
 	{
 		if (*this->m_curr_piece_pp = this->getHandPtr(this->getActiveColor(*this->m_turn_ptr))->getMREPiecePtr())
 		{
+			// Drop squares of pieces in hand no longer apply after strike
+			this->m_selections.clear();
+			this->precompute();
+
 			this->clearAll();
 			this->setRearrangeable();
 			this->mouseOver();
@@ -1816,42 +1957,122 @@ bool Board::recoverable(game::Piece::Color p_color, int x, int y)
 	return true;
 }
 
-// Determines if active color on specified turn is checkmated
-bool Board::checkmate(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, bool p_deferred)
+// Determines if active color on specified turn is checkmated, remembering result by position
+// Positions recur throughout search and legality checks, which would otherwise determine them anew
+bool Board::checkmate(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
+{
+	std::vector<std::pair<std::uint64_t, bool>> &mates = this->m_context_ptr->mates;
+
+	if (mates.empty())
+		mates.resize(MATE_MEMO_SIZE);
+
+	std::uint64_t hash = this->getHash(p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+
+	// Hash of zero marks unused entry
+	if (hash == 0)
+		hash = 1;
+
+	unsigned int index = hash & (MATE_MEMO_SIZE - 1);
+
+	if (mates[index].first == hash)
+	{
+		++this->m_context_ptr->counters.mates_cached;
+		return mates[index].second;
+	}
+
+	++this->m_context_ptr->counters.checkmates;
+
+	// Deferred actions are only considered once others fail
+	bool checkmate = !this->hasAction(p_turn, p_active_hand_ptr, p_passive_hand_ptr, false) && !this->hasAction(p_turn, p_active_hand_ptr, p_passive_hand_ptr, true);
+
+	// Entry is only written now, as determining may have filled it with other positions meanwhile
+	mates[index] = { hash, checkmate };
+
+	return checkmate;
+}
+
+// Determines if active color on specified turn has any legal action, trying cheapest first
+// Deferred actions are those of pawn and bronze, whose legality rests on checkmate in turn
+// Stages are commander escapes, simple moves, drops, strikes, and then exchanges, substitutions, and strikes within towers
+bool Board::hasAction(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, bool p_deferred)
 {
+	game::Square *comm_square_ptr = (p_deferred ? nullptr : this->getCommSquarePtr(this->getActiveColor(p_turn)));
+
+	// Commander can most often escape whether in check or not, so it is tried first
+	if (comm_square_ptr && this->selectable(comm_square_ptr->getX(), comm_square_ptr->getY(), p_turn))
+	{
+		int x = comm_square_ptr->getX();
+		int y = comm_square_ptr->getY();
+
+		for (auto &elem : this->getMoves(x, y))
+		{
+			if (!this->moveable(x, y, elem.x, elem.y))
+				continue;
+
+			if (this->moveable(x, y, elem.x, elem.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+				return true;
+
+			if (this->strikeable(x, y, elem.x, elem.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+				return true;
+		}
+	}
+
+	// Moves which are not legal as simple moves are kept to be tried as strikes
+	std::vector<std::pair<Move, Move>> strikes;
+	std::vector<Move> targets;
+
 	for (int i = 0; i < BOARD_ROWS; ++i)
 	{
 		for (int j = 0; j < BOARD_COLS; ++j)
 		{
-			for (auto &elem : p_active_hand_ptr->getPiecePtrs())
+			if (comm_square_ptr && this->m_square_ptrs[j][i] == comm_square_ptr)
+				continue;
+
+			if (!this->selectable(j, i, p_turn) || ((this->getPiecePtr(j, i)->getSideUp() == game::Piece::BRONZE) != p_deferred))
+				continue;
+
+			targets.clear();
+			this->getMoves(j, i, targets);
+
+			for (auto &elem : targets)
 			{
-				if ((elem->getSideUp() == game::Piece::PAWN || elem->getSideUp() == game::Piece::BRONZE) != p_deferred)
+				if (!this->moveable(j, i, elem.x, elem.y))
 					continue;
 
-				if (this->droppable(elem, j, i, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
-					return false;
+				if (this->moveable(j, i, elem.x, elem.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+					return true;
+
+				strikes.push_back({ { j, i }, elem });
 			}
+		}
+	}
 
-			if (this->selectable(j, i, p_turn) && ((this->getPiecePtr(j, i)->getSideUp() == game::Piece::BRONZE) == p_deferred))
-			{
-				for (auto &elem : this->getMoves(j, i))
-				{
-					if (!this->moveable(j, i, elem.x, elem.y))
-						continue;
+	std::vector<Drops> drops;
+
+	for (auto &elem : p_active_hand_ptr->getPiecePtrs())
+	{
+		if ((elem->getSideUp() == game::Piece::PAWN || elem->getSideUp() == game::Piece::BRONZE) == p_deferred)
+			drops.push_back({ elem });
+	}
 
-					if (this->moveable(j, i, elem.x, elem.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
-						return false;
+	if (this->getDrops(drops, p_turn, p_active_hand_ptr, p_passive_hand_ptr, true))
+		return true;
 
-					if (this->strikeable(j, i, elem.x, elem.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
-						return false;
-				}
-			}
+	for (auto &elem : strikes)
+	{
+		if (this->strikeable(elem.first.x, elem.first.y, elem.second.x, elem.second.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+			return true;
+	}
 
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
 			if (!p_deferred && this->exchangeable(j, i, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
-				return false;
+				return true;
 
 			if (!p_deferred && this->substitutable(j, i, p_turn))
-				return false;
+				return true;
 
 			int height = this->getHeight(j, i);
 
@@ -1864,15 +2085,162 @@ bool Board::checkmate(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_
 					continue;
 
 				if (k > 0 && this->downwards(j, i, k, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
-					return false;
+					return true;
 
 				if (k < height - 1 && this->upwards(j, i, k, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
-					return false;
+					return true;
 			}
 		}
 	}
 
-	return true;
+	return false;
+}
+
+// Returns hash of position as far as legality of actions on specified turn is concerned
+// Pieces are told apart by both faces, as betrayal reveals face beneath
+std::uint64_t Board::getHash(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr)
+{
+	std::uint64_t hash = this->scramble(0, p_turn % 2);
+
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			for (unsigned int k = 0; k < this->m_piece_ptrs[j][i].size(); ++k)
+			{
+				game::Piece *piece_ptr = this->m_piece_ptrs[j][i][k];
+				hash = this->scramble(hash, (((j + i * BOARD_COLS) * MAX_HEIGHT + k) << 16) | (piece_ptr->getFront() << 8) | (piece_ptr->getBack() << 3) | ((piece_ptr->getColor() == game::Piece::WHITE) << 1) | (piece_ptr->getSide() == game::Piece::BACK));
+			}
+		}
+	}
+
+	Hand *hand_ptrs[] = { p_active_hand_ptr, p_passive_hand_ptr };
+
+	for (int h = 0; h < 2; ++h)
+	{
+		for (int i = 0; i < HAND_ROWS; ++i)
+		{
+			for (int j = 0; j < HAND_COLS; ++j)
+			{
+				std::vector<game::Piece*> &stack_ref = hand_ptrs[h]->getStackRef(j, i);
+
+				if (stack_ref.empty())
+					continue;
+
+				game::Piece *piece_ptr = stack_ref.back();
+				hash = this->scramble(hash, (static_cast<std::uint64_t>(h + 1) << 40) | (stack_ref.size() << 16) | (piece_ptr->getFront() << 8) | (piece_ptr->getBack() << 3) | ((piece_ptr->getColor() == game::Piece::WHITE) << 1) | (piece_ptr->getSide() == game::Piece::BACK));
+			}
+		}
+	}
+
+	// Exchanges only matter until they expire
+	for (auto &elem : this->m_exchanges)
+	{
+		if (elem.turn >= p_turn - 2)
+			hash = this->scramble(hash, (static_cast<std::uint64_t>(3) << 40) | ((elem.square_ptr->getX() + elem.square_ptr->getY() * BOARD_COLS) << 8) | (p_turn - elem.turn));
+	}
+
+	return hash;
+}
+
+// Determines droppable squares of specified pieces, stopping at first found if that is all that is needed
+// Agrees with droppable for every piece and square, but work depending on only one of them is done once
+bool Board::getDrops(std::vector<Drops> &p_drops_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, bool p_any)
+{
+	// Work common to all squares for single piece
+	struct Candidate
+	{
+		bool check; // Dropping only ever obstructs, so drop can only leave in check if already in check
+		bool recovers; // Drop can only be forced to recover within last two rows of its alignment
+		bool pawn; // Pawn and bronze cannot drop into file containing them, nor attain checkmate by dropping
+
+		bool filed[BOARD_COLS];
+	};
+
+	std::vector<Candidate> candidates(p_drops_ref.size());
+
+	int checks[2] = { -1, -1 };
+
+	for (unsigned int i = 0; i < p_drops_ref.size(); ++i)
+	{
+		game::Piece *piece_ptr = p_drops_ref[i].piece_ptr;
+		Candidate &candidate = candidates[i];
+
+		int &color_check = checks[piece_ptr->getAlignment() == game::Piece::WHITE];
+
+		if (color_check < 0)
+			color_check = this->check(piece_ptr->getAlignment());
+
+		candidate.check = color_check;
+		candidate.recovers = piece_ptr->recovers();
+		candidate.pawn = (piece_ptr->getSideUp() == game::Piece::PAWN || piece_ptr->getSideUp() == game::Piece::BRONZE);
+
+		for (int j = 0; j < BOARD_COLS; ++j)
+			candidate.filed[j] = (candidate.pawn && this->contains(piece_ptr, j));
+	}
+
+	bool found = false;
+
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			int height = this->getHeight(j, i);
+
+			// Tower cannot exceed maximum height
+			if (height == MAX_HEIGHT)
+				continue;
+
+			game::Piece *top_ptr = (height ? this->m_piece_ptrs[j][i][height - 1] : nullptr);
+
+			// Cannot stack atop commander
+			if (top_ptr && top_ptr->getSideUp() == game::Piece::COMMANDER)
+				continue;
+
+			for (unsigned int k = 0; k < p_drops_ref.size(); ++k)
+			{
+				++this->m_context_ptr->counters.drops;
+
+				game::Piece *piece_ptr = p_drops_ref[k].piece_ptr;
+				Candidate &candidate = candidates[k];
+
+				if (candidate.filed[j])
+					continue;
+
+				if (this->contains(piece_ptr, j, i))
+					continue;
+
+				if (top_ptr)
+				{
+					if (piece_ptr->impartsMRE())
+						continue;
+
+					if (top_ptr->getAlignment() != piece_ptr->getAlignment() || !top_ptr->links())
+						continue;
+
+					if (top_ptr->getSideUp() == (piece_ptr->getSide() == game::Piece::BACK ? game::Piece::CLANDESTINITE : game::Piece::SPY))
+						continue;
+				}
+
+				if (candidate.recovers && (piece_ptr->getAlignment() == game::Piece::WHITE ? i >= UPPER_BOUND - 1 : i <= LOWER_BOUND + 1) && this->recoverable(piece_ptr, j, i, false))
+					continue;
+
+				if (candidate.check && this->dropLeavesInCheck(piece_ptr, j, i))
+					continue;
+
+				if (candidate.pawn && this->dropCheckmates(piece_ptr, j, i, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+					continue;
+
+				p_drops_ref[k].squares.set(j + i * BOARD_COLS);
+				found = true;
+
+				if (p_any)
+					return true;
+			}
+		}
+	}
+
+	return found;
 }
 
 // Determines if dropping specified piece at specified coordinates leaves in check
@@ -2130,98 +2498,29 @@ int Board::fullTowers(game::Piece::Color p_color, int x)
 	return count;
 }
 
-glm::vec3 Board::getWorldCoords(game::Square *p_square_ptr, int z)
-{
-	if (p_square_ptr == nullptr)
-		return SKIP_ROTATION;
-	
-	glm::vec3 coords;
-
-	int x = p_square_ptr->getX();
-	int y = p_square_ptr->getY();
-
-	switch (p_square_ptr->getLocation())
-	{
-	case game::Square::BLACK_HAND:
-		coords.x = 1.85f + 0.2f * (static_cast<float>(x) - 4.0f);
-		coords.y = -0.09f + 0.015f * static_cast<float>(z);
-		coords.z = 0.6f + 0.2f * (static_cast<float>(y) - 4.0f);
-
-		break;
-
-	case game::Square::WHITE_HAND:
-		coords.x = -1.85f - 0.2f * (static_cast<float>(x) - 4.0f);
-		coords.y = -0.09f + 0.015f * static_cast<float>(z);
-		coords.z = -0.6f - 0.2f * (static_cast<float>(y) - 4.0f);
-
-		break;
-
-	case game::Square::BOARD:
-		float y_off = 0.0f;
-
-		for (int i = 1; i <= z; ++i)
-			y_off += (this->getPiecePtr(x, y, i)->getSide() != this->getPiecePtr(x, y, i - 1)->getSide() ? 0.02f : 0.015f);
-
-		coords.x = 0.0f + 0.2f * (static_cast<float>(x) - 4.0f);
-		coords.y = 0.01f + y_off;
-		coords.z = 0.0f + 0.2f * (static_cast<float>(y) - 4.0f);
-
-		break;
-	}
-
-	return coords;
-}
-
-void Board::addAnimation(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, game::Square *p_mid_square_ptr, int z1, int z2, int z3)
+void Board::notify(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, game::Square *p_mid_square_ptr, int z1, int z2, int z3)
 {
-	if (!this->m_animate)
+	if (!this->m_animate || this->m_observer_ptr == nullptr)
 		return;
 
-	game::Piece *piece_ptr = this->getPiecePtr(p_src_square_ptr, z1);
-
-	glm::vec3 src_coords = this->getWorldCoords(p_src_square_ptr, z1);
-	glm::vec3 end_coords = this->getWorldCoords(p_end_square_ptr, z2);
-	glm::vec3 mid_coords = this->getWorldCoords(p_mid_square_ptr, z3);
-
-	this->endAnimation(piece_ptr);
-	this->m_animations.push_back({ piece_ptr, src_coords, end_coords, mid_coords });
+	this->m_observer_ptr->moved(this->getPiecePtr(p_src_square_ptr, z1), p_src_square_ptr, p_end_square_ptr, p_mid_square_ptr, z1, z2, z3);
 }
 
-void Board::addAnimation(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, int z1, int z2)
+void Board::notify(game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, int z1, int z2)
 {
-	if (!this->m_animate)
+	if (!this->m_animate || this->m_observer_ptr == nullptr)
 		return;
 
 	Hand *hand_ptr = this->getHandPtr(this->getActiveColor(*this->m_turn_ptr));
 	game::Piece *piece_ptr = (p_src_square_ptr->getLocation() == game::Square::BOARD ? this->getPiecePtr(p_src_square_ptr, z1) : hand_ptr->getPiecePtr(p_src_square_ptr, z1));
 
-	glm::vec3 src_coords = this->getWorldCoords(p_src_square_ptr, z1);
-	glm::vec3 end_coords = this->getWorldCoords(p_end_square_ptr, z2);
-
-	this->endAnimation(piece_ptr);
-	this->m_animations.push_back({ piece_ptr, src_coords, end_coords });
+	this->m_observer_ptr->moved(piece_ptr, p_src_square_ptr, p_end_square_ptr, z1, z2);
 }
 
-void Board::addAnimation(game::Square *p_square_ptr, int z)
+void Board::notify(game::Square *p_square_ptr, int z)
 {
-	if (!this->m_animate)
+	if (!this->m_animate || this->m_observer_ptr == nullptr)
 		return;
 
-	game::Piece *piece_ptr = this->getPiecePtr(p_square_ptr, z);
-	glm::vec3 coords = this->getWorldCoords(p_square_ptr, z);
-
-	this->endAnimation(piece_ptr);
-	this->m_animations.push_back({ piece_ptr, coords });
-}
-
-void Board::endAnimation(game::Piece *p_piece_ptr)
-{
-	for (auto i = this->m_animations.begin(); i != this->m_animations.end();)
-	{
-		if (this->m_animations[i - this->m_animations.begin()].getPiecePtr() == p_piece_ptr)
-			i = this->m_animations.erase(i);
-
-		else
-			++i;
-	}
+	this->m_observer_ptr->flipped(this->getPiecePtr(p_square_ptr, z), p_square_ptr, z);
 }
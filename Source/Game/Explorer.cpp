@@ -0,0 +1,168 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Explorer.cpp
+ * 
+ * Summary:	Looks up actions played from positions in an index of games,
+ *		which is mapped into memory and searched in place
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Explorer.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Member functions
+// ----------------
+// Maps specified index into memory, unless it is not one of this version
+// Sections are checked to fill file exactly, whereas keys are checked as they are looked up, so that mapping takes no longer for larger indexes
+bool Explorer::map(const std::string &p_path_ref)
+{
+	if (!this->m_mapping.map(p_path_ref))
+		return false;
+
+	std::size_t size = this->m_mapping.getSize();
+	const Header *header_ptr = this->getHeaderPtr();
+
+	bool valid = (size >= sizeof(Header) && std::memcmp(header_ptr->magic, EXPLORER_MAGIC, sizeof(EXPLORER_MAGIC)) == 0);
+
+	// Counts are bounded before sizes are summed, so that sum cannot wrap around
+	valid = valid && header_ptr->version == EXPLORER_VERSION && header_ptr->order == EXPLORER_ORDER;
+	valid = valid && header_ptr->stats <= size / sizeof(Stat) && header_ptr->positions < size / sizeof(Key);
+	valid = valid && sizeof(Header) + header_ptr->stats * sizeof(Stat) + (header_ptr->positions + 1) * sizeof(Key) == size;
+	valid = valid && this->getKeysPtr()[header_ptr->positions].first == header_ptr->stats;
+
+	if (!valid)
+		this->m_mapping.unmap();
+
+	return valid;
+}
+
+void Explorer::unmap()
+{
+	this->m_mapping.unmap();
+}
+
+// Returns number of actions played from position of specified hash, pointing to first of them
+std::size_t Explorer::find(std::uint64_t p_hash, const Stat *&p_stats_ref)
+{
+	if (!this->mapped())
+		return 0;
+
+	const Header *header_ptr = this->getHeaderPtr();
+
+	const Key *first = this->getKeysPtr();
+	const Key *last = first + header_ptr->positions;
+
+	const Key *key_ptr = std::lower_bound(first, last, p_hash, [](const Key &p_key_ref, std::uint64_t p_hash) { return p_key_ref.hash < p_hash; });
+
+	if (key_ptr == last || key_ptr->hash != p_hash)
+		return 0;
+
+	// Key closing group lies past it, so that bounds of every group are known
+	if (key_ptr->first > key_ptr[1].first || key_ptr[1].first > header_ptr->stats)
+		return 0;
+
+	p_stats_ref = this->getStatsPtr() + key_ptr->first;
+
+	return static_cast<std::size_t>(key_ptr[1].first - key_ptr->first);
+}
+
+// Appends records of game loaded into state, replaying it from its origin
+// Result is that game was left with, and score is material evaluation of each position reached, both for player performing action
+bool Explorer::collect(State *p_state_ptr, std::vector<Record> &p_records_ref)
+{
+	Board *board_ptr = p_state_ptr->getBoardPtr();
+
+	bool black_won = board_ptr->getWhiteCheckmateRef();
+	bool white_won = board_ptr->getBlackCheckmateRef();
+	bool drawn = p_state_ptr->stalemate();
+
+	// Record is replaced as game is set back to its origin
+	std::string origin = p_state_ptr->getOriginRef();
+	std::vector<State::Entry> entries = p_state_ptr->getRecordRef();
+
+	if (!p_state_ptr->readPosition(origin.data(), origin.data() + origin.size()))
+		return false;
+
+	p_state_ptr->suspend();
+
+	for (const auto &elem : entries)
+	{
+		int turn = p_state_ptr->getTurn();
+
+		Player *player_ptr = p_state_ptr->getActivePlayerPtr();
+
+		Hand *active_hand_ptr = p_state_ptr->getHandPtr(turn % 2 ? game::Piece::BLACK : game::Piece::WHITE);
+		Hand *passive_hand_ptr = p_state_ptr->getHandPtr(turn % 2 ? game::Piece::WHITE : game::Piece::BLACK);
+
+		// Loaded records were replayed legally already, but archives are taken as is
+		if (!player_ptr->legal(elem.move, turn, active_hand_ptr, passive_hand_ptr, board_ptr))
+			return false;
+
+		Record record = {};
+
+		record.hash = board_ptr->getHash(turn, active_hand_ptr, passive_hand_ptr);
+
+		record.stat.word = Player::pack(elem.move);
+		record.stat.games = 1;
+
+		bool won = (turn % 2 ? black_won : white_won);
+		bool lost = (turn % 2 ? white_won : black_won);
+
+		record.stat.wins = won;
+		record.stat.draws = drawn;
+		record.stat.losses = lost;
+
+		player_ptr->play(elem.move);
+
+		record.stat.score = player_ptr->evalMaterial(turn, active_hand_ptr, passive_hand_ptr, board_ptr);
+
+		p_records_ref.push_back(record);
+	}
+
+	return true;
+}
+
+// Adds statistics of same action together
+void Explorer::combine(Stat &p_dest_ref, const Stat &p_src_ref)
+{
+	p_dest_ref.games += p_src_ref.games;
+
+	p_dest_ref.wins += p_src_ref.wins;
+	p_dest_ref.draws += p_src_ref.draws;
+	p_dest_ref.losses += p_src_ref.losses;
+
+	p_dest_ref.score += p_src_ref.score;
+}
+
+// Sorts records, combining those of same action from same position, and returns number left
+std::size_t Explorer::reduce(std::vector<Record> &p_records_ref)
+{
+	std::sort(p_records_ref.begin(), p_records_ref.end(), Explorer::precedes);
+
+	std::size_t size = 0;
+
+	for (std::size_t i = 0; i < p_records_ref.size(); ++i)
+	{
+		if (size > 0 && Explorer::matches(p_records_ref[size - 1], p_records_ref[i]))
+			Explorer::combine(p_records_ref[size - 1].stat, p_records_ref[i].stat);
+
+		else
+			p_records_ref[size++] = p_records_ref[i];
+	}
+
+	p_records_ref.resize(size);
+
+	return size;
+}
@@ -18,10 +18,12 @@
 
 #include "Game/Hand.h"
 
+#include <algorithm>
+
 // Class functions
 // ---------------
 // Constructor
-Hand::Hand(game::Piece::Color p_color, game::Square::Location p_location, int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp)
+Hand::Hand(game::Piece::Color p_color, game::Square::Location p_location, int *p_turn_ptr, game::Piece **p_piece_pp, game::Square **p_square_pp, Context *p_context_ptr)
 {
 	this->m_color = p_color;
 	this->m_location = p_location;
@@ -30,6 +32,32 @@ Hand::Hand(game::Piece::Color p_color, game::Square::Location p_location, int *p
 
 	this->m_curr_piece_pp = p_piece_pp;
 	this->m_curr_square_pp = p_square_pp;
+
+	this->m_context_ptr = p_context_ptr;
+}
+
+// Copy constructor
+Hand::Hand(const Hand &p_hand_ref) : Hand(p_hand_ref, p_hand_ref.m_context_ptr)
+{
+}
+
+// Copies onto specified context, for thread searching away from that of original
+Hand::Hand(const Hand &p_hand_ref, Context *p_context_ptr)
+{
+	std::copy(&p_hand_ref.m_piece_ptrs[0][0], &p_hand_ref.m_piece_ptrs[0][0] + HAND_ROWS * HAND_COLS, &this->m_piece_ptrs[0][0]);
+	std::copy(&p_hand_ref.m_square_ptrs[0][0], &p_hand_ref.m_square_ptrs[0][0] + HAND_ROWS * HAND_COLS, &this->m_square_ptrs[0][0]);
+
+	this->m_color = p_hand_ref.m_color;
+	this->m_location = p_hand_ref.m_location;
+
+	this->m_turn_ptr = p_hand_ref.m_turn_ptr;
+
+	this->m_curr_piece_pp = p_hand_ref.m_curr_piece_pp;
+	this->m_curr_square_pp = p_hand_ref.m_curr_square_pp;
+
+	this->m_context_ptr = p_context_ptr;
+
+	++this->m_context_ptr->counters.hand_copies;
 }
 
 // Member functions
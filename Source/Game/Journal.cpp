@@ -0,0 +1,331 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Journal.cpp
+ * 
+ * Summary:	Appends each action of game in progress to file as fixed size
+ *		record from background thread, so that game survives crashes
+ *		without being saved in full after every action
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Journal.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Function prototypes
+// -------------------
+static int openFile(const std::string &p_path_ref, bool p_append);
+static bool writeFile(int p_descriptor, const char *p_data, std::size_t p_size);
+static bool syncFile(int p_descriptor);
+static void closeFile(int p_descriptor);
+
+static bool replaceFile(const std::string &p_src_path_ref, const std::string &p_dest_path_ref); // Renames over destination, durably where possible
+static bool writeDurably(const std::string &p_path_ref, const char *p_data, std::size_t p_size); // Writes whole file beside path, then renames it into place
+
+// Class functions
+// ---------------
+// Destructor
+Journal::~Journal()
+{
+	this->close();
+}
+
+// Member functions
+// ----------------
+// Begins writing in background, journal being started over at first checkpoint
+bool Journal::open(const std::string &p_path_ref)
+{
+	this->close();
+
+	this->m_path = p_path_ref;
+
+	this->m_pending.clear();
+	this->m_archive.clear();
+
+	this->m_checkpoint = false;
+	this->m_stop = false;
+
+	this->m_actions = 0;
+
+	this->m_thread = std::thread(&Journal::work, this);
+
+	return true;
+}
+
+// Writes out pending records before writing ends
+void Journal::close()
+{
+	if (!this->m_thread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		this->m_stop = true;
+	}
+
+	this->m_condition.notify_one();
+	this->m_thread.join();
+
+	if (this->m_descriptor >= 0)
+	{
+		closeFile(this->m_descriptor);
+		this->m_descriptor = -1;
+	}
+}
+
+void Journal::append(const Player::Move &p_move_ref, int p_turn)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		this->m_pending.push_back(Journal::make(JOURNAL_ACTION, p_turn, Player::pack(p_move_ref)));
+	}
+
+	++this->m_actions;
+
+	this->m_condition.notify_one();
+}
+
+// Takes over archive of game as it stands, superseding records pending before it
+void Journal::checkpoint(std::vector<char> &p_archive_ref)
+{
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+
+		this->m_archive.swap(p_archive_ref);
+		this->m_pending.clear();
+
+		this->m_checkpoint = true;
+	}
+
+	this->m_actions = 0;
+
+	this->m_condition.notify_one();
+}
+
+// Writes records and checkpoints as they arrive
+// Records arriving shortly after one another are gathered, so that they are synced together
+void Journal::work()
+{
+	std::unique_lock<std::mutex> lock(this->m_mutex);
+
+	while (true)
+	{
+		this->m_condition.wait(lock, [this] { return (this->m_stop || this->m_checkpoint || !this->m_pending.empty()); });
+		this->m_condition.wait_for(lock, std::chrono::milliseconds(JOURNAL_SYNC_INTERVAL), [this] { return this->m_stop; });
+
+		std::vector<Record> records;
+		records.swap(this->m_pending);
+
+		std::vector<char> archive;
+		bool checkpoint = this->m_checkpoint;
+
+		if (checkpoint)
+			archive.swap(this->m_archive);
+
+		this->m_checkpoint = false;
+
+		bool stop = this->m_stop;
+
+		lock.unlock();
+
+		if (checkpoint && !this->compact(archive))
+			std::cerr << "ERROR::JOURNAL::CHECKPOINT_FAILED >> " << this->m_path << std::endl;
+
+		if (!records.empty() && !this->write(records))
+			std::cerr << "ERROR::JOURNAL::WRITE_FAILED >> " << this->m_path << std::endl;
+
+		lock.lock();
+
+		if (stop && !this->m_checkpoint && this->m_pending.empty())
+			break;
+	}
+}
+
+// Writes out checkpoint, then starts journal over from it
+// Journal left behind by crash in between opens with checkpoint other than one found, so it is passed over on recovery
+bool Journal::compact(const std::vector<char> &p_archive_ref)
+{
+	if (p_archive_ref.size() < sizeof(Archive::Header))
+		return false;
+
+	if (this->m_descriptor >= 0)
+	{
+		closeFile(this->m_descriptor);
+		this->m_descriptor = -1;
+	}
+
+	if (!writeDurably(this->m_path + JOURNAL_CHECKPOINT_SUFFIX, p_archive_ref.data(), p_archive_ref.size()))
+		return false;
+
+	const Archive::Header *header_ptr = reinterpret_cast<const Archive::Header*>(p_archive_ref.data());
+	Record record = Journal::make(JOURNAL_CHECKPOINT, header_ptr->turn, header_ptr->checksum);
+
+	if (!writeDurably(this->m_path, reinterpret_cast<const char*>(&record), sizeof(Record)))
+		return false;
+
+	this->m_descriptor = openFile(this->m_path, true);
+
+	return (this->m_descriptor >= 0);
+}
+
+bool Journal::write(const std::vector<Record> &p_records_ref)
+{
+	// Journal is only started at checkpoint, so records preceding any are dropped
+	if (this->m_descriptor < 0)
+		return false;
+
+	if (!writeFile(this->m_descriptor, reinterpret_cast<const char*>(p_records_ref.data()), p_records_ref.size() * sizeof(Record)))
+		return false;
+
+	return syncFile(this->m_descriptor);
+}
+
+// Reads records up to first torn or altered one
+bool Journal::read(const std::string &p_path_ref, std::vector<Record> &p_records_ref)
+{
+	p_records_ref.clear();
+
+	std::ifstream file(p_path_ref, std::ios_base::in | std::ios_base::binary);
+
+	if (!file.is_open())
+		return false;
+
+	Record record;
+
+	while (file.read(reinterpret_cast<char*>(&record), sizeof(Record)))
+	{
+		if (Archive::checksum(reinterpret_cast<const char*>(&record), reinterpret_cast<const char*>(&record.checksum)) != record.checksum)
+			break;
+
+		if (record.kind != JOURNAL_CHECKPOINT && record.kind != JOURNAL_ACTION)
+			break;
+
+		p_records_ref.push_back(record);
+	}
+
+	return true;
+}
+
+// Record is value initialized, so that bytes it is checksummed over are all determined
+Journal::Record Journal::make(std::uint32_t p_kind, int p_turn, std::uint32_t p_value)
+{
+	Record record = {};
+
+	record.kind = p_kind;
+	record.turn = p_turn;
+	record.value = p_value;
+	record.checksum = Archive::checksum(reinterpret_cast<const char*>(&record), reinterpret_cast<const char*>(&record.checksum));
+
+	return record;
+}
+
+// Functions
+// ---------
+static int openFile(const std::string &p_path_ref, bool p_append)
+{
+#ifdef _WIN32
+	return _open(p_path_ref.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (p_append ? _O_APPEND : _O_TRUNC), _S_IREAD | _S_IWRITE);
+#else
+	return ::open(p_path_ref.c_str(), O_WRONLY | O_CREAT | (p_append ? O_APPEND : O_TRUNC), 0644);
+#endif
+}
+
+static bool writeFile(int p_descriptor, const char *p_data, std::size_t p_size)
+{
+	while (p_size > 0)
+	{
+#ifdef _WIN32
+		int written = _write(p_descriptor, p_data, static_cast<unsigned int>(p_size));
+#else
+		ssize_t written = ::write(p_descriptor, p_data, p_size);
+#endif
+
+		if (written <= 0)
+			return false;
+
+		p_data += written;
+		p_size -= static_cast<std::size_t>(written);
+	}
+
+	return true;
+}
+
+static bool syncFile(int p_descriptor)
+{
+#ifdef _WIN32
+	return (_commit(p_descriptor) == 0);
+#else
+	return (fsync(p_descriptor) == 0);
+#endif
+}
+
+static void closeFile(int p_descriptor)
+{
+#ifdef _WIN32
+	_close(p_descriptor);
+#else
+	::close(p_descriptor);
+#endif
+}
+
+// Renames over destination, durably where possible
+static bool replaceFile(const std::string &p_src_path_ref, const std::string &p_dest_path_ref)
+{
+#ifdef _WIN32
+	return (MoveFileExA(p_src_path_ref.c_str(), p_dest_path_ref.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+#else
+	if (std::rename(p_src_path_ref.c_str(), p_dest_path_ref.c_str()) != 0)
+		return false;
+
+	// Rename itself is only durable once directory holding it is synced
+	std::size_t pos = p_dest_path_ref.find_last_of('/');
+	int descriptor = ::open(pos == std::string::npos ? "." : p_dest_path_ref.substr(0, pos + 1).c_str(), O_RDONLY);
+
+	if (descriptor >= 0)
+	{
+		fsync(descriptor);
+		::close(descriptor);
+	}
+
+	return true;
+#endif
+}
+
+// Writes whole file beside path, then renames it into place
+static bool writeDurably(const std::string &p_path_ref, const char *p_data, std::size_t p_size)
+{
+	std::string temp_path = p_path_ref + ".tmp";
+
+	int descriptor = openFile(temp_path, false);
+
+	if (descriptor < 0)
+		return false;
+
+	bool written = (writeFile(descriptor, p_data, p_size) && syncFile(descriptor));
+	closeFile(descriptor);
+
+	return (written && replaceFile(temp_path, p_path_ref));
+}
@@ -0,0 +1,612 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	MCTS.cpp
+ * 
+ * Summary:	Handles the game's AI by Monte Carlo tree search as an alternative
+ *		to the full width minimax search performed by the player
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/MCTS.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <thread>
+
+static int draw(std::default_random_engine &p_RNG_ref, int p_min, int p_max); // Draws from specified random engine, uniformly within specified bounds
+
+// Class functions
+// ---------------
+// Constructor
+MCTS::MCTS()
+{
+	this->setThreads(std::thread::hardware_concurrency());
+}
+
+// Member functions
+// ----------------
+// Discards all trees
+void MCTS::init()
+{
+	this->m_trees.clear();
+	this->m_nodes = 0;
+}
+
+// Determines most visited move within time allotted by specified level
+bool MCTS::search(Player *p_player_ptr, int p_level, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, Player::Move &p_move_ref)
+{
+	Deadline deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(this->m_budget > 0 ? this->m_budget : p_level * MCTS_TIME_UNIT);
+
+	// Random engine of searching context is seeded from session, so that sessions searching at once draw neither from nor after one another
+	Context *context_ptr = p_board_ptr->getContextPtr();
+	context_ptr->RNG.seed((*p_player_ptr->m_RNG_ptr)());
+
+	int num_trees = (this->m_parallelism == ROOT ? this->m_threads : 1);
+
+	while (static_cast<int>(this->m_trees.size()) < num_trees)
+		this->m_trees.emplace_back();
+
+	while (static_cast<int>(this->m_trees.size()) > num_trees)
+		this->m_trees.pop_back();
+
+	// Only first tree is carried over between turns
+	this->reuse(this->m_trees[0], this->getKey(p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr), context_ptr->counters);
+
+	for (unsigned int i = 1; i < this->m_trees.size(); ++i)
+		this->reset(this->m_trees[i].root);
+
+	this->m_nodes = 0;
+
+	{
+		std::lock_guard<std::mutex> lock(this->m_mutex);
+		this->m_counters = Counters();
+	}
+
+	for (auto &elem : this->m_trees)
+		this->m_nodes += this->count(elem.root);
+
+	// Root is expanded up front so that trivial decisions need no search
+	Node &root = this->m_trees[0].root;
+	this->expand(p_player_ptr, root, p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr);
+
+	if (root.children.empty())
+		return false;
+
+	if (root.children.size() > 1)
+	{
+		std::vector<std::thread> threads;
+
+		for (int i = 0; i < this->m_threads; ++i)
+		{
+			Tree *tree_ptr = &this->m_trees[this->m_parallelism == ROOT ? i : 0];
+			threads.push_back(std::thread(&MCTS::work, this, p_player_ptr, tree_ptr, p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr, deadline, static_cast<unsigned int>(context_ptr->RNG())));
+		}
+
+		for (auto &elem : threads)
+			elem.join();
+	}
+
+	// Visits of equivalent moves are summed across trees
+	Node *best_ptr = nullptr;
+	int best = -1;
+
+	for (auto &elem1 : root.children)
+	{
+		int visits = elem1.visits;
+
+		for (unsigned int i = 1; i < this->m_trees.size(); ++i)
+		{
+			for (auto &elem2 : this->m_trees[i].root.children)
+			{
+				if (this->equals(elem1.move, elem2.move))
+				{
+					visits += elem2.visits;
+					break;
+				}
+			}
+		}
+
+		if (visits > best)
+		{
+			best = visits;
+			best_ptr = &elem1;
+		}
+	}
+
+	p_move_ref = best_ptr->move;
+
+	this->anticipate(this->m_trees[0], *best_ptr, p_player_ptr, p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr);
+
+	return true;
+}
+
+void MCTS::reset(Node &p_node_ref)
+{
+	std::vector<Node>().swap(p_node_ref.children);
+
+	p_node_ref.visits = 0;
+	p_node_ref.score = 0;
+	p_node_ref.virtual_loss = 0;
+
+	p_node_ref.expanded = false;
+}
+
+// Replaces node with one of its own descendants
+void MCTS::adopt(Node &p_dest_ref, Node &p_src_ref)
+{
+	std::vector<Node> children;
+	children.swap(p_src_ref.children);
+
+	p_dest_ref.move = p_src_ref.move;
+	p_dest_ref.prior = p_src_ref.prior;
+
+	p_dest_ref.visits = p_src_ref.visits.load();
+	p_dest_ref.score = p_src_ref.score.load();
+	p_dest_ref.virtual_loss = 0;
+
+	p_dest_ref.expanded = p_src_ref.expanded.load();
+
+	// Former subtree (including source) is released upon leaving scope
+	p_dest_ref.children.swap(children);
+}
+
+void MCTS::reuse(Tree &p_tree_ref, const std::vector<int> &p_key_ref, Counters &p_counters_ref)
+{
+	Node *node_ptr = nullptr;
+
+	for (auto &elem : p_tree_ref.successors)
+	{
+		++p_counters_ref.probes;
+
+		if (elem.first == p_key_ref)
+		{
+			node_ptr = elem.second;
+			++p_counters_ref.hits;
+
+			break;
+		}
+	}
+
+	if (node_ptr != nullptr)
+		this->adopt(p_tree_ref.root, *node_ptr);
+
+	else
+		this->reset(p_tree_ref.root);
+
+	p_tree_ref.successors.clear();
+}
+
+void MCTS::anticipate(Tree &p_tree_ref, Node &p_node_ref, Player *p_player_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	p_tree_ref.successors.clear();
+
+	if (!p_node_ref.expanded)
+		return;
+
+	for (auto &elem : p_node_ref.children)
+	{
+		Board temp_board = *p_board_ptr;
+
+		Hand temp_active_hand = *p_active_hand_ptr;
+		Hand temp_passive_hand = *p_passive_hand_ptr;
+
+		p_player_ptr->actSim(p_node_ref.move, p_turn, &temp_active_hand, &temp_passive_hand, &temp_board);
+		p_player_ptr->actSim(elem.move, p_turn + 1, &temp_passive_hand, &temp_active_hand, &temp_board);
+
+		p_tree_ref.successors.push_back({ this->getKey(p_turn + 2, &temp_active_hand, &temp_passive_hand, &temp_board), &elem });
+	}
+}
+
+void MCTS::work(Player *p_player_ptr, Tree *p_tree_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, Deadline p_deadline, unsigned int p_seed)
+{
+	// Position is copied onto context of thread, so that threads neither count into nor remember within that of player
+	Context context;
+	context.RNG.seed(p_seed);
+
+	Board board(*p_board_ptr, &context);
+
+	Hand active_hand(*p_active_hand_ptr, &context);
+	Hand passive_hand(*p_passive_hand_ptr, &context);
+
+	std::vector<Node*> path;
+
+	do
+		this->iterate(p_player_ptr, p_tree_ptr->root, p_turn, &active_hand, &passive_hand, &board, path);
+
+	while (std::chrono::steady_clock::now() < p_deadline && !p_player_ptr->interrupted());
+
+	std::lock_guard<std::mutex> lock(this->m_mutex);
+	this->m_counters.add(context.counters);
+}
+
+void MCTS::iterate(Player *p_player_ptr, Node &p_root_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, std::vector<Node*> &p_path_ref)
+{
+	Board temp_board = *p_board_ptr;
+
+	Hand temp_active_hand = *p_active_hand_ptr;
+	Hand temp_passive_hand = *p_passive_hand_ptr;
+
+	Hand *active_hand_ptr = &temp_active_hand;
+	Hand *passive_hand_ptr = &temp_passive_hand;
+
+	Node *node_ptr = &p_root_ref;
+	int turn = p_turn;
+
+	bool terminal = false;
+
+	p_path_ref.clear();
+	p_path_ref.push_back(node_ptr);
+
+	// Selection
+	// ---------
+	while (true)
+	{
+		if (!node_ptr->expanded.load(std::memory_order_acquire))
+		{
+			// Nodes are only expanded once previously played out
+			if (node_ptr->visits == 0)
+				break;
+
+			if (!this->expand(p_player_ptr, *node_ptr, turn, active_hand_ptr, passive_hand_ptr, &temp_board))
+				break;
+		}
+
+		// Active color has no legal moves
+		if (node_ptr->children.empty())
+		{
+			terminal = true;
+			break;
+		}
+
+		node_ptr = this->select(*node_ptr);
+		node_ptr->virtual_loss += MCTS_VIRTUAL_LOSS;
+
+		p_player_ptr->actSim(node_ptr->move, turn, active_hand_ptr, passive_hand_ptr, &temp_board);
+
+		std::swap(active_hand_ptr, passive_hand_ptr);
+		++turn;
+
+		p_path_ref.push_back(node_ptr);
+	}
+
+	Counters &counters = temp_board.getContextPtr()->counters;
+
+	++counters.iterations;
+
+	counters.nodes += p_path_ref.size();
+	counters.depth = std::max(counters.depth, turn - p_turn);
+
+	// Simulation
+	// ----------
+	float result = (terminal ? 0.0f : this->playout(p_player_ptr, turn, active_hand_ptr, passive_hand_ptr, &temp_board));
+
+	// Backpropagation
+	// ---------------
+	// Each node accumulates results for player who made its move
+	for (auto i = p_path_ref.rbegin(); i != p_path_ref.rend(); ++i)
+	{
+		result = 1.0f - result;
+
+		(*i)->score += static_cast<int>(result * MCTS_RESOLUTION);
+		++(*i)->visits;
+
+		if (*i != &p_root_ref)
+			(*i)->virtual_loss -= MCTS_VIRTUAL_LOSS;
+	}
+}
+
+bool MCTS::expand(Player *p_player_ptr, Node &p_node_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	std::lock_guard<std::mutex> lock(p_node_ref.mutex);
+
+	// Expanded by another thread while waiting
+	if (p_node_ref.expanded)
+		return true;
+
+	if (this->m_nodes >= this->m_max_nodes)
+		return false;
+
+	std::vector<Player::Move> moves = p_player_ptr->getMoves(p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr);
+	std::vector<Node> children(moves.size());
+
+	float sum = 0.0f;
+
+	for (unsigned int i = 0; i < moves.size(); ++i)
+	{
+		children[i].move = moves[i];
+		children[i].prior = std::exp(this->getVictimWeight(moves[i], p_board_ptr) / MCTS_PRIOR_SCALE);
+
+		sum += children[i].prior;
+	}
+
+	for (auto &elem : children)
+		elem.prior /= sum;
+
+	this->m_nodes += children.size();
+
+	p_node_ref.children.swap(children);
+	p_node_ref.expanded.store(true, std::memory_order_release);
+
+	return true;
+}
+
+MCTS::Node* MCTS::select(Node &p_node_ref)
+{
+	Node *best_ptr = nullptr;
+	float best = -1.0f;
+
+	float parent_visits = static_cast<float>(std::max(1, p_node_ref.visits.load() + p_node_ref.virtual_loss.load()));
+
+	for (auto &elem : p_node_ref.children)
+	{
+		// Virtual losses count as visits without reward
+		float visits = static_cast<float>(elem.visits + elem.virtual_loss);
+		float value = 0.0f;
+
+		switch (this->m_policy)
+		{
+		case UCT:
+			// Unvisited moves are always tried first
+			if (visits == 0.0f)
+				return &elem;
+
+			value = elem.score / (visits * MCTS_RESOLUTION) + MCTS_UCT * std::sqrt(std::log(parent_visits) / visits);
+			break;
+
+		case PUCT:
+			value = (visits > 0.0f ? elem.score / (visits * MCTS_RESOLUTION) : 0.5f) + MCTS_PUCT * elem.prior * std::sqrt(parent_visits) / (1.0f + visits);
+			break;
+		}
+
+		if (value > best)
+		{
+			best = value;
+			best_ptr = &elem;
+		}
+	}
+
+	return best_ptr;
+}
+
+// Determines expected result for active color on specified turn
+float MCTS::playout(Player *p_player_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	std::default_random_engine &RNG = p_board_ptr->getContextPtr()->RNG;
+
+	Hand *active_hand_ptr = p_active_hand_ptr;
+	Hand *passive_hand_ptr = p_passive_hand_ptr;
+
+	int turn = p_turn;
+
+	for (int i = 0; i < MCTS_PLAYOUT_DEPTH; ++i)
+	{
+		Player::Move move;
+
+		if (!this->sample(p_player_ptr, move, turn, active_hand_ptr, passive_hand_ptr, p_board_ptr))
+		{
+			std::vector<Player::Move> moves = p_player_ptr->getMoves(turn, active_hand_ptr, passive_hand_ptr, p_board_ptr);
+
+			// Active color on current turn is checkmated
+			if (moves.empty())
+				return ((turn - p_turn) % 2 ? 1.0f : 0.0f);
+
+			move = moves[draw(RNG, 0, moves.size() - 1)];
+		}
+
+		p_player_ptr->actSim(move, turn, active_hand_ptr, passive_hand_ptr, p_board_ptr);
+
+		std::swap(active_hand_ptr, passive_hand_ptr);
+		++turn;
+	}
+
+	float score = 0.0f;
+
+	if (p_player_ptr->neural())
+	{
+		NNUE::Accumulator accumulator;
+		p_player_ptr->accumulate(accumulator, turn, active_hand_ptr, passive_hand_ptr, p_board_ptr);
+
+		score = static_cast<float>(p_player_ptr->m_network_ptr->evaluate(accumulator, p_player_ptr->getActiveColor(turn)));
+	}
+
+	else
+		score = static_cast<float>(p_player_ptr->evalMaterial(turn, active_hand_ptr, passive_hand_ptr, p_board_ptr));
+	float result = 1.0f / (1.0f + std::exp(-score / MCTS_EVAL_SCALE));
+
+	return ((turn - p_turn) % 2 ? 1.0f - result : result);
+}
+
+// Chooses playout move from randomly sampled legal candidates
+// Strikes are favored by weight of piece captured
+bool MCTS::sample(Player *p_player_ptr, Player::Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	std::default_random_engine &RNG = p_board_ptr->getContextPtr()->RNG;
+
+	bool drops = !p_active_hand_ptr->empty();
+
+	int found = 0;
+	int best = -1;
+
+	for (int i = 0; i < MCTS_PLAYOUT_TRIES && found < MCTS_PLAYOUT_WIDTH; ++i)
+	{
+		Player::Move move;
+
+		int x = draw(RNG, 0, BOARD_COLS - 1);
+		int y = draw(RNG, 0, BOARD_ROWS - 1);
+
+		if (drops && draw(RNG, 0, 1))
+		{
+			int x1 = draw(RNG, 0, HAND_COLS - 1);
+			int y1 = draw(RNG, 0, HAND_ROWS - 1);
+
+			if (p_active_hand_ptr->getHeight(x1, y1) == 0)
+				continue;
+
+			if (!p_board_ptr->droppable(p_active_hand_ptr->getPiecePtr(x1, y1), x, y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+				continue;
+
+			move = { Player::SET, { x1, y1, 0 }, { x, y, 0 }, { 0, 0, 0 }, 0 };
+		}
+
+		else
+		{
+			if (!p_board_ptr->selectable(x, y, p_turn))
+				continue;
+
+			std::vector<Move> targets = p_board_ptr->getMoves(x, y);
+
+			if (targets.empty())
+				continue;
+
+			Move target = targets[draw(RNG, 0, targets.size() - 1)];
+
+			if (!p_board_ptr->moveable(x, y, target.x, target.y))
+				continue;
+
+			if (p_board_ptr->strikeable(x, y, target.x, target.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+			{
+				move = { Player::STRIKE, { x, y, 0 }, { target.x, target.y, 0 }, { 0, 0, 0 }, 0 };
+
+				// Captured lance must be rearranged onto one of its droppable squares
+				if (p_board_ptr->rearrangeableLat(x, y, target.x, target.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+				{
+					std::vector<Player::Move> moves;
+					p_player_ptr->genRearrangements(move, moves, p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr);
+
+					if (moves.empty())
+						continue;
+
+					move = moves[draw(RNG, 0, moves.size() - 1)];
+				}
+			}
+
+			else if (p_board_ptr->moveable(x, y, target.x, target.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+				move = { Player::MOVE, { x, y, 0 }, { target.x, target.y, 0 }, { 0, 0, 0 }, 0 };
+
+			else
+				continue;
+		}
+
+		int score = this->getVictimWeight(move, p_board_ptr) + draw(RNG, 0, MCTS_PLAYOUT_NOISE);
+
+		if (score > best)
+		{
+			best = score;
+			p_move_ref = move;
+		}
+
+		++found;
+	}
+
+	return (found > 0);
+}
+
+int MCTS::getVictimWeight(Player::Move p_move, Board *p_board_ptr)
+{
+	switch (p_move.func)
+	{
+	case Player::STRIKE:
+		return p_board_ptr->getPiecePtr(p_move.dest.x, p_move.dest.y)->getWeight();
+
+	case Player::DOWN:
+		return p_board_ptr->getPiecePtr(p_move.src.x, p_move.src.y, p_move.src.z - 1)->getWeight();
+
+	case Player::UP:
+		return p_board_ptr->getPiecePtr(p_move.src.x, p_move.src.y, p_move.src.z + 1)->getWeight();
+
+	// Remaining functions capture nothing
+	default:
+		return 0;
+	}
+}
+
+int MCTS::count(Node &p_node_ref)
+{
+	int count = p_node_ref.children.size();
+
+	for (auto &elem : p_node_ref.children)
+		count += this->count(elem);
+
+	return count;
+}
+
+// Turn, board configuration, number of each piece face held in each hand, and exchange restrictions in effect
+// Turn and restrictions are keyed along with pieces, as legal actions of position depend upon them
+std::vector<int> MCTS::getKey(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	std::vector<int> key;
+	key.push_back(p_turn);
+
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			for (auto &elem : p_board_ptr->getStackRef(j, i))
+				key.push_back(elem->getSideUp() + elem->getColor());
+
+			key.push_back(-1);
+		}
+	}
+
+	std::vector<int> counts(2 * NUM_PIECES, 0);
+
+	for (int i = 0; i < HAND_ROWS; ++i)
+	{
+		for (int j = 0; j < HAND_COLS; ++j)
+		{
+			for (auto &elem : p_active_hand_ptr->getStackRef(j, i))
+				++counts[elem->getSideUp() + elem->getColor()];
+
+			for (auto &elem : p_passive_hand_ptr->getStackRef(j, i))
+				++counts[NUM_PIECES + elem->getSideUp() + elem->getColor()];
+		}
+	}
+
+	key.insert(key.end(), counts.begin(), counts.end());
+
+	for (auto &elem : p_board_ptr->getExchangesRef())
+	{
+		key.push_back(elem.square_ptr->getID());
+		key.push_back(elem.turn);
+	}
+
+	return key;
+}
+
+bool MCTS::equals(Player::Move p_move1, Player::Move p_move2)
+{
+	if (p_move1.func != p_move2.func)
+		return false;
+
+	if (p_move1.src.x != p_move2.src.x || p_move1.src.y != p_move2.src.y || p_move1.src.z != p_move2.src.z)
+		return false;
+
+	if (p_move1.dest.x != p_move2.dest.x || p_move1.dest.y != p_move2.dest.y)
+		return false;
+
+	if (p_move1.rear.x != p_move2.rear.x || p_move1.rear.y != p_move2.rear.y)
+		return false;
+
+	return true;
+}
+
+// Functions
+// ---------
+// Draws from specified random engine, uniformly within specified bounds
+static int draw(std::default_random_engine &p_RNG_ref, int p_min, int p_max)
+{
+	std::uniform_int_distribution<int> dist(p_min, p_max);
+
+	return dist(p_RNG_ref);
+}
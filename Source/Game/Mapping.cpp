@@ -0,0 +1,114 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Mapping.cpp
+ * 
+ * Summary:	Maps files into memory for reading in place
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Mapping.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Class functions
+// ---------------
+// Destructor
+Mapping::~Mapping()
+{
+	this->unmap();
+}
+
+// Member functions
+// ----------------
+// Maps specified file into memory, whatever it holds
+// Handles are released once view exists, which keeps file mapped until it is unmapped
+bool Mapping::map(const std::string &p_path_ref)
+{
+	this->unmap();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(p_path_ref.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+
+	if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+	{
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	CloseHandle(file);
+
+	if (mapping == nullptr)
+		return false;
+
+	void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (data == nullptr)
+		return false;
+
+	this->m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+	int descriptor = open(p_path_ref.c_str(), O_RDONLY);
+
+	if (descriptor < 0)
+		return false;
+
+	struct stat status;
+
+	if (fstat(descriptor, &status) != 0 || status.st_size == 0)
+	{
+		close(descriptor);
+		return false;
+	}
+
+	void *data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	this->m_size = static_cast<std::size_t>(status.st_size);
+#endif
+
+	this->m_data = static_cast<const char*>(data);
+
+	return true;
+}
+
+void Mapping::unmap()
+{
+	if (this->m_data == nullptr)
+		return;
+
+#ifdef _WIN32
+	UnmapViewOfFile(this->m_data);
+#else
+	munmap(const_cast<char*>(this->m_data), this->m_size);
+#endif
+
+	this->m_data = nullptr;
+	this->m_size = 0;
+}
@@ -0,0 +1,445 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	NNUE.cpp
+ * 
+ * Summary:	Evaluates positions by an efficiently updatable neural network as
+ *		an alternative to the player's material and mobility heuristics
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/NNUE.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+// Member functions
+// ----------------
+// Restore network weights from binary file
+bool NNUE::load(const std::string &p_path_ref)
+{
+	this->m_loaded = false;
+
+	std::ifstream file;
+	file.open(p_path_ref, std::ios_base::in | std::ios_base::binary);
+
+	// Network is optional, so its absence is not reported
+	if (!file.is_open())
+		return false;
+
+	std::uint32_t header[5];
+	file.read(reinterpret_cast<char*>(header), sizeof(header));
+
+	if (!file.good() || header[0] != NNUE_MAGIC || header[1] != NNUE_VERSION)
+	{
+		std::cerr << "ERROR::NNUE::LOAD::FILE::BAD_HEADER >> " << p_path_ref << std::endl;
+		return false;
+	}
+
+	if (header[2] != NNUE_FEATURES || header[3] != NNUE_HIDDEN || header[4] != NNUE_LAYER)
+	{
+		std::cerr << "ERROR::NNUE::LOAD::FILE::BAD_DIMENSIONS >> " << p_path_ref << std::endl;
+		std::cerr << "features::" << header[2] << " | " << "hidden::" << header[3] << " | " << "layer::" << header[4] << std::endl;
+
+		return false;
+	}
+
+	this->m_input_biases.resize(NNUE_HIDDEN);
+	this->m_input_weights.resize(NNUE_FEATURES * NNUE_HIDDEN);
+
+	this->m_hidden_biases.resize(NNUE_LAYER);
+	this->m_hidden_weights.resize(NNUE_LAYER * NNUE_HIDDEN * 2);
+
+	this->m_output_weights.resize(NNUE_LAYER);
+
+	file.read(reinterpret_cast<char*>(this->m_input_biases.data()), this->m_input_biases.size() * sizeof(std::int16_t));
+	file.read(reinterpret_cast<char*>(this->m_input_weights.data()), this->m_input_weights.size() * sizeof(std::int16_t));
+
+	file.read(reinterpret_cast<char*>(this->m_hidden_biases.data()), this->m_hidden_biases.size() * sizeof(std::int32_t));
+	file.read(reinterpret_cast<char*>(this->m_hidden_weights.data()), this->m_hidden_weights.size() * sizeof(std::int8_t));
+
+	file.read(reinterpret_cast<char*>(&this->m_output_bias), sizeof(std::int32_t));
+	file.read(reinterpret_cast<char*>(this->m_output_weights.data()), this->m_output_weights.size() * sizeof(std::int8_t));
+
+	if (!file.good())
+	{
+		std::cerr << "ERROR::NNUE::LOAD::FILE::TRUNCATED >> " << p_path_ref << std::endl;
+		std::cerr << "eofbit::" << file.eof() << " | " << "failbit::" << file.fail() << " | " << "badbit::" << file.bad() << std::endl;
+
+		return false;
+	}
+
+	file.close();
+
+	return (this->m_loaded = true);
+}
+
+// Computes accumulator from scratch
+void NNUE::refresh(Accumulator &p_accumulator_ref, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	for (int i = 0; i < 2; ++i)
+	{
+		game::Piece::Color color = (i ? game::Piece::WHITE : game::Piece::BLACK);
+
+		int features[NNUE_MAX_ACTIVE];
+		int count = this->getFeatures(features, color, p_black_hand_ptr, p_white_hand_ptr, p_board_ptr);
+
+		std::memcpy(p_accumulator_ref.values[i], this->m_input_biases.data(), NNUE_HIDDEN * sizeof(std::int16_t));
+
+		for (int j = 0; j < count; ++j)
+			this->addFeature(p_accumulator_ref.values[i], features[j]);
+	}
+
+	this->count(p_accumulator_ref.hands[0], p_black_hand_ptr);
+	this->count(p_accumulator_ref.hands[1], p_white_hand_ptr);
+}
+
+// Computes accumulator from that of preceding position, which differs only at specified squares and in hands
+// Towers of specified squares are compared between boards, and hands by count of each face, so only features which differ are applied
+void NNUE::update(Accumulator &p_accumulator_ref, const Accumulator &p_parent_ref, const Coords2D *p_squares_ptr, int p_count, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_parent_board_ptr, Board *p_board_ptr)
+{
+	std::memcpy(p_accumulator_ref.values, p_parent_ref.values, sizeof(p_accumulator_ref.values));
+
+	for (int i = 0; i < p_count; ++i)
+	{
+		int x = p_squares_ptr[i].x;
+		int y = p_squares_ptr[i].y;
+
+		// Square listed twice must only be applied once
+		bool repeated = false;
+
+		for (int j = 0; j < i; ++j)
+			repeated = (repeated || (p_squares_ptr[j].x == x && p_squares_ptr[j].y == y));
+
+		if (repeated)
+			continue;
+
+		for (int j = 0; j < 2; ++j)
+		{
+			game::Piece::Color color = (j ? game::Piece::WHITE : game::Piece::BLACK);
+
+			int parent_features[MAX_HEIGHT];
+			int features[MAX_HEIGHT];
+
+			int parent_count = this->getFeatures(parent_features, color, x, y, p_parent_board_ptr);
+			int count = this->getFeatures(features, color, x, y, p_board_ptr);
+
+			// Tiers unchanged by action, such as those beneath piece moved onto tower, are left as they are
+			for (int k = 0; k < std::max(count, parent_count); ++k)
+			{
+				if (k < count && k < parent_count && features[k] == parent_features[k])
+					continue;
+
+				if (k < parent_count)
+					this->subFeature(p_accumulator_ref.values[j], parent_features[k]);
+
+				if (k < count)
+					this->addFeature(p_accumulator_ref.values[j], features[k]);
+			}
+		}
+	}
+
+	this->count(p_accumulator_ref.hands[0], p_black_hand_ptr);
+	this->count(p_accumulator_ref.hands[1], p_white_hand_ptr);
+
+	// Hand features are thresholds of count of each face, so only those crossed are applied
+	for (int i = 0; i < 2; ++i)
+	{
+		for (int j = 0; j < NNUE_FACES; ++j)
+		{
+			int parent_count = std::min(p_parent_ref.hands[i][j], NNUE_HAND_DEPTH);
+			int count = std::min(p_accumulator_ref.hands[i][j], NNUE_HAND_DEPTH);
+
+			// Hand is own to perspective of its color, which lists own hand first
+			for (int k = 0; k < 2; ++k)
+			{
+				int feature = NNUE_BOARD_FEATURES + ((i == k ? 0 : 1) * NNUE_FACES + j) * NNUE_HAND_DEPTH;
+
+				for (int l = parent_count; l < count; ++l)
+					this->addFeature(p_accumulator_ref.values[k], feature + l);
+
+				for (int l = count; l < parent_count; ++l)
+					this->subFeature(p_accumulator_ref.values[k], feature + l);
+			}
+		}
+	}
+}
+
+// Scores position from perspective of specified color
+int NNUE::evaluate(const Accumulator &p_accumulator_ref, game::Piece::Color p_color)
+{
+	int perspective = this->getPerspective(p_color);
+
+	alignas(32) std::uint8_t input[NNUE_HIDDEN * 2];
+	alignas(32) std::uint8_t hidden[NNUE_LAYER];
+
+	// Perspective of color being evaluated always comes first
+	this->transform(input, p_accumulator_ref.values[perspective]);
+	this->transform(input + NNUE_HIDDEN, p_accumulator_ref.values[1 - perspective]);
+
+	for (int i = 0; i < NNUE_LAYER; ++i)
+	{
+		int value = (this->m_hidden_biases[i] + this->dot(input, &this->m_hidden_weights[i * NNUE_HIDDEN * 2], NNUE_HIDDEN * 2)) >> NNUE_WEIGHT_SHIFT;
+		hidden[i] = static_cast<std::uint8_t>(std::min(std::max(value, 0), NNUE_ACTIVATION_MAX));
+	}
+
+	int output = this->m_output_bias;
+
+	for (int i = 0; i < NNUE_LAYER; ++i)
+		output += hidden[i] * this->m_output_weights[i];
+
+	return (output * NNUE_EVAL_UNIT / (NNUE_ACTIVATION_MAX << NNUE_WEIGHT_SHIFT));
+}
+
+// Records training sample with result for specified color
+// Features of both perspectives are listed, specified color first, followed by result
+void NNUE::writeSample(std::ostream &p_stream_ref, float p_result, game::Piece::Color p_color, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	int features[NNUE_MAX_ACTIVE];
+
+	game::Piece::Color colors[] = { p_color, (p_color == game::Piece::WHITE ? game::Piece::BLACK : game::Piece::WHITE) };
+
+	for (auto &elem : colors)
+	{
+		int count = this->getFeatures(features, elem, p_black_hand_ptr, p_white_hand_ptr, p_board_ptr);
+
+		for (int i = 0; i < count; ++i)
+			p_stream_ref << features[i] << (i < count - 1 ? "," : "");
+
+		p_stream_ref << ';';
+	}
+
+	p_stream_ref << p_result << std::endl;
+}
+
+// Lists active features from perspective of specified color
+// Ranks are mirrored for black so that own territory always comes first
+// Features are generated in ascending order, so no sorting is needed
+int NNUE::getFeatures(int *p_features_ptr, game::Piece::Color p_color, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	int count = 0;
+
+	for (int rank = 0; rank < BOARD_ROWS; ++rank)
+	{
+		int y = (p_color == game::Piece::WHITE ? rank : BOARD_ROWS - 1 - rank);
+
+		for (int j = 0; j < BOARD_COLS; ++j)
+			count += this->getFeatures(p_features_ptr + count, p_color, j, y, p_board_ptr);
+	}
+
+	Hand *hand_ptrs[] = { (p_color == game::Piece::WHITE ? p_white_hand_ptr : p_black_hand_ptr), (p_color == game::Piece::WHITE ? p_black_hand_ptr : p_white_hand_ptr) };
+
+	for (int i = 0; i < 2; ++i)
+	{
+		int counts[NNUE_FACES];
+		this->count(counts, hand_ptrs[i]);
+
+		for (int j = 0; j < NNUE_FACES; ++j)
+		{
+			for (int k = 0; k < std::min(counts[j], NNUE_HAND_DEPTH); ++k)
+				p_features_ptr[count++] = NNUE_BOARD_FEATURES + (i * NNUE_FACES + j) * NNUE_HAND_DEPTH + k;
+		}
+	}
+
+	return count;
+}
+
+// Lists active features of tower at specified coordinates from perspective of specified color
+// Features are listed by tier, in ascending order
+// Blank side of commander taken in search has no feature
+int NNUE::getFeatures(int *p_features_ptr, game::Piece::Color p_color, int x, int y, Board *p_board_ptr)
+{
+	int count = 0;
+	int rank = (p_color == game::Piece::WHITE ? y : BOARD_ROWS - 1 - y);
+
+	std::vector<game::Piece*> &stack_ref = p_board_ptr->getStackRef(x, y);
+
+	for (unsigned int i = 0; i < stack_ref.size(); ++i)
+	{
+		if (stack_ref[i]->getSideUp() == game::Piece::BLANK)
+			continue;
+
+		int slot = (rank * BOARD_COLS + x) * MAX_HEIGHT + i;
+		int relation = (stack_ref[i]->getAlignment() == p_color ? 0 : NNUE_FACES);
+
+		p_features_ptr[count++] = slot * NNUE_FACES * 2 + relation + stack_ref[i]->getSideUp() - 1;
+	}
+
+	return count;
+}
+
+// Counts pieces of each face in specified hand
+// Blank side of commander taken in search has no feature
+void NNUE::count(int *p_counts_ptr, Hand *p_hand_ptr)
+{
+	std::fill(p_counts_ptr, p_counts_ptr + NNUE_FACES, 0);
+
+	for (int i = 0; i < HAND_ROWS; ++i)
+	{
+		for (int j = 0; j < HAND_COLS; ++j)
+		{
+			for (auto &elem : p_hand_ptr->getStackRef(j, i))
+			{
+				if (elem->getSideUp() != game::Piece::BLANK)
+					++p_counts_ptr[elem->getSideUp() - 1];
+			}
+		}
+	}
+}
+
+void NNUE::addFeature(std::int16_t *p_values_ptr, int p_feature)
+{
+	const std::int16_t *weights_ptr = &this->m_input_weights[p_feature * NNUE_HIDDEN];
+
+#if defined(__AVX2__)
+	for (int i = 0; i < NNUE_HIDDEN; i += 16)
+	{
+		__m256i values = _mm256_load_si256(reinterpret_cast<const __m256i*>(p_values_ptr + i));
+		__m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights_ptr + i));
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(p_values_ptr + i), _mm256_add_epi16(values, weights));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	for (int i = 0; i < NNUE_HIDDEN; i += 8)
+	{
+		__m128i values = _mm_load_si128(reinterpret_cast<const __m128i*>(p_values_ptr + i));
+		__m128i weights = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights_ptr + i));
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(p_values_ptr + i), _mm_add_epi16(values, weights));
+	}
+#else
+	for (int i = 0; i < NNUE_HIDDEN; ++i)
+		p_values_ptr[i] += weights_ptr[i];
+#endif
+}
+
+void NNUE::subFeature(std::int16_t *p_values_ptr, int p_feature)
+{
+	const std::int16_t *weights_ptr = &this->m_input_weights[p_feature * NNUE_HIDDEN];
+
+#if defined(__AVX2__)
+	for (int i = 0; i < NNUE_HIDDEN; i += 16)
+	{
+		__m256i values = _mm256_load_si256(reinterpret_cast<const __m256i*>(p_values_ptr + i));
+		__m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights_ptr + i));
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(p_values_ptr + i), _mm256_sub_epi16(values, weights));
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	for (int i = 0; i < NNUE_HIDDEN; i += 8)
+	{
+		__m128i values = _mm_load_si128(reinterpret_cast<const __m128i*>(p_values_ptr + i));
+		__m128i weights = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights_ptr + i));
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(p_values_ptr + i), _mm_sub_epi16(values, weights));
+	}
+#else
+	for (int i = 0; i < NNUE_HIDDEN; ++i)
+		p_values_ptr[i] -= weights_ptr[i];
+#endif
+}
+
+// Clips accumulator to activation range
+void NNUE::transform(std::uint8_t *p_output_ptr, const std::int16_t *p_input_ptr)
+{
+#if defined(__AVX2__)
+	const __m256i max = _mm256_set1_epi16(NNUE_ACTIVATION_MAX);
+
+	for (int i = 0; i < NNUE_HIDDEN; i += 32)
+	{
+		__m256i input1 = _mm256_min_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(p_input_ptr + i)), max);
+		__m256i input2 = _mm256_min_epi16(_mm256_load_si256(reinterpret_cast<const __m256i*>(p_input_ptr + i + 16)), max);
+
+		// Packing saturates negative values to zero but interleaves 128 bit lanes, which permutation undoes
+		__m256i output = _mm256_permute4x64_epi64(_mm256_packus_epi16(input1, input2), 0xD8);
+
+		_mm256_store_si256(reinterpret_cast<__m256i*>(p_output_ptr + i), output);
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128i max = _mm_set1_epi16(NNUE_ACTIVATION_MAX);
+	const __m128i min = _mm_setzero_si128();
+
+	for (int i = 0; i < NNUE_HIDDEN; i += 16)
+	{
+		__m128i input1 = _mm_max_epi16(_mm_min_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(p_input_ptr + i)), max), min);
+		__m128i input2 = _mm_max_epi16(_mm_min_epi16(_mm_load_si128(reinterpret_cast<const __m128i*>(p_input_ptr + i + 8)), max), min);
+
+		_mm_store_si128(reinterpret_cast<__m128i*>(p_output_ptr + i), _mm_packus_epi16(input1, input2));
+	}
+#else
+	for (int i = 0; i < NNUE_HIDDEN; ++i)
+		p_output_ptr[i] = static_cast<std::uint8_t>(std::min(std::max(static_cast<int>(p_input_ptr[i]), 0), NNUE_ACTIVATION_MAX));
+#endif
+}
+
+int NNUE::dot(const std::uint8_t *p_input_ptr, const std::int8_t *p_weights_ptr, int p_size)
+{
+#if defined(__AVX2__)
+	const __m256i ones = _mm256_set1_epi16(1);
+	__m256i sum = _mm256_setzero_si256();
+
+	// Products of adjacent pairs cannot saturate since inputs are at most 127
+	for (int i = 0; i < p_size; i += 32)
+	{
+		__m256i input = _mm256_load_si256(reinterpret_cast<const __m256i*>(p_input_ptr + i));
+		__m256i weights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p_weights_ptr + i));
+
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(input, weights), ones));
+	}
+
+	__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0x4E));
+	sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, 0xB1));
+
+	return _mm_cvtsi128_si32(sum128);
+#elif defined(__SSE2__) || defined(_M_X64)
+	const __m128i zero = _mm_setzero_si128();
+	__m128i sum = _mm_setzero_si128();
+
+	// Inputs are zero extended and weights sign extended to 16 bits
+	for (int i = 0; i < p_size; i += 16)
+	{
+		__m128i input = _mm_load_si128(reinterpret_cast<const __m128i*>(p_input_ptr + i));
+		__m128i weights = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p_weights_ptr + i));
+
+		__m128i input1 = _mm_unpacklo_epi8(input, zero);
+		__m128i input2 = _mm_unpackhi_epi8(input, zero);
+
+		__m128i weights1 = _mm_srai_epi16(_mm_unpacklo_epi8(weights, weights), 8);
+		__m128i weights2 = _mm_srai_epi16(_mm_unpackhi_epi8(weights, weights), 8);
+
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(input1, weights1));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(input2, weights2));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+
+	return _mm_cvtsi128_si32(sum);
+#else
+	int sum = 0;
+
+	for (int i = 0; i < p_size; ++i)
+		sum += p_input_ptr[i] * p_weights_ptr[i];
+
+	return sum;
+#endif
+}
@@ -0,0 +1,585 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Notation.cpp
+ * 
+ * Summary:	Writes and reads actions as compact text tokens and positions as
+ *		single lines, for driving the game from outside of the client
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Notation.h"
+
+#include <cctype>
+#include <charconv>
+
+// Kinds of pieces, as pairs of faces, letters corresponding to them, and identifiers of pieces of kind less color
+struct Kind
+{
+	game::Piece::Face front;
+	game::Piece::Face back;
+
+	char letter;
+
+	int first;
+	int count;
+};
+
+static const Kind KINDS[] =
+{
+	{ game::Piece::COMMANDER, game::Piece::BLANK, 'C', 0, 1 },
+	{ game::Piece::CAPTAIN, game::Piece::PISTOL, 'A', 1, 2 },
+	{ game::Piece::SAMURAI, game::Piece::PIKE, 'S', 3, 2 },
+	{ game::Piece::SPY, game::Piece::CLANDESTINITE, 'Y', 5, 3 },
+	{ game::Piece::CATAPULT, game::Piece::LANCE, 'T', 8, 1 },
+	{ game::Piece::FORTRESS, game::Piece::LANCE, 'F', 9, 1 },
+	{ game::Piece::HIDDEN_DRAGON, game::Piece::DRAGON_KING, 'D', 10, 1 },
+	{ game::Piece::PRODIGY, game::Piece::PHOENIX, 'R', 11, 1 },
+	{ game::Piece::BOW, game::Piece::ARROW, 'B', 12, 2 },
+	{ game::Piece::PAWN, game::Piece::BRONZE, 'P', 14, 7 },
+	{ game::Piece::PAWN, game::Piece::SILVER, 'V', 21, 1 },
+	{ game::Piece::PAWN, game::Piece::GOLD, 'G', 22, 1 },
+};
+
+// Kinds of pieces by identifier less color, as built by set
+static const int KIND_INDICES[] = { 0, 1, 1, 2, 2, 3, 3, 3, 4, 5, 6, 7, 8, 8, 9, 9, 9, 9, 9, 9, 9, 10, 11, };
+
+// Class functions
+// ---------------
+// Writes token of action about to be performed, returning end of it, or null if buffer is too small
+// Rearrangement is determined from position before action, so token must be written before action is performed
+char* Notation::writeMove(char *p_first, char *p_last, const Player::Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	if (p_last - p_first < NOTATION_MOVE_SIZE)
+		return nullptr;
+
+	char *it = p_first;
+	bool rearranged = false;
+
+	switch (p_move_ref.func)
+	{
+	case Player::SET:
+	{
+		if (p_active_hand_ptr->getHeight(p_move_ref.src.x, p_move_ref.src.y) == 0)
+			return nullptr;
+
+		game::Piece *piece_ptr = p_active_hand_ptr->getPiecePtr(p_move_ref.src.x, p_move_ref.src.y);
+
+		if (piece_ptr->getSide() == game::Piece::BACK)
+			*it++ = '+';
+
+		*it++ = Notation::getLetter(piece_ptr);
+		*it++ = '*';
+
+		return Notation::writeSquare(it, p_move_ref.dest.x, p_move_ref.dest.y);
+	}
+
+	case Player::MOVE:
+		it = Notation::writeSquare(it, p_move_ref.src.x, p_move_ref.src.y);
+		return Notation::writeSquare(it, p_move_ref.dest.x, p_move_ref.dest.y);
+
+	case Player::STRIKE:
+		it = Notation::writeSquare(it, p_move_ref.src.x, p_move_ref.src.y);
+		*it++ = 'x';
+		it = Notation::writeSquare(it, p_move_ref.dest.x, p_move_ref.dest.y);
+
+		rearranged = p_board_ptr->rearrangeableLat(p_move_ref.src.x, p_move_ref.src.y, p_move_ref.dest.x, p_move_ref.dest.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+		break;
+
+	case Player::DOWN:
+	case Player::UP:
+	{
+		int z = p_move_ref.src.z + (p_move_ref.func == Player::DOWN ? -1 : 1);
+
+		it = Notation::writeSquare(it, p_move_ref.src.x, p_move_ref.src.y);
+		*it++ = (p_move_ref.func == Player::DOWN ? '-' : '+');
+		*it++ = static_cast<char>('1' + p_move_ref.src.z);
+
+		rearranged = p_board_ptr->rearrangeableVert(p_move_ref.src.x, p_move_ref.src.y, p_move_ref.src.z, z, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+		break;
+	}
+
+	case Player::EXCHANGE:
+		it = Notation::writeSquare(it, p_move_ref.src.x, p_move_ref.src.y);
+		*it++ = '=';
+
+		return it;
+
+	case Player::SUBSTITUTE:
+		it = Notation::writeSquare(it, p_move_ref.src.x, p_move_ref.src.y);
+		*it++ = '~';
+
+		return it;
+	}
+
+	if (rearranged)
+	{
+		*it++ = '/';
+		it = Notation::writeSquare(it, p_move_ref.rear.x, p_move_ref.rear.y);
+	}
+
+	return it;
+}
+
+// Parses token of action of active color, leaving legality to caller
+// Coordinates not written in token are left zero, as they are in generated actions
+bool Notation::readMove(const char *p_first, const char *p_last, Player::Move &p_move_ref, Hand *p_active_hand_ptr)
+{
+	p_move_ref = { Player::SET, { 0, 0, 0 }, { 0, 0, 0 }, { 0, 0, 0 }, 0 };
+
+	const char *it = p_first;
+
+	if (it == p_last)
+		return false;
+
+	// Set from hand, piece being found by kind and side up
+	if (*it == '+' || (*it >= 'A' && *it <= 'Z'))
+	{
+		game::Piece::Side side = game::Piece::FRONT;
+
+		if (*it == '+')
+		{
+			side = game::Piece::BACK;
+
+			if (++it == p_last)
+				return false;
+		}
+
+		char letter = *it++;
+
+		if (it == p_last || *it++ != '*')
+			return false;
+
+		if ((it = Notation::readSquare(it, p_last, p_move_ref.dest.x, p_move_ref.dest.y)) != p_last)
+			return false;
+
+		for (int i = 0; i < HAND_ROWS; ++i)
+		{
+			for (int j = 0; j < HAND_COLS; ++j)
+			{
+				if (p_active_hand_ptr->getHeight(j, i) == 0)
+					continue;
+
+				game::Piece *piece_ptr = p_active_hand_ptr->getPiecePtr(j, i);
+
+				if (Notation::getLetter(piece_ptr) == letter && piece_ptr->getSide() == side)
+				{
+					p_move_ref.src = { j, i, 0 };
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	if ((it = Notation::readSquare(it, p_last, p_move_ref.src.x, p_move_ref.src.y)) == nullptr || it == p_last)
+		return false;
+
+	switch (*it)
+	{
+	case 'x':
+		p_move_ref.func = Player::STRIKE;
+
+		if ((it = Notation::readSquare(it + 1, p_last, p_move_ref.dest.x, p_move_ref.dest.y)) == nullptr)
+			return false;
+
+		break;
+
+	case '-':
+	case '+':
+		p_move_ref.func = (*it == '-' ? Player::DOWN : Player::UP);
+
+		if (++it == p_last || *it < '1' || *it > '0' + MAX_HEIGHT)
+			return false;
+
+		p_move_ref.src.z = *it++ - '1';
+		break;
+
+	case '=':
+		p_move_ref.func = Player::EXCHANGE;
+		return (it + 1 == p_last);
+
+	case '~':
+		p_move_ref.func = Player::SUBSTITUTE;
+		return (it + 1 == p_last);
+
+	default:
+		p_move_ref.func = Player::MOVE;
+		return (Notation::readSquare(it, p_last, p_move_ref.dest.x, p_move_ref.dest.y) == p_last);
+	}
+
+	if (it != p_last && *it == '/')
+	{
+		if ((it = Notation::readSquare(it + 1, p_last, p_move_ref.rear.x, p_move_ref.rear.y)) == nullptr)
+			return false;
+	}
+
+	return (it == p_last);
+}
+
+// Writes position, returning end of it, or null if buffer is too small
+// Nothing is allocated, so that positions may be written in bulk
+char* Notation::writePosition(char *p_first, char *p_last, int p_turn, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	if (p_last - p_first < NOTATION_POSITION_SIZE)
+		return nullptr;
+
+	char *it = p_first;
+
+	for (int i = BOARD_ROWS - 1; i >= 0; --i)
+	{
+		int empty = 0;
+
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			int height = p_board_ptr->getHeight(j, i);
+
+			if (height == 0)
+			{
+				++empty;
+				continue;
+			}
+
+			if (empty > 0)
+			{
+				*it++ = static_cast<char>('0' + empty);
+				empty = 0;
+			}
+
+			if (height > 1)
+				*it++ = '(';
+
+			for (auto &elem : p_board_ptr->getStackRef(j, i))
+				it = Notation::writePiece(it, elem);
+
+			if (height > 1)
+				*it++ = ')';
+		}
+
+		if (empty > 0)
+			*it++ = static_cast<char>('0' + empty);
+
+		if (i > 0)
+			*it++ = '/';
+	}
+
+	*it++ = ' ';
+	it = Notation::writeHand(it, p_black_hand_ptr);
+	*it++ = '/';
+	it = Notation::writeHand(it, p_white_hand_ptr);
+
+	*it++ = ' ';
+	*it++ = (p_turn % 2 ? 'b' : 'w');
+	*it++ = ' ';
+	it = std::to_chars(it, p_last, p_turn).ptr;
+	*it++ = ' ';
+
+	std::vector<Exchange> &exchanges_ref = p_board_ptr->getExchangesRef();
+
+	if (exchanges_ref.empty())
+		*it++ = '-';
+
+	for (unsigned int i = 0; i < exchanges_ref.size(); ++i)
+	{
+		// Square, separators, and turn of ten digits at most
+		if (p_last - it < 14)
+			return nullptr;
+
+		if (i > 0)
+			*it++ = ',';
+
+		it = Notation::writeSquare(it, exchanges_ref[i].square_ptr->getX(), exchanges_ref[i].square_ptr->getY());
+		*it++ = ':';
+		it = std::to_chars(it, p_last, exchanges_ref[i].turn).ptr;
+	}
+
+	return it;
+}
+
+// Sets pieces of written position onto emptied hands and board
+// Pieces are taken from set by kind, and need only be legal in number and in hand of their alignment
+bool Notation::readPosition(const char *p_first, const char *p_last, int &p_turn_ref, Set *p_set_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	int taken[2][NUM_KINDS] = {}; // Pieces of each kind used up so far by color, black first
+
+	const char *it = p_first;
+	game::Piece *piece_ptr = nullptr;
+
+	for (int i = BOARD_ROWS - 1; i >= 0; --i)
+	{
+		int j = 0;
+
+		while (j < BOARD_COLS)
+		{
+			if (it == p_last)
+				return false;
+
+			if (*it >= '1' && *it <= '9')
+			{
+				j += *it++ - '0';
+				continue;
+			}
+
+			if (*it != '(')
+			{
+				if ((it = Notation::readPiece(it, p_last, piece_ptr, p_set_ptr, taken)) == nullptr)
+					return false;
+
+				p_board_ptr->setPiecePtr(piece_ptr, j++, i);
+				continue;
+			}
+
+			int height = 0;
+
+			for (++it; it != p_last && *it != ')'; ++height)
+			{
+				if (height == MAX_HEIGHT || (it = Notation::readPiece(it, p_last, piece_ptr, p_set_ptr, taken)) == nullptr)
+					return false;
+
+				p_board_ptr->setPiecePtr(piece_ptr, j, i);
+			}
+
+			if (it == p_last || height < 2)
+				return false;
+
+			++it;
+			++j;
+		}
+
+		if (j != BOARD_COLS)
+			return false;
+
+		if (i > 0 && (it == p_last || *it++ != '/'))
+			return false;
+	}
+
+	if (it == p_last || *it++ != ' ')
+		return false;
+
+	if ((it = Notation::readHand(it, p_last, p_black_hand_ptr, p_set_ptr, taken)) == nullptr || it == p_last || *it++ != '/')
+		return false;
+
+	if ((it = Notation::readHand(it, p_last, p_white_hand_ptr, p_set_ptr, taken)) == nullptr || it == p_last || *it++ != ' ')
+		return false;
+
+	if (p_last - it < 2 || (it[0] != 'b' && it[0] != 'w') || it[1] != ' ')
+		return false;
+
+	bool black = (it[0] == 'b');
+	it += 2;
+
+	std::from_chars_result result = std::from_chars(it, p_last, p_turn_ref);
+
+	// Side to move must agree with turn
+	if (result.ec != std::errc() || p_turn_ref < 1 || (p_turn_ref % 2 == 1) != black)
+		return false;
+
+	it = result.ptr;
+
+	if (it == p_last || *it++ != ' ' || it == p_last)
+		return false;
+
+	if (*it == '-')
+		return (it + 1 == p_last);
+
+	while (true)
+	{
+		int x = 0;
+		int y = 0;
+		int turn = 0;
+
+		if ((it = Notation::readSquare(it, p_last, x, y)) == nullptr || it == p_last || *it++ != ':')
+			return false;
+
+		result = std::from_chars(it, p_last, turn);
+
+		if (result.ec != std::errc())
+			return false;
+
+		p_board_ptr->getExchangesRef().push_back({ p_board_ptr->getSquarePtr(x, y), turn });
+
+		it = result.ptr;
+
+		if (it == p_last)
+			return true;
+
+		if (*it++ != ',')
+			return false;
+	}
+}
+
+// Returns index of kind of specified piece, whichever side is up
+int Notation::getKind(game::Piece *p_piece_ptr)
+{
+	return KIND_INDICES[p_piece_ptr->getID() - p_piece_ptr->getColor()];
+}
+
+// Returns letter of kind of specified piece, whichever side is up
+char Notation::getLetter(game::Piece *p_piece_ptr)
+{
+	return KINDS[Notation::getKind(p_piece_ptr)].letter;
+}
+
+char* Notation::writeSquare(char *p_first, int x, int y)
+{
+	*p_first++ = static_cast<char>('a' + x);
+	*p_first++ = static_cast<char>('1' + y);
+
+	return p_first;
+}
+
+// Returns end of square, or null if there is none
+const char* Notation::readSquare(const char *p_first, const char *p_last, int &x, int &y)
+{
+	if (p_last - p_first < 2)
+		return nullptr;
+
+	if (p_first[0] < 'a' || p_first[0] >= 'a' + BOARD_COLS || p_first[1] < '1' || p_first[1] >= '1' + BOARD_ROWS)
+		return nullptr;
+
+	x = p_first[0] - 'a';
+	y = p_first[1] - '1';
+
+	return p_first + 2;
+}
+
+char* Notation::writePiece(char *p_first, game::Piece *p_piece_ptr)
+{
+	if (p_piece_ptr->getSide() == game::Piece::BACK)
+		*p_first++ = '+';
+
+	char letter = Notation::getLetter(p_piece_ptr);
+	*p_first++ = (p_piece_ptr->getColor() == game::Piece::WHITE ? static_cast<char>(std::tolower(letter)) : letter);
+
+	return p_first;
+}
+
+// Takes next unused piece of written kind from set, returning end of it, or null if there is none
+const char* Notation::readPiece(const char *p_first, const char *p_last, game::Piece *&p_piece_ref, Set *p_set_ptr, int p_taken[][NUM_KINDS])
+{
+	bool back = (p_first != p_last && *p_first == '+');
+
+	if (back)
+		++p_first;
+
+	if (p_first == p_last)
+		return nullptr;
+
+	game::Piece::Color color = (std::islower(static_cast<unsigned char>(*p_first)) ? game::Piece::WHITE : game::Piece::BLACK);
+	char letter = static_cast<char>(std::toupper(static_cast<unsigned char>(*p_first)));
+
+	for (int i = 0; i < NUM_KINDS; ++i)
+	{
+		if (KINDS[i].letter != letter)
+			continue;
+
+		int &taken_ref = p_taken[color == game::Piece::WHITE ? 1 : 0][i];
+
+		if (taken_ref == KINDS[i].count)
+			return nullptr;
+
+		p_piece_ref = p_set_ptr->getPiecePtr(KINDS[i].first + taken_ref++ + color);
+
+		if (back)
+			p_piece_ref = p_piece_ref->getFlippedPtr();
+
+		return p_first + 1;
+	}
+
+	return nullptr;
+}
+
+// Pieces are counted by kind, color, and side up, so that same hand is always written same regardless of its arrangement
+char* Notation::writeHand(char *p_first, Hand *p_hand_ptr)
+{
+	int counts[NUM_KINDS][2][2] = {}; // By kind, color, and side up, black and front first
+	bool empty = true;
+
+	for (int i = 0; i < HAND_ROWS; ++i)
+	{
+		for (int j = 0; j < HAND_COLS; ++j)
+		{
+			for (auto &elem : p_hand_ptr->getStackRef(j, i))
+			{
+				++counts[Notation::getKind(elem)][elem->getColor() == game::Piece::WHITE ? 1 : 0][elem->getSide() == game::Piece::BACK ? 1 : 0];
+				empty = false;
+			}
+		}
+	}
+
+	if (empty)
+	{
+		*p_first++ = '-';
+		return p_first;
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		for (int j = 0; j < 2; ++j)
+		{
+			for (int k = 0; k < NUM_KINDS; ++k)
+			{
+				int count = counts[k][i][j];
+
+				if (count == 0)
+					continue;
+
+				if (count > 1)
+					*p_first++ = static_cast<char>('0' + count);
+
+				if (j == 1)
+					*p_first++ = '+';
+
+				*p_first++ = (i == 1 ? static_cast<char>(std::tolower(KINDS[k].letter)) : KINDS[k].letter);
+			}
+		}
+	}
+
+	return p_first;
+}
+
+// Pieces must be aligned with hand holding them
+const char* Notation::readHand(const char *p_first, const char *p_last, Hand *p_hand_ptr, Set *p_set_ptr, int p_taken[][NUM_KINDS])
+{
+	if (p_first != p_last && *p_first == '-')
+		return p_first + 1;
+
+	game::Piece *piece_ptr = nullptr;
+	const char *it = p_first;
+
+	while (it != p_last && *it != '/' && *it != ' ')
+	{
+		int count = 1;
+
+		if (*it >= '1' && *it <= '9')
+			count = *it++ - '0';
+
+		const char *end = nullptr;
+
+		for (int i = 0; i < count; ++i)
+		{
+			if ((end = Notation::readPiece(it, p_last, piece_ptr, p_set_ptr, p_taken)) == nullptr)
+				return nullptr;
+
+			if (piece_ptr->getAlignment() != p_hand_ptr->getColor())
+				return nullptr;
+
+			p_hand_ptr->add(piece_ptr);
+		}
+
+		it = end;
+	}
+
+	// Hand must not be empty unless written as such
+	return (it != p_first ? it : nullptr);
+}
@@ -0,0 +1,177 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Perft.cpp
+ * 
+ * Summary:	Counts leaves of the legal move tree to a given depth, broken
+ *		down by the kind of action reaching them, for measuring and
+ *		verifying move generation
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Perft.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+// Class functions
+// ---------------
+// Constructor
+Perft::Perft()
+{
+	this->setThreads(std::thread::hardware_concurrency());
+}
+
+// Member functions
+// ----------------
+void Perft::Counts::add(const Counts &p_counts_ref)
+{
+	this->nodes += p_counts_ref.nodes;
+
+	for (int i = 0; i < NUM_FUNCTIONS; ++i)
+		this->functions[i] += p_counts_ref.functions[i];
+
+	this->rearrangements += p_counts_ref.rearrangements;
+}
+
+// Counts leaves at specified depth of position with specified turn to act
+Perft::Counts Perft::count(Player *p_player_ptr, int p_depth, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	Counts counts;
+
+	if (p_depth <= 0)
+	{
+		counts.nodes = 1;
+		return counts;
+	}
+
+	for (auto &elem : this->divide(p_player_ptr, p_depth, p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr))
+		counts.add(elem.counts);
+
+	return counts;
+}
+
+// Counts leaves beneath each action from root, which are split among threads
+// Positions are not tracked for repetition, so stalemate does not end any branch
+std::vector<Perft::Division> Perft::divide(Player *p_player_ptr, int p_depth, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	std::vector<Division> divisions;
+
+	if (p_depth <= 0)
+		return divisions;
+
+	for (auto &elem : p_player_ptr->getMoves(p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr))
+		divisions.push_back({ elem, this->rearranged(elem, p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr) });
+
+	std::atomic<unsigned int> next(0);
+
+	// Threads take whichever root action is next, since subtrees vary greatly in size
+	// Each searches upon copies onto context of its own, so that none count into nor remember within that of another
+	auto work = [&]()
+	{
+		Context context;
+
+		for (unsigned int i = next++; i < divisions.size(); i = next++)
+		{
+			Division &division = divisions[i];
+
+			if (p_depth == 1)
+			{
+				division.counts.nodes = 1;
+				division.counts.functions[division.move.func] = 1;
+				division.counts.rearrangements = (division.rearranged ? 1 : 0);
+
+				continue;
+			}
+
+			Board temp_board(*p_board_ptr, &context);
+
+			Hand temp_active_hand(*p_active_hand_ptr, &context);
+			Hand temp_passive_hand(*p_passive_hand_ptr, &context);
+
+			p_player_ptr->actSim(division.move, p_turn, &temp_active_hand, &temp_passive_hand, &temp_board);
+			this->search(division.counts, p_player_ptr, p_depth - 1, p_turn + 1, &temp_passive_hand, &temp_active_hand, &temp_board);
+		}
+	};
+
+	std::vector<std::thread> threads;
+
+	for (int i = 1; i < std::min(this->m_threads, static_cast<int>(divisions.size())); ++i)
+		threads.push_back(std::thread(work));
+
+	work();
+
+	for (auto &elem : threads)
+		elem.join();
+
+	return divisions;
+}
+
+void Perft::search(Counts &p_counts_ref, Player *p_player_ptr, int p_depth, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	std::vector<Player::Move> moves = p_player_ptr->getMoves(p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr);
+
+	// Leaves are counted in bulk without being acted upon
+	if (p_depth == 1)
+	{
+		p_counts_ref.nodes += moves.size();
+
+		bool rear = false;
+
+		for (unsigned int i = 0; i < moves.size(); ++i)
+		{
+			++p_counts_ref.functions[moves[i].func];
+
+			// Rearrangements of same strike are generated consecutively, so it need only be checked once
+			bool same = (i > 0 && moves[i].func == moves[i - 1].func && moves[i].src.x == moves[i - 1].src.x && moves[i].src.y == moves[i - 1].src.y && moves[i].src.z == moves[i - 1].src.z && moves[i].dest.x == moves[i - 1].dest.x && moves[i].dest.y == moves[i - 1].dest.y);
+
+			if (!same)
+				rear = this->rearranged(moves[i], p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr);
+
+			if (rear)
+				++p_counts_ref.rearrangements;
+		}
+
+		return;
+	}
+
+	for (auto &elem : moves)
+	{
+		Board temp_board = *p_board_ptr;
+
+		Hand temp_active_hand = *p_active_hand_ptr;
+		Hand temp_passive_hand = *p_passive_hand_ptr;
+
+		p_player_ptr->actSim(elem, p_turn, &temp_active_hand, &temp_passive_hand, &temp_board);
+		this->search(p_counts_ref, p_player_ptr, p_depth - 1, p_turn + 1, &temp_passive_hand, &temp_active_hand, &temp_board);
+	}
+}
+
+// Determines if strike is followed by rearrangement
+bool Perft::rearranged(const Player::Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	switch (p_move_ref.func)
+	{
+	case Player::STRIKE:
+		return p_board_ptr->rearrangeableLat(p_move_ref.src.x, p_move_ref.src.y, p_move_ref.dest.x, p_move_ref.dest.y, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+
+	case Player::DOWN:
+		return p_board_ptr->rearrangeableVert(p_move_ref.src.x, p_move_ref.src.y, p_move_ref.src.z, p_move_ref.src.z - 1, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+
+	case Player::UP:
+		return p_board_ptr->rearrangeableVert(p_move_ref.src.x, p_move_ref.src.y, p_move_ref.src.z, p_move_ref.src.z + 1, p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+
+	default:
+		return false;
+	}
+}
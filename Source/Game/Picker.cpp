@@ -0,0 +1,281 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Picker.cpp
+ * 
+ * Summary:	Yields legal actions of a position one at a time in stages, most
+ *		likely to cause cutoffs first, so that search stopping early does
+ *		not pay for determining legality of the rest
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Picker.h"
+
+// Class functions
+// ---------------
+// Constructor
+Picker::Picker(Player *p_player_ptr, Player::Ply *p_ply_ptr, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	this->m_stage = KILLERS;
+
+	// Buffers were last used by sibling, so only their capacity is kept
+	p_ply_ptr->candidates = p_ply_ptr->killers;
+	p_ply_ptr->quiet.clear();
+	p_ply_ptr->rearranging.clear();
+	p_ply_ptr->yielded.clear();
+
+	this->m_index = 0;
+
+	this->m_turn = p_turn;
+
+	this->m_player_ptr = p_player_ptr;
+	this->m_ply_ptr = p_ply_ptr;
+
+	this->m_active_hand_ptr = p_active_hand_ptr;
+	this->m_passive_hand_ptr = p_passive_hand_ptr;
+
+	this->m_board_ptr = p_board_ptr;
+}
+
+// Member functions
+// ----------------
+// Yields next legal action, determining its legality only once pulled
+// Altogether, the same actions are yielded as are listed by Player::getMoves
+bool Picker::next(Player::Move &p_move_ref)
+{
+	while (this->m_stage != DONE)
+	{
+		while (this->m_index < this->m_ply_ptr->candidates.size())
+		{
+			Player::Word word = this->m_ply_ptr->candidates[this->m_index++];
+
+			p_move_ref = Player::unpack(word);
+
+			if (this->legal(word, p_move_ref))
+				return true;
+		}
+
+		this->m_stage = static_cast<Stage>(this->m_stage + 1);
+		this->generate();
+	}
+
+	return false;
+}
+
+// Lists candidates of current stage, which may yet prove illegal
+void Picker::generate()
+{
+	Player::Ply &ply_ref = *this->m_ply_ptr;
+
+	ply_ref.candidates.clear();
+	this->m_index = 0;
+
+	switch (this->m_stage)
+	{
+	case STRIKES:
+		for (int i = 0; i < BOARD_ROWS; ++i)
+		{
+			for (int j = 0; j < BOARD_COLS; ++j)
+			{
+				if (this->m_board_ptr->selectable(j, i, this->m_turn))
+				{
+					ply_ref.targets.clear();
+					this->m_board_ptr->getMoves(j, i, ply_ref.targets);
+
+					for (auto &elem : ply_ref.targets)
+					{
+						if (!this->m_board_ptr->moveable(j, i, elem.x, elem.y))
+							continue;
+
+						if (this->m_board_ptr->getHeight(elem.x, elem.y))
+							ply_ref.candidates.push_back(Player::pack({ Player::STRIKE, { j, i }, { elem.x, elem.y } }));
+
+						ply_ref.quiet.push_back(Player::pack({ Player::MOVE, { j, i }, { elem.x, elem.y } }));
+					}
+				}
+
+				int height = this->m_board_ptr->getHeight(j, i);
+
+				if (height < 2)
+					continue;
+
+				for (int k = 0; k < height; ++k)
+				{
+					if (k > 0)
+						ply_ref.candidates.push_back(Player::pack({ Player::DOWN, { j, i, k } }));
+
+					if (k < height - 1)
+						ply_ref.candidates.push_back(Player::pack({ Player::UP, { j, i, k } }));
+				}
+			}
+		}
+
+		break;
+
+	case MOVES:
+		std::swap(ply_ref.candidates, ply_ref.quiet);
+		break;
+
+	case DROPS:
+		// Drops are determined together, as that is far cheaper than one at a time
+		for (auto &elem : this->m_board_ptr->getDrops(this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr))
+		{
+			game::Square *square_ptr = this->m_active_hand_ptr->getSquarePtr(elem.piece_ptr);
+
+			if (!square_ptr)
+				continue;
+
+			for (int i = 0; i < BOARD_ROWS; ++i)
+			{
+				for (int j = 0; j < BOARD_COLS; ++j)
+				{
+					if (elem.squares[j + i * BOARD_COLS])
+						ply_ref.candidates.push_back(Player::pack({ Player::SET, { square_ptr->getX(), square_ptr->getY() }, { j, i } }));
+				}
+			}
+		}
+
+		break;
+
+	case OTHERS:
+		for (int i = 0; i < BOARD_ROWS; ++i)
+		{
+			for (int j = 0; j < BOARD_COLS; ++j)
+			{
+				if (this->m_board_ptr->getHeight(j, i) == MAX_HEIGHT)
+					ply_ref.candidates.push_back(Player::pack({ Player::EXCHANGE, { j, i } }));
+
+				else if (this->m_board_ptr->getHeight(j, i) == 1)
+					ply_ref.candidates.push_back(Player::pack({ Player::SUBSTITUTE, { j, i } }));
+			}
+		}
+
+		break;
+
+	case REARRANGEMENTS:
+		for (auto &elem : ply_ref.rearranging)
+		{
+			ply_ref.expansions.clear();
+			this->m_player_ptr->genRearrangements(Player::unpack(elem), ply_ref.expansions, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr, this->m_board_ptr);
+
+			for (auto &expansion : ply_ref.expansions)
+				ply_ref.candidates.push_back(Player::pack(expansion));
+		}
+
+		break;
+
+	default:
+		break;
+	}
+}
+
+// Determines if candidate of current stage is legal, setting aside strikes followed by rearrangement
+bool Picker::legal(Player::Word p_word, const Player::Move &p_move_ref)
+{
+	int x = p_move_ref.src.x;
+	int y = p_move_ref.src.y;
+	int z = p_move_ref.src.z;
+
+	switch (this->m_stage)
+	{
+	case KILLERS:
+		if (!this->valid(p_move_ref))
+			return false;
+
+		this->m_ply_ptr->yielded.push_back(p_word);
+		return true;
+
+	case STRIKES:
+		if (p_move_ref.func == Player::STRIKE)
+		{
+			if (!this->m_board_ptr->strikeable(x, y, p_move_ref.dest.x, p_move_ref.dest.y, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr))
+				return false;
+
+			if (!this->m_board_ptr->rearrangeableLat(x, y, p_move_ref.dest.x, p_move_ref.dest.y, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr))
+				return true;
+		}
+
+		else
+		{
+			int z2 = (p_move_ref.func == Player::DOWN ? z - 1 : z + 1);
+
+			if (p_move_ref.func == Player::DOWN ? !this->m_board_ptr->downwards(x, y, z, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr) : !this->m_board_ptr->upwards(x, y, z, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr))
+				return false;
+
+			if (!this->m_board_ptr->rearrangeableVert(x, y, z, z2, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr))
+				return true;
+		}
+
+		this->m_ply_ptr->rearranging.push_back(p_word);
+		return false;
+
+	case MOVES:
+		return (!this->yielded(p_word) && this->m_board_ptr->moveable(x, y, p_move_ref.dest.x, p_move_ref.dest.y, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr));
+
+	case DROPS:
+		return !this->yielded(p_word);
+
+	case OTHERS:
+		if (p_move_ref.func == Player::EXCHANGE)
+			return this->m_board_ptr->exchangeable(x, y, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr);
+
+		return this->m_board_ptr->substitutable(x, y, this->m_turn);
+
+	default:
+		return true;
+	}
+}
+
+// Determines if killer move from another position is legal in this one
+// Only moves and drops are kept as killer moves, as strikes are tried early regardless
+bool Picker::valid(const Player::Move &p_move_ref)
+{
+	int x1 = p_move_ref.src.x;
+	int y1 = p_move_ref.src.y;
+
+	int x2 = p_move_ref.dest.x;
+	int y2 = p_move_ref.dest.y;
+
+	if (p_move_ref.func == Player::SET)
+	{
+		if (this->m_active_hand_ptr->getStackRef(x1, y1).empty())
+			return false;
+
+		return this->m_board_ptr->droppable(this->m_active_hand_ptr->getPiecePtr(x1, y1), x2, y2, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr);
+	}
+
+	if (p_move_ref.func != Player::MOVE || !this->m_board_ptr->selectable(x1, y1, this->m_turn))
+		return false;
+
+	this->m_ply_ptr->targets.clear();
+	this->m_board_ptr->getMoves(x1, y1, this->m_ply_ptr->targets);
+
+	for (auto &elem : this->m_ply_ptr->targets)
+	{
+		if (elem.x == x2 && elem.y == y2)
+			return (this->m_board_ptr->moveable(x1, y1, x2, y2) && this->m_board_ptr->moveable(x1, y1, x2, y2, this->m_turn, this->m_active_hand_ptr, this->m_passive_hand_ptr));
+	}
+
+	return false;
+}
+
+// Determines if specified action was already yielded as killer move
+bool Picker::yielded(Player::Word p_word)
+{
+	for (auto &elem : this->m_ply_ptr->yielded)
+	{
+		if (elem == p_word)
+			return true;
+	}
+
+	return false;
+}
@@ -20,7 +20,7 @@
 
 // Member functions
 // ----------------
-void game::Piece::build(int p_ID, Face p_front, Face p_back, Color p_color)
+void game::Piece::build(int p_ID, Face p_front, Face p_back, Color p_color, Side p_side, Piece *p_flipped_ptr)
 {
 	this->m_ID = p_ID;
 
@@ -28,6 +28,10 @@ void game::Piece::build(int p_ID, Face p_front, Face p_back, Color p_color)
 	this->m_back = p_back;
 
 	this->m_color = p_color;
+
+	this->m_side = p_side;
+
+	this->m_flipped_ptr = p_flipped_ptr;
 }
 
 bool game::Piece::shallowEquals(Piece *p_piece_ptr)
@@ -58,7 +62,8 @@ bool game::Piece::equals(Piece *p_piece_ptr)
 	return true;
 }
 
-int game::Piece::getWeight()
+// Returns index of weight corresponding to face currently up
+int game::Piece::getWeightIndex()
 {
 	Face face = this->getSideUp();
 
@@ -66,28 +71,25 @@ int game::Piece::getWeight()
 	static int lance_offset = FORTRESS - CATAPULT;
 
 	if (face < PAWN)
-		return WEIGHTS[face];
+		return face;
 
 	if (face == PAWN)
-		return WEIGHTS[face + this->getBack() - BRONZE];
+		return face + this->getBack() - BRONZE;
 
 	if (face > PAWN && face < LANCE)
-		return WEIGHTS[face + pawn_offset];
+		return face + pawn_offset;
 
 	if (face == LANCE)
-		return WEIGHTS[face + pawn_offset + this->getFront() - CATAPULT];
+		return face + pawn_offset + this->getFront() - CATAPULT;
 
 	if (face > LANCE)
-		return WEIGHTS[face + pawn_offset + lance_offset];
+		return face + pawn_offset + lance_offset;
 
 	return 0;
 }
 
-std::vector<Move> game::Piece::getMoves(int x, int y, int z)
+void game::Piece::getMoves(std::vector<Move> &p_moves_ref, int x, int y, int z)
 {
-	std::vector<Move> moves;
-	std::vector<Move> temp;
-
 	int mod = (this->getAlignment() == WHITE ? -1 : 1);
 
 	switch (this->getSideUp())
@@ -96,59 +98,55 @@ std::vector<Move> game::Piece::getMoves(int x, int y, int z)
 		break;
 
 	case COMMANDER:
-		temp = this->getDiagonalMoves(x, y);
-		moves.insert(moves.end(), temp.begin(), temp.end());
-
-		temp = this->getOrthogonalMoves(x, y);
-		moves.insert(moves.end(), temp.begin(), temp.end());
+		this->addDiagonalMoves(p_moves_ref, x, y);
+		this->addOrthogonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case CAPTAIN:
-		temp = this->getDiagonalMoves(x, y);
-		moves.insert(moves.end(), temp.begin(), temp.end());
+		this->addDiagonalMoves(p_moves_ref, x, y);
 
 		if (z == 0 || z == 1)
-			this->addMove(moves, x, y - 1 * mod);
+			this->addMove(p_moves_ref, x, y - 1 * mod);
 
 		if (z == 1)
-			this->addMove(moves, x, y + 1 * mod);
+			this->addMove(p_moves_ref, x, y + 1 * mod);
 
 		if (z == 2)
 		{
-			this->addMove(moves, x - 2, y - 2 * mod);
-			this->addMove(moves, x + 2, y - 2 * mod);
-			this->addMove(moves, x - 2, y);
-			this->addMove(moves, x + 2, y);
+			this->addMove(p_moves_ref, x - 2, y - 2 * mod);
+			this->addMove(p_moves_ref, x + 2, y - 2 * mod);
+			this->addMove(p_moves_ref, x - 2, y);
+			this->addMove(p_moves_ref, x + 2, y);
 		}
 
 		break;
 
 	case SAMURAI:
-		this->addMove(moves, x - 1, y - 1 * mod);
-		this->addMove(moves, x + 1, y - 1 * mod);
-		this->addMove(moves, x - 1, y);
-		this->addMove(moves, x + 1, y);
+		this->addMove(p_moves_ref, x - 1, y - 1 * mod);
+		this->addMove(p_moves_ref, x + 1, y - 1 * mod);
+		this->addMove(p_moves_ref, x - 1, y);
+		this->addMove(p_moves_ref, x + 1, y);
 
 		if (z == 0)
-			this->addMove(moves, x, y - 1 * mod);
+			this->addMove(p_moves_ref, x, y - 1 * mod);
 
 		else
 		{
-			this->addMove(moves, x, y - 2);
-			this->addMove(moves, x, y + 2);
+			this->addMove(p_moves_ref, x, y - 2);
+			this->addMove(p_moves_ref, x, y + 2);
 		}
 
 		break;
 
 	case SPY:
-		this->addMove(moves, x - 1, y - 2 * mod);
-		this->addMove(moves, x + 1, y - 2 * mod);
+		this->addMove(p_moves_ref, x - 1, y - 2 * mod);
+		this->addMove(p_moves_ref, x + 1, y - 2 * mod);
 
 		if (z == 1 || z == 2)
 		{
-			this->addMove(moves, x - 1, y - 1 * mod);
-			this->addMove(moves, x + 1, y - 1 * mod);
+			this->addMove(p_moves_ref, x - 1, y - 1 * mod);
+			this->addMove(p_moves_ref, x + 1, y - 1 * mod);
 		}
 
 		break;
@@ -161,128 +159,106 @@ std::vector<Move> game::Piece::getMoves(int x, int y, int z)
 
 	case HIDDEN_DRAGON:
 		if (z == 0)
-		{
-			temp = this->getExtendedOrthogonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addExtendedOrthogonalMoves(p_moves_ref, x, y);
 
 		else
-		{
-			temp = this->getDiagonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addDiagonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case PRODIGY:
 		if (z == 0)
-		{
-			temp = this->getExtendedDiagonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addExtendedDiagonalMoves(p_moves_ref, x, y);
 
 		else
-		{
-			temp = this->getOrthogonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addOrthogonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case BOW:
 		if (z == 0 || z == 2)
 		{
-			this->addMove(moves, x - 2, y);
-			this->addMove(moves, x + 2, y);
+			this->addMove(p_moves_ref, x - 2, y);
+			this->addMove(p_moves_ref, x + 2, y);
 		}
 
 		if (z == 1 || z == 2)
 		{
-			this->addMove(moves, x - 2, y - 2 * mod);
-			this->addMove(moves, x + 2, y - 2 * mod);
+			this->addMove(p_moves_ref, x - 2, y - 2 * mod);
+			this->addMove(p_moves_ref, x + 2, y - 2 * mod);
 		}
 
 		if (z == 0)
-			this->addMove(moves, x, y - 2 * mod);
+			this->addMove(p_moves_ref, x, y - 2 * mod);
 
 		if (z == 1)
 		{
-			this->addMove(moves, x, y - 1);
-			this->addMove(moves, x, y + 1);
+			this->addMove(p_moves_ref, x, y - 1);
+			this->addMove(p_moves_ref, x, y + 1);
 		}
 
 		if (z == 2)
-			this->addMove(moves, x, y + 2 * mod);
+			this->addMove(p_moves_ref, x, y + 2 * mod);
 
 		break;
 
 	case PAWN:
 		if (z == 0 || z == 1)
-			this->addMove(moves, x, y - 1 * mod);
+			this->addMove(p_moves_ref, x, y - 1 * mod);
 
 		if (z == 1 || z == 2)
 		{
-			this->addMove(moves, x - 2, y);
-			this->addMove(moves, x + 2, y);
+			this->addMove(p_moves_ref, x - 2, y);
+			this->addMove(p_moves_ref, x + 2, y);
 		}
 
 		if (z == 2)
 		{
-			this->addMove(moves, x - 1, y - 1 * mod);
-			this->addMove(moves, x + 1, y - 1 * mod);
+			this->addMove(p_moves_ref, x - 1, y - 1 * mod);
+			this->addMove(p_moves_ref, x + 1, y - 1 * mod);
 		}
 
 		break;
 
 	case PISTOL:
 		if (z == 0)
-		{
-			temp = this->getDiagonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addDiagonalMoves(p_moves_ref, x, y);
 
 		else
-		{
-			temp = this->getOrthogonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addOrthogonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case PIKE:
 		if (z == 0)
 		{
-			temp = this->getOrthogonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
+			this->addOrthogonalMoves(p_moves_ref, x, y);
 
-			this->addMove(moves, x, y - 2 * mod);
+			this->addMove(p_moves_ref, x, y - 2 * mod);
 		}
 
 		else
-		{
-			temp = this->getDiagonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addDiagonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case CLANDESTINITE:
-		this->addMove(moves, x - 1, y - 2 * mod);
-		this->addMove(moves, x + 1, y - 2 * mod);
-		this->addMove(moves, x, y + 1 * mod);
+		this->addMove(p_moves_ref, x - 1, y - 2 * mod);
+		this->addMove(p_moves_ref, x + 1, y - 2 * mod);
+		this->addMove(p_moves_ref, x, y + 1 * mod);
 
 		if (z == 1 || z == 2)
 		{
-			this->addMove(moves, x - 1, y - 1 * mod);
-			this->addMove(moves, x + 1, y - 1 * mod);
+			this->addMove(p_moves_ref, x - 1, y - 1 * mod);
+			this->addMove(p_moves_ref, x + 1, y - 1 * mod);
 		}
 
 		if (z == 2)
 		{
-			this->addMove(moves, x - 2, y + 2 * mod);
-			this->addMove(moves, x - 1, y + 2 * mod);
-			this->addMove(moves, x + 1, y + 2 * mod);
-			this->addMove(moves, x + 2, y + 2 * mod);
+			this->addMove(p_moves_ref, x - 2, y + 2 * mod);
+			this->addMove(p_moves_ref, x - 1, y + 2 * mod);
+			this->addMove(p_moves_ref, x + 1, y + 2 * mod);
+			this->addMove(p_moves_ref, x + 2, y + 2 * mod);
 		}
 
 		break;
@@ -293,182 +269,141 @@ std::vector<Move> game::Piece::getMoves(int x, int y, int z)
 			if (this->getAlignment() == BLACK)
 			{
 				for (int i = y - 1; i >= 0; --i)
-					moves.push_back({ x, i });
+					p_moves_ref.push_back({ x, i });
 			}
 
 			else if (this->getAlignment() == WHITE)
 			{
 				for (int i = y + 1; i <= 8; ++i)
-					moves.push_back({ x, i });
+					p_moves_ref.push_back({ x, i });
 			}
 		}
 
 		else
-		{
-			temp = this->getDiagonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addDiagonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case DRAGON_KING:
-		temp = this->getDiagonalMoves(x, y);
-		moves.insert(moves.end(), temp.begin(), temp.end());
+		this->addDiagonalMoves(p_moves_ref, x, y);
 
 		if (z == 0)
-		{
-			temp = this->getExtendedOrthogonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addExtendedOrthogonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case PHOENIX:
-		temp = this->getOrthogonalMoves(x, y);
-		moves.insert(moves.end(), temp.begin(), temp.end());
+		this->addOrthogonalMoves(p_moves_ref, x, y);
 
 		if (z == 0)
-		{
-			temp = this->getExtendedDiagonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addExtendedDiagonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case ARROW:
-		this->addMove(moves, x, y - 1);
-		this->addMove(moves, x, y + 1);
+		this->addMove(p_moves_ref, x, y - 1);
+		this->addMove(p_moves_ref, x, y + 1);
 
 		if (z == 0 || z == 2)
 		{
-			this->addMove(moves, x - 1, y + 1 * mod);
-			this->addMove(moves, x + 1, y + 1 * mod);
+			this->addMove(p_moves_ref, x - 1, y + 1 * mod);
+			this->addMove(p_moves_ref, x + 1, y + 1 * mod);
 		}
 
 		if (z == 1 || z == 2)
 		{
-			this->addMove(moves, x - 2, y + 2 * mod);
-			this->addMove(moves, x + 2, y + 2 * mod);
+			this->addMove(p_moves_ref, x - 2, y + 2 * mod);
+			this->addMove(p_moves_ref, x + 2, y + 2 * mod);
 		}
 
 		break;
 
 	case BRONZE:
-		this->addMove(moves, x - 1, y);
-		this->addMove(moves, x + 1, y);
+		this->addMove(p_moves_ref, x - 1, y);
+		this->addMove(p_moves_ref, x + 1, y);
 
 		break;
 
 	case SILVER:
 		if (z == 0)
-		{
-			temp = this->getOrthogonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addOrthogonalMoves(p_moves_ref, x, y);
 
 		else
-		{
-			temp = this->getDiagonalMoves(x, y);
-			moves.insert(moves.end(), temp.begin(), temp.end());
-		}
+			this->addDiagonalMoves(p_moves_ref, x, y);
 
 		break;
 
 	case GOLD:
-		temp = this->getGoldMoves(x, y);
-		moves.insert(moves.end(), temp.begin(), temp.end());
+		this->getGoldMoves(p_moves_ref, x, y);
 
 		break;
 	}
-
-	return moves;
 }
 
-std::vector<Move> game::Piece::getGoldMoves(int x, int y)
+void game::Piece::getGoldMoves(std::vector<Move> &p_moves_ref, int x, int y)
 {
-	std::vector<Move> moves;
-	std::vector<Move> temp = this->getOrthogonalMoves(x, y);
-
 	int mod = (this->getAlignment() == WHITE ? -1 : 1);
 
-	moves.insert(moves.end(), temp.begin(), temp.end());
+	this->addOrthogonalMoves(p_moves_ref, x, y);
 
-	this->addMove(moves, x - 1, y - 1 * mod);
-	this->addMove(moves, x + 1, y - 1 * mod);
-
-	return moves;
+	this->addMove(p_moves_ref, x - 1, y - 1 * mod);
+	this->addMove(p_moves_ref, x + 1, y - 1 * mod);
 }
 
-std::vector<Move> game::Piece::getDiagonalMoves(int x, int y)
+void game::Piece::addDiagonalMoves(std::vector<Move> &p_moves_ref, int x, int y)
 {
-	std::vector<Move> moves;
-
-	this->addMove(moves, x - 1, y - 1);
-	this->addMove(moves, x + 1, y - 1);
-	this->addMove(moves, x - 1, y + 1);
-	this->addMove(moves, x + 1, y + 1);
-
-	return moves;
+	this->addMove(p_moves_ref, x - 1, y - 1);
+	this->addMove(p_moves_ref, x + 1, y - 1);
+	this->addMove(p_moves_ref, x - 1, y + 1);
+	this->addMove(p_moves_ref, x + 1, y + 1);
 }
 
-std::vector<Move> game::Piece::getOrthogonalMoves(int x, int y)
+void game::Piece::addOrthogonalMoves(std::vector<Move> &p_moves_ref, int x, int y)
 {
-	std::vector<Move> moves;
-
-	this->addMove(moves, x, y - 1);
-	this->addMove(moves, x - 1, y);
-	this->addMove(moves, x + 1, y);
-	this->addMove(moves, x, y + 1);
-
-	return moves;
+	this->addMove(p_moves_ref, x, y - 1);
+	this->addMove(p_moves_ref, x - 1, y);
+	this->addMove(p_moves_ref, x + 1, y);
+	this->addMove(p_moves_ref, x, y + 1);
 }
 
-std::vector<Move> game::Piece::getExtendedDiagonalMoves(int x, int y)
+void game::Piece::addExtendedDiagonalMoves(std::vector<Move> &p_moves_ref, int x, int y)
 {
-	std::vector<Move> moves;
-
 	int i = x - 1;
 	int j = y - 1;
 
 	while (i >= LOWER_BOUND && j >= LOWER_BOUND)
-		moves.push_back({ i--, j-- });
+		p_moves_ref.push_back({ i--, j-- });
 
 	i = x + 1;
 	j = y - 1;
 
 	while (i <= UPPER_BOUND && j >= LOWER_BOUND)
-		moves.push_back({ i++, j-- });
+		p_moves_ref.push_back({ i++, j-- });
 
 	i = x - 1;
 	j = y + 1;
 
 	while (i >= LOWER_BOUND && j <= UPPER_BOUND)
-		moves.push_back({ i--, j++ });
+		p_moves_ref.push_back({ i--, j++ });
 
 	i = x + 1;
 	j = y + 1;
 
 	while (i <= UPPER_BOUND && j <= UPPER_BOUND)
-		moves.push_back({ i++, j++ });
-
-	return moves;
+		p_moves_ref.push_back({ i++, j++ });
 }
 
-std::vector<Move> game::Piece::getExtendedOrthogonalMoves(int x, int y)
+void game::Piece::addExtendedOrthogonalMoves(std::vector<Move> &p_moves_ref, int x, int y)
 {
-	std::vector<Move> moves;
-
 	for (int i = y - 1; i >= LOWER_BOUND; --i)
-		moves.push_back({ x, i });
+		p_moves_ref.push_back({ x, i });
 
 	for (int i = x - 1; i >= LOWER_BOUND; --i)
-		moves.push_back({ i, y });
+		p_moves_ref.push_back({ i, y });
 
 	for (int i = x + 1; i <= UPPER_BOUND; ++i)
-		moves.push_back({ i, y });
+		p_moves_ref.push_back({ i, y });
 
 	for (int i = y + 1; i <= UPPER_BOUND; ++i)
-		moves.push_back({ x, i });
-
-	return moves;
+		p_moves_ref.push_back({ x, i });
 }
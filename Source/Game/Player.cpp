@@ -18,15 +18,19 @@
  */
 
 #include "Game/Player.h"
+#include "Game/MCTS.h"
+#include "Game/Picker.h"
 
 #include <algorithm>
-
-extern int rand(int p_min, int p_max);
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
 
 // Class functions
 // ---------------
 // Constructor
-Player::Player(game::Piece::Color p_color, int *p_turn_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+Player::Player(game::Piece::Color p_color, int *p_turn_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr, MCTS *p_mcts_ptr, NNUE *p_network_ptr, std::default_random_engine *p_RNG_ptr)
 {
 	this->m_color = p_color;
 	
@@ -36,6 +40,11 @@ Player::Player(game::Piece::Color p_color, int *p_turn_ptr, Hand *p_black_hand_p
 	this->m_white_hand_ptr = p_white_hand_ptr;
 
 	this->m_board_ptr = p_board_ptr;
+
+	this->m_mcts_ptr = p_mcts_ptr;
+	this->m_network_ptr = p_network_ptr;
+
+	this->m_RNG_ptr = p_RNG_ptr;
 }
 
 // Member functions
@@ -54,6 +63,11 @@ void Player::eval()
 {
 	this->m_eval = true;
 
+	auto start = std::chrono::steady_clock::now();
+
+	this->m_context.counters.depth = 0;
+	Counters counters = this->m_context.counters;
+
 	if (*this->m_turn_ptr <= INITIAL_ARRANGEMENT)
 	{
 		switch (this->m_level)
@@ -81,56 +95,83 @@ void Player::eval()
 	else
 		this->move();
 
+	// Search threads of tree search are aggregated by it, and the rest is counted within context of player
+	Stats stats;
+
+	stats.counters = this->m_context.counters.since(counters);
+	stats.turn = *this->m_turn_ptr;
+	stats.ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	if (this->m_backend == MONTE_CARLO && *this->m_turn_ptr > INITIAL_ARRANGEMENT)
+		stats.counters.add(this->m_mcts_ptr->getCounters());
+
+	this->m_stats = stats;
+
 	this->m_ready = true;
 }
 
-bool Player::act()
+// Performs one of best actions found by evaluation, passing it back
+bool Player::act(Move &p_move_ref)
 {
 	if (!this->m_ready)
 		return false;
 
+	std::uniform_int_distribution<int> dist(0, this->m_moves.size() - 1);
+
+	p_move_ref = this->m_moves[dist(*this->m_RNG_ptr)];
+	this->play(p_move_ref);
+
+	this->m_eval = false;
+	this->m_ready = false;
+
+	this->m_moves.clear();
+
+	return true;
+}
+
+// Performs specified action on game board and passes turn
+void Player::play(Move p_move)
+{
 	game::Piece::Color active = this->getActiveColor(*this->m_turn_ptr);
 	game::Piece::Color passive = this->getPassiveColor(*this->m_turn_ptr);
 
 	Hand *active_hand_ptr = this->getHandPtr(active);
 	Hand *passive_hand_ptr = this->getHandPtr(passive);
 
-	Move move = this->m_moves[rand(0, this->m_moves.size() - 1)];
-
-	switch (move.func)
+	switch (p_move.func)
 	{
 	case SET:
-		this->m_board_ptr->set(move.src.x, move.src.y, move.dest.x, move.dest.y, active_hand_ptr);
+		this->m_board_ptr->set(p_move.src.x, p_move.src.y, p_move.dest.x, p_move.dest.y, active_hand_ptr);
 		break;
 
 	case MOVE:
-		this->m_board_ptr->move(move.src.x, move.src.y, move.dest.x, move.dest.y, active_hand_ptr);
+		this->m_board_ptr->move(p_move.src.x, p_move.src.y, p_move.dest.x, p_move.dest.y, active_hand_ptr);
 		break;
 
 	case STRIKE:
-		this->m_board_ptr->strike(move.src.x, move.src.y, move.dest.x, move.dest.y, active_hand_ptr, passive_hand_ptr);
-		this->rearrange(active_hand_ptr, move);
+		this->m_board_ptr->strike(p_move.src.x, p_move.src.y, p_move.dest.x, p_move.dest.y, active_hand_ptr, passive_hand_ptr);
+		this->rearrange(active_hand_ptr, p_move);
 
 		break;
 
 	case DOWN:
-		this->m_board_ptr->strikeDown(move.src.x, move.src.y, move.src.z, active_hand_ptr, passive_hand_ptr);
-		this->rearrange(active_hand_ptr, move);
+		this->m_board_ptr->strikeDown(p_move.src.x, p_move.src.y, p_move.src.z, active_hand_ptr, passive_hand_ptr);
+		this->rearrange(active_hand_ptr, p_move);
 
 		break;
 
 	case UP:
-		this->m_board_ptr->strikeUp(move.src.x, move.src.y, move.src.z, active_hand_ptr, passive_hand_ptr);
-		this->rearrange(active_hand_ptr, move);
+		this->m_board_ptr->strikeUp(p_move.src.x, p_move.src.y, p_move.src.z, active_hand_ptr, passive_hand_ptr);
+		this->rearrange(active_hand_ptr, p_move);
 
 		break;
 
 	case EXCHANGE:
-		this->m_board_ptr->exchange(move.src.x, move.src.y, active_hand_ptr);
+		this->m_board_ptr->exchange(p_move.src.x, p_move.src.y, active_hand_ptr);
 		break;
 
 	case SUBSTITUTE:
-		this->m_board_ptr->substitute(move.src.x, move.src.y);
+		this->m_board_ptr->substitute(p_move.src.x, p_move.src.y);
 		break;
 	}
 
@@ -146,13 +187,78 @@ bool Player::act()
 		if (!(this->m_board_ptr->getCheckmateRef(active) = this->m_board_ptr->getCheckRef(active)))
 			this->m_board_ptr->getCheckmateRef(passive) = this->m_board_ptr->checkmate(*this->m_turn_ptr, passive_hand_ptr, active_hand_ptr);
 	}
+}
 
-	this->m_eval = false;
-	this->m_ready = false;
+// Determines if specified action is legal for active color on specified turn, placements included
+// Actions are compared packed, as those of external origin are never scored
+bool Player::legal(Move p_move, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	if (p_turn <= INITIAL_ARRANGEMENT)
+	{
+		if (p_move.func != SET)
+			return false;
 
-	this->m_moves.clear();
+		if (p_move.src.x < 0 || p_move.src.x >= HAND_COLS || p_move.src.y < 0 || p_move.src.y >= HAND_ROWS || p_active_hand_ptr->getHeight(p_move.src.x, p_move.src.y) == 0)
+			return false;
 
-	return true;
+		game::Piece::Color active = this->getActiveColor(p_turn);
+
+		if (p_move.dest.x < 0 || p_move.dest.x >= BOARD_COLS || p_move.dest.y < this->getLowerBound(active) || p_move.dest.y > this->getUpperBound(active))
+			return false;
+
+		return p_board_ptr->placeable(p_active_hand_ptr->getPiecePtr(p_move.src.x, p_move.src.y), p_move.dest.x, p_move.dest.y);
+	}
+
+	Word word = Player::pack(p_move);
+
+	for (auto &elem : this->getMoves(p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr))
+	{
+		if (Player::pack(elem) == word)
+			return true;
+	}
+
+	return false;
+}
+
+// Records material terms of position with result for active color on specified turn
+// Terms are net counts per weight on board followed by those in hand, as read by the tuner
+void Player::writeSample(std::ostream &p_stream_ref, float p_result, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	int board_terms[NUM_WEIGHTS] = {};
+	int hand_terms[NUM_WEIGHTS] = {};
+
+	game::Piece::Color active = this->getActiveColor(p_turn);
+
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			for (auto &elem : p_board_ptr->getStackRef(j, i))
+				board_terms[elem->getWeightIndex()] += (elem->getAlignment() == active ? 1 : -1);
+		}
+	}
+
+	for (int i = 0; i < HAND_ROWS; ++i)
+	{
+		for (int j = 0; j < HAND_COLS; ++j)
+		{
+			for (auto &elem : p_active_hand_ptr->getStackRef(j, i))
+				++hand_terms[elem->getWeightIndex()];
+
+			for (auto &elem : p_passive_hand_ptr->getStackRef(j, i))
+				--hand_terms[elem->getWeightIndex()];
+		}
+	}
+
+	for (auto &elem : { board_terms, hand_terms })
+	{
+		for (int i = 0; i < NUM_WEIGHTS; ++i)
+			p_stream_ref << elem[i] << (i < NUM_WEIGHTS - 1 ? "," : "");
+
+		p_stream_ref << ';';
+	}
+
+	p_stream_ref << p_result << std::endl;
 }
 
 void Player::place1()
@@ -335,29 +441,79 @@ void Player::move()
 	game::Piece::Color active = this->getActiveColor(*this->m_turn_ptr);
 	game::Piece::Color passive = this->getPassiveColor(*this->m_turn_ptr);
 
-	Hand *active_hand_ptr = this->getHandPtr(active);
-	Hand *passive_hand_ptr = this->getHandPtr(passive);
+	// Position is searched through copies onto context of player, as search runs away from thread of session
+	Board board(*this->m_board_ptr, &this->m_context);
+
+	Hand active_hand(*this->getHandPtr(active), &this->m_context);
+	Hand passive_hand(*this->getHandPtr(passive), &this->m_context);
 
-	this->m_moves = this->getMoves(*this->m_turn_ptr, active_hand_ptr, passive_hand_ptr, this->m_board_ptr);
+	Hand *active_hand_ptr = &active_hand;
+	Hand *passive_hand_ptr = &passive_hand;
+
+	if (this->m_backend == MONTE_CARLO)
+	{
+		Move move;
+
+		if (this->m_mcts_ptr->search(this, this->m_level, *this->m_turn_ptr, active_hand_ptr, passive_hand_ptr, &board, move))
+			this->m_moves.push_back(move);
+
+		return;
+	}
+
+	this->m_moves = this->getMoves(*this->m_turn_ptr, active_hand_ptr, passive_hand_ptr, &board);
 
 	if (this->m_level < 2)
 		return;
 
+	NNUE::Accumulator accumulator;
+
+	if (this->neural())
+		this->accumulate(accumulator, *this->m_turn_ptr, active_hand_ptr, passive_hand_ptr, &board);
+
+	// Buffers are sized before search, as resizing would move those of nodes still being searched
+	if (static_cast<int>(this->m_plies.size()) <= (this->m_level - 2) / 4)
+		this->m_plies.resize((this->m_level - 2) / 4 + 1);
+
+	for (auto &elem : this->m_plies)
+		elem.killers.clear();
+
+	this->m_node_limit = (this->m_max_nodes > 0 ? this->m_context.counters.nodes + this->m_max_nodes : UINT64_MAX);
+
 	int best = INT_MIN;
+	unsigned int searched = 0;
 
-	for (auto &elem : this->m_moves)
+	for (; searched < this->m_moves.size(); ++searched)
 	{
-		Board temp_board = *this->m_board_ptr;
+		Move &elem = this->m_moves[searched];
+
+		Board temp_board = board;
 
 		Hand temp_active_hand = *active_hand_ptr;
 		Hand temp_passive_hand = *passive_hand_ptr;
 
 		this->actSim(elem, *this->m_turn_ptr, &temp_active_hand, &temp_passive_hand, &temp_board);
 
-		elem.score = this->minimax(INT_MIN, INT_MAX, *this->m_turn_ptr, &temp_active_hand, &temp_passive_hand, &temp_board);
+		if (this->neural())
+			this->accumulate(this->m_plies[0].accumulator, accumulator, elem, *this->m_turn_ptr, &temp_active_hand, &temp_passive_hand, &board, &temp_board);
+
+		++this->m_context.counters.iterations;
+
+		// Only actions scoring at least as well as best so far are kept, so those proven worse need not be scored exactly
+		elem.score = this->minimax((best == INT_MIN ? INT_MIN : best - 1), INT_MAX, *this->m_turn_ptr, &temp_active_hand, &temp_passive_hand, &temp_board, (this->neural() ? &this->m_plies[0].accumulator : nullptr));
+
+		// Score of action being searched when stopped is meaningless
+		if (this->exhausted())
+			break;
+
 		best = std::max(best, elem.score);
 	}
 
+	// Stopped search chooses among actions it finished scoring, or among all if it finished none
+	if (searched == 0)
+		return;
+
+	this->m_moves.resize(searched);
+
 	for (auto i = this->m_moves.begin(); i != this->m_moves.end();)
 	{
 		if (i->score < best)
@@ -422,6 +578,41 @@ void Player::genRearrangements(Move p_move, std::vector<Move> &p_moves_ref, int
 	}
 }
 
+// Packs action into single word, leaving out score
+Player::Word Player::pack(const Move &p_move_ref)
+{
+	Word word = p_move_ref.func;
+
+	word |= static_cast<Word>(p_move_ref.src.x + p_move_ref.src.y * BOARD_COLS) << 3;
+	word |= static_cast<Word>(p_move_ref.dest.x + p_move_ref.dest.y * BOARD_COLS) << 10;
+	word |= static_cast<Word>(p_move_ref.src.z) << 17;
+	word |= static_cast<Word>(p_move_ref.rear.x + p_move_ref.rear.y * BOARD_COLS) << 19;
+
+	return word;
+}
+
+Player::Move Player::unpack(Word p_word)
+{
+	int src = (p_word >> 3) & 127;
+	int dest = (p_word >> 10) & 127;
+	int rear = (p_word >> 19) & 127;
+
+	return { static_cast<Function>(p_word & 7), { src % BOARD_COLS, src / BOARD_COLS, static_cast<int>((p_word >> 17) & 3) }, { dest % BOARD_COLS, dest / BOARD_COLS }, { rear % BOARD_COLS, rear / BOARD_COLS } };
+}
+
+// Returns actions until checkmate if minimax at specified level scored it, negative if active color is checkmated, or zero if score is none
+// Checkmate found at nth ply from root is scored down by power of two, and only at plies minimax determines checkmate upon, so that evaluations equal to it elsewhere are not taken for it
+int Player::getMate(int p_score, int p_level)
+{
+	for (int depth = 0; p_level - 2 > depth * 4 + 2; ++depth)
+	{
+		if (std::abs(p_score) == (CHECKMATE >> depth))
+			return (p_score > 0 ? 1 : -1) * ((depth + 2) / 2);
+	}
+
+	return 0;
+}
+
 void Player::actSim(Move p_move, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
 {
 	switch (p_move.func)
@@ -470,7 +661,7 @@ void Player::actSim(Move p_move, int p_turn, Hand *p_active_hand_ptr, Hand *p_pa
 	}
 }
 
-int Player::minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+int Player::minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr, const NNUE::Accumulator *p_accumulator_ptr)
 {
 	int depth = p_turn - *this->m_turn_ptr;
 	int divisor = static_cast<int>(std::pow(2, depth));
@@ -478,6 +669,13 @@ int Player::minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr
 	int level_mod = this->m_level - 2;
 	int depth_mod = depth * 4;
 
+	++this->m_context.counters.nodes;
+	this->m_context.counters.depth = std::max(this->m_context.counters.depth, depth + 1);
+
+	// Stopped search is thrown away, so remaining nodes return at once
+	if (this->exhausted())
+		return 0;
+
 	if (level_mod > depth_mod + 2)
 	{
 		if (p_board_ptr->checkmate(p_turn + 1, p_passive_hand_ptr, p_active_hand_ptr))
@@ -488,6 +686,9 @@ int Player::minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr
 
 	if (depth == bottom)
 	{
+		if (p_accumulator_ptr != nullptr)
+			return this->m_network_ptr->evaluate(*p_accumulator_ptr, this->getActiveColor(p_turn));
+
 		int score = this->evalMaterial(p_turn, p_active_hand_ptr, p_passive_hand_ptr, p_board_ptr);
 
 		if (level_mod > depth_mod)
@@ -499,7 +700,11 @@ int Player::minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr
 		return score;
 	}
 
-	std::vector<Move> moves = this->getMoves(p_turn + 1, p_passive_hand_ptr, p_active_hand_ptr, p_board_ptr);
+	// Actions are generated lazily, so that those after cutoff are never determined legal
+	Picker picker(this, &this->m_plies[depth], p_turn + 1, p_passive_hand_ptr, p_active_hand_ptr, p_board_ptr);
+
+	Move move;
+	int index = 0;
 
 	int best = 0;
 	int sign = 0;
@@ -516,36 +721,144 @@ int Player::minimax(int p_alpha, int p_beta, int p_turn, Hand *p_active_hand_ptr
 		sign = 1;
 	}
 
-	for (auto &elem : moves)
+	for (; picker.next(move); ++index)
 	{
 		Board temp_board = *p_board_ptr;
 
 		Hand temp_active_hand = *p_active_hand_ptr;
 		Hand temp_passive_hand = *p_passive_hand_ptr;
 
-		this->actSim(elem, p_turn + 1, &temp_passive_hand, &temp_active_hand, &temp_board);
+		this->actSim(move, p_turn + 1, &temp_passive_hand, &temp_active_hand, &temp_board);
 
-		elem.score = sign * this->minimax(p_alpha, p_beta, p_turn + 1, &temp_passive_hand, &temp_active_hand, &temp_board);
+		// Accumulator of depth below is overwritten by each action in turn, as its position is only searched until next is simulated
+		NNUE::Accumulator *accumulator_ptr = nullptr;
+
+		if (p_accumulator_ptr != nullptr)
+		{
+			accumulator_ptr = &this->m_plies[depth + 1].accumulator;
+			this->accumulate(*accumulator_ptr, *p_accumulator_ptr, move, p_turn + 1, &temp_passive_hand, &temp_active_hand, p_board_ptr, &temp_board);
+		}
+
+		move.score = sign * this->minimax(p_alpha, p_beta, p_turn + 1, &temp_passive_hand, &temp_active_hand, &temp_board, accumulator_ptr);
 
 		if ((depth + 1) % 2)
 		{
-			best = std::min(best, elem.score);
+			best = std::min(best, move.score);
 			p_beta = std::min(p_beta, best);
 		}
 
 		else
 		{
-			best = std::max(best, elem.score);
+			best = std::max(best, move.score);
 			p_alpha = std::max(p_alpha, best);
 		}
 
 		if (p_beta <= p_alpha)
+		{
+			++this->m_context.counters.cutoffs[std::min(index, STATS_CUTOFFS - 1)];
+
+			if (move.func == MOVE || move.func == SET)
+				this->addKiller(Player::pack(move), depth);
+
 			break;
+		}
 	}
 
 	return best;
 }
 
+// Keeps quiet action which caused cutoff at specified depth
+void Player::addKiller(Word p_word, int p_depth)
+{
+	std::vector<Word> &killers_ref = this->m_plies[p_depth].killers;
+
+	for (auto &elem : killers_ref)
+	{
+		if (elem == p_word)
+			return;
+	}
+
+	killers_ref.insert(killers_ref.begin(), p_word);
+
+	if (killers_ref.size() > MAX_KILLERS)
+		killers_ref.pop_back();
+}
+
+// Computes accumulator from scratch
+void Player::accumulate(NNUE::Accumulator &p_accumulator_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
+{
+	Hand *black_hand_ptr = (this->getActiveColor(p_turn) == game::Piece::BLACK ? p_active_hand_ptr : p_passive_hand_ptr);
+	Hand *white_hand_ptr = (this->getActiveColor(p_turn) == game::Piece::WHITE ? p_active_hand_ptr : p_passive_hand_ptr);
+
+	this->m_network_ptr->refresh(p_accumulator_ref, black_hand_ptr, white_hand_ptr, p_board_ptr);
+}
+
+// Computes accumulator from that of position specified action was simulated upon
+// Only towers action may alter are compared between boards, so rest of position is never listed
+void Player::accumulate(NNUE::Accumulator &p_accumulator_ref, const NNUE::Accumulator &p_parent_ref, const Move &p_move_ref, int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_parent_board_ptr, Board *p_board_ptr)
+{
+	Hand *black_hand_ptr = (this->getActiveColor(p_turn) == game::Piece::BLACK ? p_active_hand_ptr : p_passive_hand_ptr);
+	Hand *white_hand_ptr = (this->getActiveColor(p_turn) == game::Piece::WHITE ? p_active_hand_ptr : p_passive_hand_ptr);
+
+	Coords2D squares[NNUE_MAX_ALTERED];
+	int count = this->getAltered(squares, p_move_ref, p_turn, p_parent_board_ptr);
+
+	this->m_network_ptr->update(p_accumulator_ref, p_parent_ref, squares, count, black_hand_ptr, white_hand_ptr, p_parent_board_ptr, p_board_ptr);
+}
+
+// Lists squares specified action may alter, given board preceding it
+// Recovery only ever removes pieces from squares action moves from or onto, but for that upon fortress being removed, which removes from pair of squares in same file
+int Player::getAltered(Coords2D *p_squares_ptr, const Move &p_move_ref, int p_turn, Board *p_board_ptr)
+{
+	int count = 0;
+
+	// Squares from which MRE removal of passive color recovers pieces
+	int y = (this->getPassiveColor(p_turn) == game::Piece::WHITE ? (BLACK_TERRITORY + 1) : LOWER_BOUND);
+
+	switch (p_move_ref.func)
+	{
+	case SET:
+		p_squares_ptr[count++] = { p_move_ref.dest.x, p_move_ref.dest.y };
+		break;
+
+	case MOVE:
+		p_squares_ptr[count++] = { p_move_ref.src.x, p_move_ref.src.y };
+		p_squares_ptr[count++] = { p_move_ref.dest.x, p_move_ref.dest.y };
+		break;
+
+	case STRIKE:
+		p_squares_ptr[count++] = { p_move_ref.src.x, p_move_ref.src.y };
+		p_squares_ptr[count++] = { p_move_ref.dest.x, p_move_ref.dest.y };
+		p_squares_ptr[count++] = { p_move_ref.rear.x, p_move_ref.rear.y };
+		p_squares_ptr[count++] = { p_move_ref.dest.x, y };
+		p_squares_ptr[count++] = { p_move_ref.dest.x, y + 1 };
+		break;
+
+	case DOWN:
+	case UP:
+		p_squares_ptr[count++] = { p_move_ref.src.x, p_move_ref.src.y };
+		p_squares_ptr[count++] = { p_move_ref.rear.x, p_move_ref.rear.y };
+		p_squares_ptr[count++] = { p_move_ref.src.x, y };
+		p_squares_ptr[count++] = { p_move_ref.src.x, y + 1 };
+		break;
+
+	case EXCHANGE:
+		p_squares_ptr[count++] = { p_move_ref.src.x, p_move_ref.src.y };
+		break;
+
+	// Commander is swapped with piece at base of tower
+	case SUBSTITUTE:
+		p_squares_ptr[count++] = { p_move_ref.src.x, p_move_ref.src.y };
+
+		if (game::Square *square_ptr = p_board_ptr->getCommSquarePtr(p_board_ptr->getPiecePtr(p_move_ref.src.x, p_move_ref.src.y, 0)->getAlignment()))
+			p_squares_ptr[count++] = { square_ptr->getX(), square_ptr->getY() };
+
+		break;
+	}
+
+	return count;
+}
+
 int Player::evalMaterial(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_hand_ptr, Board *p_board_ptr)
 {
 	int score = 0;
@@ -566,10 +879,10 @@ int Player::evalMaterial(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_ha
 		for (int j = 0; j < HAND_COLS; ++j)
 		{
 			for (auto &elem : p_active_hand_ptr->getStackRef(j, i))
-				score += elem->getWeight() / 2;
+				score += elem->getWeight() * HAND_PERCENT / 100;
 
 			for (auto &elem : p_passive_hand_ptr->getStackRef(j, i))
-				score -= elem->getWeight() / 2;
+				score -= elem->getWeight() * HAND_PERCENT / 100;
 		}
 	}
 
@@ -584,13 +897,18 @@ int Player::evalMobility(int p_turn, Hand *p_active_hand_ptr, Hand *p_passive_ha
 	int depth = p_turn - *this->m_turn_ptr;
 	int divisor = static_cast<int>(std::pow(2, depth));
 
+	std::vector<::Move> targets;
+
 	for (int i = 0; i < BOARD_ROWS; ++i)
 	{
 		for (int j = 0; j < BOARD_COLS; ++j)
 		{
 			if (p_board_ptr->selectable(j, i, p_turn))
 			{
-				for (auto &elem : p_board_ptr->getMoves(j, i))
+				targets.clear();
+				p_board_ptr->getMoves(j, i, targets);
+
+				for (auto &elem : targets)
 				{
 					if (!p_board_ptr->moveable(j, i, elem.x, elem.y))
 						continue;
@@ -624,22 +942,30 @@ std::vector<Player::Move> Player::getMoves(int p_turn, Hand *p_active_hand_ptr,
 {
 	std::vector<Move> moves;
 
+	// Drops of every piece in hand are determined together, sharing work common to pieces or squares
+	std::vector<Drops> drops = p_board_ptr->getDrops(p_turn, p_active_hand_ptr, p_passive_hand_ptr);
+
+	std::vector<::Move> targets;
+
 	for (int i = 0; i < BOARD_ROWS; ++i)
 	{
 		for (int j = 0; j < BOARD_COLS; ++j)
 		{
-			for (auto &elem : p_active_hand_ptr->getPiecePtrs())
+			for (auto &elem : drops)
 			{
-				if (p_board_ptr->droppable(elem, j, i, p_turn, p_active_hand_ptr, p_passive_hand_ptr))
+				if (elem.squares[j + i * BOARD_COLS])
 				{
-					if (game::Square *square_ptr = p_active_hand_ptr->getSquarePtr(elem))
+					if (game::Square *square_ptr = p_active_hand_ptr->getSquarePtr(elem.piece_ptr))
 						moves.push_back({ SET, { square_ptr->getX(), square_ptr->getY() }, { j, i } });
 				}
 			}
 
 			if (p_board_ptr->selectable(j, i, p_turn))
 			{
-				for (auto &elem : p_board_ptr->getMoves(j, i))
+				targets.clear();
+				p_board_ptr->getMoves(j, i, targets);
+
+				for (auto &elem : targets)
 				{
 					if (!p_board_ptr->moveable(j, i, elem.x, elem.y))
 						continue;
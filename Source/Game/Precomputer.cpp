@@ -0,0 +1,149 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Precomputer.cpp
+ * 
+ * Summary:	Determines legal actions of position awaiting interaction on
+ *		worker thread, publishing them for board to adopt
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Precomputer.h"
+
+// Class functions
+// ---------------
+// Destructor
+Precomputer::~Precomputer()
+{
+	this->cancel();
+}
+
+// Member functions
+// ----------------
+// Determines legal actions of snapshot of position
+// Board and hands are copied onto context of worker before it starts, so that it never reads them as they change nor shares context of session
+void Precomputer::start(Board &p_board_ref, Hand &p_active_hand_ref, Hand &p_passive_hand_ref, int p_turn)
+{
+	this->cancel();
+
+	Board board(p_board_ref, &this->m_context);
+
+	Hand active_hand(p_active_hand_ref, &this->m_context);
+	Hand passive_hand(p_passive_hand_ref, &this->m_context);
+
+	this->m_worker = std::thread(&Precomputer::compute, this, board, active_hand, passive_hand, p_turn, this->m_generation);
+}
+
+// Stops determining legal actions, as position is about to change
+// Generation advances, so that any map already published is never handed out
+void Precomputer::cancel()
+{
+	if (this->m_worker.joinable())
+	{
+		this->m_cancel = true;
+		this->m_worker.join();
+		this->m_cancel = false;
+	}
+
+	++this->m_generation;
+}
+
+// Returns pointer to legal actions of current position, or null if they are yet to be published
+const ActionMap* Precomputer::getMapPtr()
+{
+	if (this->m_published.load(std::memory_order_acquire) != this->m_generation)
+		return nullptr;
+
+	return &this->m_map;
+}
+
+// Determines legal actions of snapshot and publishes them unless cancelled
+// Squares are determined as in hovering over and selecting them
+void Precomputer::compute(Board p_board, Hand p_active_hand, Hand p_passive_hand, int p_turn, int p_generation)
+{
+	ActionMap map = ActionMap();
+
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			if (this->m_cancel)
+				return;
+
+			Action &action = map.actions[j][i];
+
+			if (p_board.strikeable(j, i, p_turn, &p_active_hand, &p_passive_hand))
+				action.color = game::Square::RED;
+
+			else if (p_board.exchangeable(j, i, p_turn, &p_active_hand, &p_passive_hand) || p_board.substitutable(j, i, p_turn))
+				action.color = game::Square::BLUE;
+
+			else if (p_board.selectable(j, i, p_turn))
+				action.color = game::Square::GREEN;
+
+			else
+			{
+				action.color = game::Square::GRAY;
+				continue;
+			}
+
+			for (auto &elem : p_board.getMoves(j, i))
+			{
+				if (!p_board.moveable(j, i, elem.x, elem.y))
+					continue;
+
+				if (p_board.strikeable(j, i, elem.x, elem.y, p_turn, &p_active_hand, &p_passive_hand))
+					action.moves[elem.x][elem.y] = game::Square::RED;
+
+				else if (p_board.moveable(j, i, elem.x, elem.y, p_turn, &p_active_hand, &p_passive_hand))
+					action.moves[elem.x][elem.y] = game::Square::BLUE;
+			}
+
+			action.selected = true;
+		}
+	}
+
+	std::vector<Drops> drops;
+
+	for (auto &elem1 : p_active_hand.getPiecePtrs())
+	{
+		bool found = false;
+
+		for (auto &elem2 : drops)
+			found = (found || elem2.piece_ptr->shallowEquals(elem1));
+
+		if (!found)
+			drops.push_back({ elem1 });
+	}
+
+	p_board.getDrops(drops, p_turn, &p_active_hand, &p_passive_hand, false);
+
+	if (this->m_cancel)
+		return;
+
+	for (auto &elem : drops)
+	{
+		Selection selection;
+		selection.piece_ptr = elem.piece_ptr;
+
+		for (int i = 0; i < BOARD_ROWS; ++i)
+		{
+			for (int j = 0; j < BOARD_COLS; ++j)
+				selection.settable[j][i] = elem.squares[j + i * BOARD_COLS];
+		}
+
+		map.selections.push_back(selection);
+	}
+
+	std::swap(this->m_map, map);
+	this->m_published.store(p_generation, std::memory_order_release);
+}
@@ -5,6 +5,8 @@
  * 
  * Summary:	Manages all of the objects that collectively act as the logical
  *		representation of the game as well as handle saving and loading
+ *		Games are saved as records of the position they start from followed
+ *		by a token per action, and loaded by replaying those actions
  * 
  * Origin:	N/A
  * 
@@ -19,6 +21,9 @@
 
 #include "Game/State.h"
 
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -27,6 +32,8 @@
 // ----------------
 void State::init(int *p_settings_ptr)
 {
+	this->suspend();
+
 	this->m_turn = 1;
 	this->m_stalemate = false;
 	
@@ -41,6 +48,9 @@ void State::init(int *p_settings_ptr)
 	this->m_board.init();
 	this->m_positions.clear();
 
+	this->m_black_mcts.init();
+	this->m_white_mcts.init();
+
 	if (p_settings_ptr != nullptr)
 	{
 		this->m_black_hand.init(this->m_set);
@@ -49,14 +59,37 @@ void State::init(int *p_settings_ptr)
 		this->m_black_player.init(p_settings_ptr[0]);
 		this->m_white_player.init(p_settings_ptr[1]);
 	}
+
+	this->originate();
 }
 
-void State::build()
+// Shares specified network among sessions, as its weights are never changed once loaded, or loads one of its own
+void State::build(NNUE *p_network_ptr)
 {
 	this->m_black_hand.build(this->m_set);
 	this->m_white_hand.build(this->m_set);
 
 	this->m_board.build(this->m_set);
+	this->m_board.setPrecomputerPtr(&this->m_precomputer);
+
+	if (p_network_ptr == nullptr)
+	{
+		this->m_network.load(NNUE_PATH);
+		p_network_ptr = &this->m_network;
+	}
+
+	this->m_network_ptr = p_network_ptr;
+
+	this->m_black_player.setNetworkPtr(p_network_ptr);
+	this->m_white_player.setNetworkPtr(p_network_ptr);
+}
+
+// Draws from random engine of session, uniformly within specified bounds
+int State::random(int p_min, int p_max)
+{
+	std::uniform_int_distribution<int> dist(p_min, p_max);
+
+	return dist(this->m_RNG);
 }
 
 void State::mouseClick(int p_button)
@@ -124,9 +157,21 @@ void State::mouseClick(int p_button)
 		if (!this->getActivePlayerPtr()->controllable() || this->gameOver())
 			this->m_curr_square_ptr->setColor(game::Square::GRAY);
 		
-		// Only record positions after initial arrangement
-		if (this->m_turn > INITIAL_ARRANGEMENT)
-			this->updatePositions();
+		this->updatePositions();
+
+		Player::Move move;
+
+		if (this->determine(move))
+			this->record(move);
+
+		// Record cannot go on past action it does not know, so it starts over from position action led to
+		else
+		{
+			std::cerr << "ERROR::SCENE::RECORD::UNDETERMINED_ACTION >> Turn " << this->m_prior_turn << std::endl;
+			this->originate();
+		}
+
+		this->prepare();
 	}
 }
 
@@ -151,15 +196,21 @@ bool State::handleAI()
 
 	int turn = this->m_turn;
 
-	if (this->getPlayerPtr(active)->act())
+	Player::Move move;
+
+	if (this->getPlayerPtr(active)->act(move))
 	{
 		// Action did not occur
 		if (this->m_turn == turn)
 			this->m_board.getCheckmateRef(active) = true;
 
-		// Only record positions after initial arrangement
-		else if (this->m_turn > INITIAL_ARRANGEMENT)
+		else
+		{
 			this->updatePositions();
+			this->record(move);
+		}
+
+		this->prepare();
 
 		return true;
 	}
@@ -167,8 +218,67 @@ bool State::handleAI()
 	return false;
 }
 
+// Performs specified action of active player, as if chosen through interaction
+// Action is assumed legal, as determined by player beforehand
+void State::play(Player::Move p_move)
+{
+	this->advance(p_move);
+	this->prepare();
+}
+
 // Record current game representation to file
+// Position is kept as is, so that loading never has to replay actions leading to it
 void State::save(const std::string &p_path_ref)
+{
+	Archive::Contents contents;
+	this->archive(contents);
+
+	State::write(p_path_ref, contents);
+}
+
+// Gathers sections of game as it stands, to be laid out and written out apart from state
+// Gathering only copies out pieces and record, so that it is cheap enough to take between frames
+void State::archive(Archive::Contents &p_contents_ref)
+{
+	// Actions performed on pieces directly rather than through state are not recorded, so game is recorded from where it stands
+	if (this->m_prior_turn != this->m_turn)
+		this->originate();
+
+	this->gather(p_contents_ref);
+}
+
+// Lays out and writes out gathered sections, which may be done from any thread
+bool State::write(const std::string &p_path_ref, const Archive::Contents &p_contents_ref)
+{
+	std::vector<char> buffer;
+	Archive::write(buffer, p_contents_ref);
+
+	std::ofstream file;
+	file.open(p_path_ref, std::ios_base::out | std::ios_base::binary);
+
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR::SCENE::SAVE::FILE::OPEN_FAILED >> " << p_path_ref << std::endl;
+		return false;
+	}
+
+	if (!file.good())
+	{
+		std::cerr << "ERROR::SCENE::SAVE::FILE::BAD_STREAM >> " << p_path_ref << std::endl;
+		std::cerr << "eofbit::" << file.eof() << " | " << "failbit::" << file.fail() << " | " << "badbit::" << file.bad() << std::endl;
+
+		return false;
+	}
+
+	file.write(buffer.data(), buffer.size());
+	file.close();
+
+	return !file.fail();
+}
+
+// Record actions of game as text to file, for reading and training
+// Forced rearrangement underway is not part of record, so turn is taken over once loaded
+void State::saveRecord(const std::string &p_path_ref)
 {
 	std::ofstream file;
 	file.open(p_path_ref, std::ios_base::out);
@@ -187,117 +297,317 @@ void State::save(const std::string &p_path_ref)
 		return;
 	}
 
-	std::ostringstream oss;
-	std::string line;
+	// Actions performed on pieces directly rather than through state are not recorded, so game is recorded from where it stands
+	if (this->m_prior_turn != this->m_turn)
+		this->originate();
 
-	// First line is for various parameters
-	oss << this->m_turn << ';' << this->m_black_player.getLevel() << ';' << this->m_white_player.getLevel() << ';';
+	// Header holds version and players
+	file << RECORD_HEADER << ' ' << RECORD_VERSION << '\n';
+	file << "Black " << this->m_black_player.getLevel() << ' ' << this->m_black_player.getBackend() << ' ' << this->m_black_player.getEvaluation() << '\n';
+	file << "White " << this->m_white_player.getLevel() << ' ' << this->m_white_player.getBackend() << ' ' << this->m_white_player.getEvaluation() << '\n';
 
-	// Encrypt line and wite it to file
-	line = this->XOR(oss.str());
-	file << line << std::endl;
-	oss.str("");
+	// Result is only informative, as replay determines it anew
+	file << "Result ";
 
-	// Second line is for game configuration
-	for (int i = 0; i < BOARD_ROWS; ++i)
+	if (this->m_board.getBlackCheckmateRef())
+		file << "0-1";
+
+	else if (this->m_board.getWhiteCheckmateRef())
+		file << "1-0";
+
+	else if (this->m_stalemate)
+		file << "1/2-1/2";
+
+	else
+		file << '*';
+
+	file << '\n';
+
+	// Position game is recorded from, being initial arrangement once it is complete
+	file << this->m_origin << '\n';
+
+	// Remaining lines are for actions
+	for (std::size_t i = 0; i < this->m_record.size(); ++i)
+		file << this->m_record[i].token << ((i + 1) % RECORD_TOKENS_PER_LINE && i + 1 < this->m_record.size() ? ' ' : '\n');
+
+	file.close();
+}
+
+// Restore previously recorded game from file, unless it cannot be read
+// Game is left as it was if file is unreadable, otherwise as far as its contents allow, being false if record stops short at illegal action
+bool State::load(const std::string &p_path_ref)
+{
+	Archive archive;
+
+	// Archives are read in place, whereas text of earlier saves is parsed
+	if (archive.map(p_path_ref) && archive.recognize())
 	{
-		for (int j = 0; j < BOARD_COLS; ++j)
+		if (!archive.validate())
 		{
-			// Board
-			oss << this->m_board.getSquarePtr(j, i)->getID() << ':';
+			std::cerr << "ERROR::SCENE::LOAD::ARCHIVE::INVALID >> " << p_path_ref << std::endl;
+			return false;
+		}
 
-			for (auto &elem : this->m_board.getStackRef(j, i))
-				oss << elem->getID() << "-" << elem->getSide() << ',';
+		return this->loadArchive(archive);
+	}
 
-			oss << ';';
+	archive.unmap();
 
-			if (i < HAND_ROWS && j < HAND_COLS)
-			{
-				// Black hand
-				oss << this->m_black_hand.getSquarePtr(j, i)->getID() << ':';
+	std::ifstream file;
+	file.open(p_path_ref, std::ios_base::in);
 
-				for (auto &elem : this->m_black_hand.getStackRef(j, i))
-					oss << elem->getID() << "-" << elem->getSide() << ',';
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR::SCENE::LOAD::FILE::OPEN_FAILED >> " << p_path_ref << std::endl;
+		return false;
+	}
 
-				oss << ';';
+	if (!file.good())
+	{
+		std::cerr << "ERROR::SCENE::LOAD::FILE::BAD_STREAM >> " << p_path_ref << std::endl;
+		std::cerr << "eofbit::" << file.eof() << " | " << "failbit::" << file.fail() << " | " << "badbit::" << file.bad() << std::endl;
 
-				// White hand
-				oss << this->m_white_hand.getSquarePtr(j, i)->getID() << ':';
+		return false;
+	}
 
-				for (auto &elem : this->m_white_hand.getStackRef(j, i))
-					oss << elem->getID() << "-" << elem->getSide() << ',';
+	std::string line;
+	std::getline(file, line);
 
-				oss << ';';
-			}
+	if (line.compare(0, RECORD_HEADER.size(), RECORD_HEADER) == 0)
+	{
+		int version = std::atoi(line.c_str() + RECORD_HEADER.size());
+
+		if (version < 1 || version > RECORD_VERSION)
+		{
+			std::cerr << "ERROR::SCENE::LOAD::RECORD::UNSUPPORTED_VERSION >> " << version << std::endl;
+			return false;
 		}
+
+		if (!this->loadRecord(file))
+			return false;
 	}
 
-	// Encrypt line and wite it to file
-	line = this->XOR(oss.str());
-	file << line << std::endl;
-	oss.str("");
+	else
+	{
+		file.clear();
+		file.seekg(0);
 
-	// Third line if for exchanges
-	for (auto &elem : this->m_board.getExchangesRef())
-		oss << elem.square_ptr->getID() << ":" << elem.turn << ";";
+		this->loadLegacy(file);
+	}
+
+	file.close();
+
+	return true;
+}
+
+// Restores game from validated archive, taking position as is
+// Players are checked before game is changed, placements as pieces are set, and repetitions are counted anew if archive leaves them out
+bool State::loadArchive(Archive &p_archive_ref)
+{
+	const Archive::Header *header_ptr = p_archive_ref.getHeaderPtr();
+
+	for (int i = 0; i < 2; ++i)
+	{
+		if (header_ptr->backends[i] > Player::MONTE_CARLO || header_ptr->evaluations[i] > Player::NEURAL)
+		{
+			std::cerr << "ERROR::SCENE::LOAD::ARCHIVE::MALFORMED_PLAYER >> " << i << std::endl;
+			return false;
+		}
+	}
+
+	this->init();
+
+	this->m_black_player.init(header_ptr->levels[0]);
+	this->m_white_player.init(header_ptr->levels[1]);
 
-	// Encrypt line and wite it to file
-	line = this->XOR(oss.str());
-	file << line << std::endl;
-	oss.str("");
+	this->m_black_player.setBackend(static_cast<Player::Backend>(header_ptr->backends[0]));
+	this->m_white_player.setBackend(static_cast<Player::Backend>(header_ptr->backends[1]));
 
-	// Remaining lines are for positions
-	for (auto &elem1 : this->m_positions)
+	this->m_black_player.setEvaluation(static_cast<Player::Evaluation>(header_ptr->evaluations[0]));
+	this->m_white_player.setEvaluation(static_cast<Player::Evaluation>(header_ptr->evaluations[1]));
+
+	if (header_ptr->turn < 1 || !Archive::readBlock(*p_archive_ref.getBlockPtr(), &this->m_set, &this->m_black_hand, &this->m_white_hand, &this->m_board))
 	{
-		oss << elem1.getCount() << ':';
+		std::cerr << "ERROR::SCENE::LOAD::ARCHIVE::MALFORMED_POSITION" << std::endl;
 
-		for (int i = 0; i < BOARD_ROWS; ++i)
+		this->init();
+		return false;
+	}
+
+	this->m_turn = header_ptr->turn;
+
+	for (unsigned int i = 0; i < header_ptr->exchanges; ++i)
+	{
+		const Archive::Exchange &exchange = p_archive_ref.getExchangesPtr()[i];
+
+		if (exchange.square < 0 || exchange.square >= NUM_SQUARES || this->m_set.getSquarePtr(exchange.square)->getLocation() != game::Square::BOARD)
 		{
-			for (int j = 0; j < BOARD_COLS; ++j)
-			{
-				for (auto &elem2 : elem1.getStackRef(j, i))
-					oss << elem2 << ',';
+			std::cerr << "ERROR::SCENE::LOAD::ARCHIVE::MALFORMED_EXCHANGE >> " << exchange.square << std::endl;
+			continue;
+		}
 
-				oss << ';';
+		this->m_board.getExchangesRef().push_back({ this->m_set.getSquarePtr(exchange.square), exchange.turn });
+	}
+
+	// Saved during forced rearrangement
+	if (this->m_turn > INITIAL_ARRANGEMENT)
+	{
+		for (Hand *hand_ptr : { &this->m_black_hand, &this->m_white_hand })
+		{
+			if (game::Piece *piece_ptr = hand_ptr->getMREPiecePtr())
+				this->m_curr_piece_ptr = piece_ptr;
+		}
+	}
+
+	if (header_ptr->flags & ARCHIVE_REPETITIONS)
+	{
+		for (unsigned int i = 0; i < header_ptr->repetitions; ++i)
+		{
+			const Archive::Repetition &repetition = p_archive_ref.getRepetitionsPtr()[i];
+
+			Position position;
+			position.setCount(repetition.count);
+
+			for (int j = 0; j < BOARD_COLS * BOARD_ROWS; ++j)
+			{
+				for (int k = 0; k < MAX_HEIGHT && repetition.IDs[j][k] != ARCHIVE_EMPTY; ++k)
+					position.setID(repetition.IDs[j][k], j);
 			}
+
+			this->m_stalemate = (this->m_stalemate || repetition.count >= STALEMATE);
+			this->m_positions.push_back(position);
 		}
+	}
+
+	else
+		this->updatePositions();
 
-		// Encrypt line and wite it to file
-		line = this->XOR(oss.str());
-		file << line << std::endl;
-		oss.str("");
+	// Record
+	this->m_origin.assign(p_archive_ref.getOriginPtr(), header_ptr->origin);
+
+	for (unsigned int i = 0; i < header_ptr->entries; ++i)
+	{
+		const Archive::Entry &elem = p_archive_ref.getEntriesPtr()[i];
+
+		Entry entry;
+		entry.move = Player::unpack(elem.word);
+
+		std::memcpy(entry.token, elem.token, NOTATION_MOVE_SIZE);
+		entry.token[NOTATION_MOVE_SIZE] = '\0';
+
+		this->m_record.push_back(entry);
 	}
 
-	file.close();
+	this->snapshot();
+	this->resume();
+
+	if (this->m_journal_ptr != nullptr)
+		this->checkpoint();
+
+	return true;
 }
 
-// Restore previously recorded game from file
-void State::load(const std::string &p_path_ref)
+// Restores game by replaying actions of record
+// Replay stops at first action that cannot be read or is illegal, leaving game as it stood before it
+bool State::loadRecord(std::istream &p_stream_ref)
 {
-	std::ifstream file;
-	file.open(p_path_ref, std::ios_base::in);
+	std::string line;
 
-	if (!file.is_open())
+	// Players are only set once both they and origin are read, so that game is left as it was otherwise
+	int levels[2] = {};
+	int backends[2] = {};
+	int evaluations[2] = {};
+
+	for (int i = 0; i < 2; ++i)
 	{
-		std::cerr << "ERROR::SCENE::LOAD::FILE::OPEN_FAILED >> " << p_path_ref << std::endl;
-		return;
+		std::string color;
+
+		std::getline(p_stream_ref, line);
+		std::istringstream iss(line);
+
+		if (!(iss >> color >> levels[i] >> backends[i] >> evaluations[i]))
+		{
+			std::cerr << "ERROR::SCENE::LOAD::RECORD::MALFORMED_PLAYER >> " << line << std::endl;
+			return false;
+		}
 	}
 
-	if (!file.good())
+	// Result is determined by replay
+	std::getline(p_stream_ref, line);
+
+	// Origin
+	std::getline(p_stream_ref, line);
+
+	if (!line.empty() && line.back() == '\r')
+		line.pop_back();
+
+	std::string origin = this->m_origin;
+	std::vector<Entry> record = this->m_record;
+
+	if (!this->readPosition(line.data(), line.data() + line.size()))
 	{
-		std::cerr << "ERROR::SCENE::LOAD::FILE::BAD_STREAM >> " << p_path_ref << std::endl;
-		std::cerr << "eofbit::" << file.eof() << " | " << "failbit::" << file.fail() << " | " << "badbit::" << file.bad() << std::endl;
+		std::cerr << "ERROR::SCENE::LOAD::RECORD::MALFORMED_ORIGIN >> " << line << std::endl;
 
-		return;
+		// Game so far is set up again from its origin and actions since
+		this->readPosition(origin.data(), origin.data() + origin.size());
+
+		for (const auto &elem : record)
+			this->advance(elem.move);
+
+		this->resume();
+
+		return false;
+	}
+
+	for (int i = 0; i < 2; ++i)
+	{
+		Player *player_ptr = (i == 0 ? &this->m_black_player : &this->m_white_player);
+
+		player_ptr->init(levels[i]);
+		player_ptr->setBackend(static_cast<Player::Backend>(backends[i]));
+		player_ptr->setEvaluation(static_cast<Player::Evaluation>(evaluations[i]));
+	}
+
+	this->suspend();
+
+	std::string token;
+	bool replayed = true;
+
+	while (p_stream_ref >> token)
+	{
+		Player::Move move;
+
+		game::Piece::Color active = this->getActiveColor(this->m_turn);
+		game::Piece::Color passive = this->getPassiveColor(this->m_turn);
+
+		if (!Notation::readMove(token.data(), token.data() + token.size(), move, this->getHandPtr(active)) ||
+			!this->getPlayerPtr(active)->legal(move, this->m_turn, this->getHandPtr(active), this->getHandPtr(passive), &this->m_board))
+		{
+			std::cerr << "ERROR::SCENE::LOAD::RECORD::ILLEGAL_ACTION >> Turn " << this->m_turn << " | " << token << std::endl;
+
+			replayed = false;
+			break;
+		}
+
+		this->advance(move);
 	}
 
+	this->resume();
+
+	return replayed;
+}
+
+// Restores game from full position dumps of saves prior to records
+// Actions leading to restored position are unknown, so it is recorded from there
+void State::loadLegacy(std::istream &p_stream_ref)
+{
 	this->init();
 
 	std::string line;
 	int count1 = 0;
 
 	// Parse through file line by line
-	while (std::getline(file, line))
+	while (std::getline(p_stream_ref, line))
 	{
 		// Decrypt line
 		line = this->XOR(line);
@@ -316,6 +626,19 @@ void State::load(const std::string &p_path_ref)
 
 			std::getline(iss1, token1, ';');
 			this->m_white_player.init(std::stoi(token1));
+
+			// Backends are absent from files recorded prior to their introduction
+			if (std::getline(iss1, token1, ';'))
+				this->m_black_player.setBackend(static_cast<Player::Backend>(std::stoi(token1)));
+
+			if (std::getline(iss1, token1, ';'))
+				this->m_white_player.setBackend(static_cast<Player::Backend>(std::stoi(token1)));
+
+			if (std::getline(iss1, token1, ';'))
+				this->m_black_player.setEvaluation(static_cast<Player::Evaluation>(std::stoi(token1)));
+
+			if (std::getline(iss1, token1, ';'))
+				this->m_white_player.setEvaluation(static_cast<Player::Evaluation>(std::stoi(token1)));
 		}
 
 		// Second line contains game configuration
@@ -340,7 +663,7 @@ void State::load(const std::string &p_path_ref)
 					game::Piece *piece_ptr = this->m_set.getPiecePtr(std::stoi(token2.substr(0, pos)));
 
 					if (std::stoi(token2.substr(pos + 1)) == game::Piece::BACK)
-						piece_ptr->flip();
+						piece_ptr = piece_ptr->getFlippedPtr();
 
 					switch (square_ptr->getLocation())
 					{
@@ -421,6 +744,193 @@ void State::load(const std::string &p_path_ref)
 		}
 	}
 
+	this->resume();
+	this->originate();
+}
+
+// Journal is checkpointed at once, then appended each action
+void State::setJournalPtr(Journal *p_journal_ptr)
+{
+	this->m_journal_ptr = p_journal_ptr;
+
+	if (this->m_journal_ptr != nullptr)
+		this->checkpoint();
+}
+
+// Restore game left in journal at specified path, if any
+// Checkpoint is taken as is, followed by actions journaled since it for as long as they remain legal
+bool State::recover(const std::string &p_path_ref)
+{
+	Archive archive;
+
+	if (!archive.map(p_path_ref + JOURNAL_CHECKPOINT_SUFFIX))
+		return false;
+
+	if (!archive.validate())
+	{
+		std::cerr << "ERROR::SCENE::RECOVER::ARCHIVE::INVALID >> " << p_path_ref << JOURNAL_CHECKPOINT_SUFFIX << std::endl;
+		return false;
+	}
+
+	if (!this->loadArchive(archive))
+		return false;
+
+	std::vector<Journal::Record> records;
+	Journal::read(p_path_ref, records);
+
+	// Journal left over from before checkpoint holds actions it already includes
+	if (records.empty() || records[0].kind != JOURNAL_CHECKPOINT || records[0].value != archive.getHeaderPtr()->checksum)
+		return true;
+
+	this->suspend();
+
+	for (std::size_t i = 1; i < records.size() && records[i].turn == this->m_turn && !this->gameOver(); ++i)
+	{
+		Player::Move move = Player::unpack(records[i].value);
+
+		game::Piece::Color active = this->getActiveColor(this->m_turn);
+		game::Piece::Color passive = this->getPassiveColor(this->m_turn);
+
+		if (!this->getPlayerPtr(active)->legal(move, this->m_turn, this->getHandPtr(active), this->getHandPtr(passive), &this->m_board))
+		{
+			std::cerr << "ERROR::SCENE::RECOVER::ILLEGAL_ACTION >> Turn " << this->m_turn << std::endl;
+			break;
+		}
+
+		this->advance(move);
+	}
+
+	this->resume();
+
+	return true;
+}
+
+// Writes current position in notation, returning end of it, or null if buffer is too small
+char* State::writePosition(char *p_first, char *p_last)
+{
+	return Notation::writePosition(p_first, p_last, this->m_turn, &this->m_black_hand, &this->m_white_hand, &this->m_board);
+}
+
+// Legal actions being determined in background rely upon pieces, which are about to be moved or reset outside of interaction
+void State::suspend()
+{
+	this->m_board.cancel();
+}
+
+// Sets up position written in notation, discarding game so far
+// Positions preceding it are unknown, so repetitions are counted from it
+bool State::readPosition(const char *p_first, const char *p_last)
+{
+	this->init();
+
+	if (!Notation::readPosition(p_first, p_last, this->m_turn, &this->m_set, &this->m_black_hand, &this->m_white_hand, &this->m_board))
+	{
+		this->init();
+		return false;
+	}
+
+	// Written during forced rearrangement
+	if (this->m_turn > INITIAL_ARRANGEMENT)
+	{
+		for (int i = 0; i < HAND_ROWS; ++i)
+		{
+			for (int j = 0; j < HAND_COLS; ++j)
+			{
+				for (auto &elem : this->m_black_hand.getStackRef(j, i))
+				{
+					if (elem->impartsMRE())
+						this->m_curr_piece_ptr = elem;
+				}
+
+				for (auto &elem : this->m_white_hand.getStackRef(j, i))
+				{
+					if (elem->impartsMRE())
+						this->m_curr_piece_ptr = elem;
+				}
+			}
+		}
+
+		this->updatePositions();
+	}
+
+	this->originate();
+	this->resume();
+
+	return true;
+}
+
+// Searches for best action of active player until specified flag is raised, reporting each level completed
+// Minimax deepens one level of depth at a time, so that stopped search falls back on deepest completed, whereas placements and tree search are carried out once, by level set
+// Levels search one ply more beyond every four, and choices among equally scored actions are drawn from random engine of session
+bool State::search(const Limits &p_limits_ref, const std::atomic<bool> *p_stop_ptr, Search &p_search_ref, const std::function<void(const Search&)> &p_report_ref)
+{
+	if (this->gameOver())
+		return false;
+
+	Player *player_ptr = this->getActivePlayerPtr();
+	player_ptr->setStopPtr(p_stop_ptr);
+
+	p_search_ref.deepens = (this->m_turn > INITIAL_ARRANGEMENT && player_ptr->getBackend() == Player::MINIMAX && p_limits_ref.level >= 2);
+
+	int max_level = p_limits_ref.level;
+
+	if (p_search_ref.deepens && p_limits_ref.depth > 0)
+		max_level = std::max(2, std::min(max_level, p_limits_ref.depth * 4 + 1));
+
+	for (int level = (p_search_ref.deepens ? std::min(5, max_level) : max_level); ; level = std::min(level + 4, max_level))
+	{
+		player_ptr->init(level);
+		player_ptr->setMaxNodes(p_limits_ref.nodes > 0 ? std::max<std::uint64_t>(1, p_limits_ref.nodes - std::min(p_search_ref.nodes, p_limits_ref.nodes)) : 0);
+		player_ptr->eval();
+
+		p_search_ref.nodes += player_ptr->getStatsPtr()->counters.nodes;
+
+		std::vector<Player::Move> &choices_ref = player_ptr->getChoicesRef();
+
+		if (choices_ref.empty())
+			break;
+
+		bool stopped = ((p_stop_ptr != nullptr && p_stop_ptr->load()) || (p_limits_ref.nodes > 0 && p_search_ref.nodes >= p_limits_ref.nodes));
+
+		// Stopped level only stands in for none completed
+		if (!stopped || !p_search_ref.found)
+		{
+			p_search_ref.best = choices_ref[this->random(0, choices_ref.size() - 1)];
+			p_search_ref.found = true;
+
+			p_search_ref.level = level;
+			p_search_ref.depth = (p_search_ref.deepens ? (level - 2) / 4 + 1 : player_ptr->getStatsPtr()->counters.depth);
+
+			p_search_ref.scored = (p_search_ref.deepens && !stopped);
+			p_search_ref.mate = (p_search_ref.scored ? Player::getMate(p_search_ref.best.score, level) : 0);
+
+			if (p_report_ref)
+				p_report_ref(p_search_ref);
+		}
+
+		if (stopped || !p_search_ref.deepens || level == max_level)
+			break;
+	}
+
+	player_ptr->setStopPtr(nullptr);
+	player_ptr->setMaxNodes(0);
+	player_ptr->init(p_limits_ref.level);
+
+	return p_search_ref.found;
+}
+
+// Writes action of active color in current position, or ? if it cannot be written
+std::string State::format(const Player::Move &p_move_ref)
+{
+	char buffer[NOTATION_MOVE_SIZE];
+	char *end = Notation::writeMove(buffer, buffer + NOTATION_MOVE_SIZE, p_move_ref, this->m_turn, this->getHandPtr(this->getActiveColor(this->m_turn)), this->getHandPtr(this->getPassiveColor(this->m_turn)), &this->m_board);
+
+	return (end != nullptr ? std::string(buffer, end) : std::string("?"));
+}
+
+// Determines check and checkmate of restored game, and awaits interaction as it would have
+void State::resume()
+{
 	if (this->m_turn > INITIAL_ARRANGEMENT)
 	{
 		this->m_board.getBlackCheckRef() = this->m_board.check(game::Piece::BLACK);
@@ -433,15 +943,252 @@ void State::load(const std::string &p_path_ref)
 			this->m_board.getCheckmateRef(active) = this->m_board.checkmate(this->m_turn, this->getHandPtr(active), this->getHandPtr(passive));
 	}
 
+	this->prepare();
+
 	// Saved during forced rearrangement
 	if (this->m_curr_piece_ptr != nullptr)
 		this->m_board.setRearrangeable();
+}
 
-	file.close();
+// Records game as starting from current position
+void State::originate()
+{
+	char buffer[NOTATION_POSITION_SIZE * 2];
+	char *end = this->writePosition(buffer, buffer + sizeof(buffer));
+
+	this->m_origin.assign(buffer, end != nullptr ? end : buffer);
+	this->m_record.clear();
+
+	this->snapshot();
+
+	if (this->m_journal_ptr != nullptr)
+		this->checkpoint();
+}
+
+// Keeps position preceding next action, against which it is recorded
+void State::snapshot()
+{
+	this->m_prior_turn = this->m_turn;
+
+	this->m_prior_black_hand.emplace(this->m_black_hand);
+	this->m_prior_white_hand.emplace(this->m_white_hand);
+
+	this->m_prior_board.emplace(this->m_board);
+}
+
+// Performs specified action of active player, counting position it leads to and recording it
+void State::advance(const Player::Move &p_move_ref)
+{
+	this->getActivePlayerPtr()->play(p_move_ref);
+
+	this->updatePositions();
+	this->record(p_move_ref);
 }
 
+// Records action just performed against position preceding it
+// Arrangement is recorded as position it results in, so record starts over once it is complete
+void State::record(const Player::Move &p_move_ref)
+{
+	Hand *active_hand_ptr = (this->m_prior_turn % 2 ? &*this->m_prior_black_hand : &*this->m_prior_white_hand);
+	Hand *passive_hand_ptr = (this->m_prior_turn % 2 ? &*this->m_prior_white_hand : &*this->m_prior_black_hand);
+
+	if (this->m_prior_turn <= INITIAL_ARRANGEMENT && this->m_turn > INITIAL_ARRANGEMENT)
+	{
+		this->originate();
+		return;
+	}
+
+	Entry entry;
+	entry.move = p_move_ref;
+
+	char *end = Notation::writeMove(entry.token, entry.token + NOTATION_MOVE_SIZE, p_move_ref, this->m_prior_turn, active_hand_ptr, passive_hand_ptr, &*this->m_prior_board);
+
+	// Record cannot go on past action it cannot write, so it starts over from position action led to
+	if (end == nullptr)
+	{
+		std::cerr << "ERROR::SCENE::RECORD::UNWRITABLE_ACTION >> Turn " << this->m_prior_turn << std::endl;
+
+		this->originate();
+		return;
+	}
+
+	*end = '\0';
+	this->m_record.push_back(entry);
+
+	if (this->m_journal_ptr != nullptr)
+		this->m_journal_ptr->append(p_move_ref, this->m_prior_turn);
+
+	this->snapshot();
+
+	// Journal is kept short, so that recovery never replays more than few actions
+	if (this->m_journal_ptr != nullptr && this->m_journal_ptr->due())
+		this->checkpoint();
+}
+
+// Determines action just performed through interaction from position preceding it
+// Interaction does not pass on actions, so each legal one is performed on copies until one leads to position of game
+bool State::determine(Player::Move &p_move_ref)
+{
+	int turn = this->m_prior_turn;
+
+	Hand *active_hand_ptr = (turn % 2 ? &*this->m_prior_black_hand : &*this->m_prior_white_hand);
+	Hand *passive_hand_ptr = (turn % 2 ? &*this->m_prior_white_hand : &*this->m_prior_black_hand);
+
+	Player *player_ptr = this->getPlayerPtr(this->getActiveColor(turn));
+
+	std::vector<Player::Move> moves;
+
+	// Placements are not generated as moves, so each one is tried
+	if (turn <= INITIAL_ARRANGEMENT)
+	{
+		for (int i = 0; i < HAND_ROWS; ++i)
+		{
+			for (int j = 0; j < HAND_COLS; ++j)
+			{
+				for (int k = 0; k < BOARD_ROWS; ++k)
+				{
+					for (int l = 0; l < BOARD_COLS; ++l)
+					{
+						Player::Move move = {};
+
+						move.func = Player::SET;
+
+						move.src.x = j;
+						move.src.y = i;
+
+						move.dest.x = l;
+						move.dest.y = k;
+
+						if (player_ptr->legal(move, turn, active_hand_ptr, passive_hand_ptr, &*this->m_prior_board))
+							moves.push_back(move);
+					}
+				}
+			}
+		}
+	}
+
+	else
+		moves = player_ptr->getMoves(turn, active_hand_ptr, passive_hand_ptr, &*this->m_prior_board);
+
+	for (auto &elem : moves)
+	{
+		Hand black_hand(*this->m_prior_black_hand);
+		Hand white_hand(*this->m_prior_white_hand);
+
+		Board board(*this->m_prior_board);
+
+		if (turn % 2)
+			player_ptr->actSim(elem, turn, &black_hand, &white_hand, &board);
+
+		else
+			player_ptr->actSim(elem, turn, &white_hand, &black_hand, &board);
+
+		if (this->matches(&black_hand, &white_hand, &board))
+		{
+			p_move_ref = elem;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Determines if pieces are arranged as they are in game
+bool State::matches(Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, Board *p_board_ptr)
+{
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			if (p_board_ptr->getStackRef(j, i) != this->m_board.getStackRef(j, i))
+				return false;
+		}
+	}
+
+	for (int i = 0; i < HAND_ROWS; ++i)
+	{
+		for (int j = 0; j < HAND_COLS; ++j)
+		{
+			if (p_black_hand_ptr->getStackRef(j, i) != this->m_black_hand.getStackRef(j, i) || p_white_hand_ptr->getStackRef(j, i) != this->m_white_hand.getStackRef(j, i))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// Copies out sections of game as it stands, leaving layout to whoever writes them
+void State::gather(Archive::Contents &p_contents_ref)
+{
+	Archive::Header &header = p_contents_ref.header;
+	header = {};
+
+	header.turn = this->m_turn;
+
+	header.levels[0] = static_cast<std::uint8_t>(this->m_black_player.getLevel());
+	header.levels[1] = static_cast<std::uint8_t>(this->m_white_player.getLevel());
+
+	header.backends[0] = static_cast<std::uint8_t>(this->m_black_player.getBackend());
+	header.backends[1] = static_cast<std::uint8_t>(this->m_white_player.getBackend());
+
+	header.evaluations[0] = static_cast<std::uint8_t>(this->m_black_player.getEvaluation());
+	header.evaluations[1] = static_cast<std::uint8_t>(this->m_white_player.getEvaluation());
+
+	Archive::writeBlock(p_contents_ref.block, &this->m_black_hand, &this->m_white_hand, &this->m_board);
+
+	std::vector<Archive::Exchange> &exchanges = p_contents_ref.exchanges;
+	exchanges.clear();
+
+	for (auto &elem : this->m_board.getExchangesRef())
+		exchanges.push_back({ elem.square_ptr->getID(), elem.turn });
+
+	p_contents_ref.origin = this->m_origin;
+
+	std::vector<Archive::Entry> &entries = p_contents_ref.entries;
+	entries.assign(this->m_record.size(), Archive::Entry());
+
+	for (std::size_t i = 0; i < this->m_record.size(); ++i)
+	{
+		entries[i].word = Player::pack(this->m_record[i].move);
+		std::memcpy(entries[i].token, this->m_record[i].token, NOTATION_MOVE_SIZE);
+	}
+
+	std::vector<Archive::Repetition> &repetitions = p_contents_ref.repetitions;
+	repetitions.assign(this->m_positions.size(), Archive::Repetition());
+
+	for (std::size_t i = 0; i < this->m_positions.size(); ++i)
+	{
+		repetitions[i].count = this->m_positions[i].getCount();
+		std::memset(repetitions[i].IDs, ARCHIVE_EMPTY, sizeof(repetitions[i].IDs));
+
+		for (int j = 0; j < BOARD_COLS * BOARD_ROWS; ++j)
+		{
+			std::vector<int> &stack = this->m_positions[i].getStackRef(j);
+
+			for (unsigned int k = 0; k < stack.size(); ++k)
+				repetitions[i].IDs[j][k] = static_cast<std::uint8_t>(stack[k]);
+		}
+	}
+}
+
+// Hands journal archive of game as it stands
+void State::checkpoint()
+{
+	Archive::Contents contents;
+	this->gather(contents);
+
+	std::vector<char> buffer;
+	Archive::write(buffer, contents);
+
+	this->m_journal_ptr->checkpoint(buffer);
+}
+
+// Only positions after initial arrangement are counted, as placements never repeat one
 void State::updatePositions()
 {
+	if (this->m_turn <= INITIAL_ARRANGEMENT)
+		return;
+
 	Position position(this->m_board);
 
 	for (auto &elem : this->m_positions)
@@ -458,6 +1205,16 @@ void State::updatePositions()
 	this->m_positions.push_back(position);
 }
 
+// Determines legal actions ahead of interaction if controlled player is to act
+// Computer players generate their own actions, so nothing is determined for them
+void State::prepare()
+{
+	if (this->gameOver() || !this->getActivePlayerPtr()->controllable())
+		return;
+
+	this->m_board.precompute();
+}
+
 // For encryption and decryption of game files
 std::string State::XOR(const std::string &p_line_ref)
 {
@@ -0,0 +1,108 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Stats.cpp
+ * 
+ * Summary:	Counts work done by the rules engine and search within each
+ *		context, aggregated into statistics of a single search once it
+ *		finishes
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ */
+
+#include "Game/Stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Member functions
+// ----------------
+void Counters::add(const Counters &p_counters_ref)
+{
+	this->board_copies += p_counters_ref.board_copies;
+	this->hand_copies += p_counters_ref.hand_copies;
+
+	this->checks += p_counters_ref.checks;
+	this->checkmates += p_counters_ref.checkmates;
+	this->mates_cached += p_counters_ref.mates_cached;
+	this->drops += p_counters_ref.drops;
+
+	this->nodes += p_counters_ref.nodes;
+	this->iterations += p_counters_ref.iterations;
+
+	this->probes += p_counters_ref.probes;
+	this->hits += p_counters_ref.hits;
+
+	for (int i = 0; i < STATS_CUTOFFS; ++i)
+		this->cutoffs[i] += p_counters_ref.cutoffs[i];
+
+	this->depth = std::max(this->depth, p_counters_ref.depth);
+}
+
+// Returns counts accrued after specified snapshot of same context
+// Deepest ply is not cumulative, so it is only reset by whoever takes snapshot
+Counters Counters::since(const Counters &p_counters_ref) const
+{
+	Counters counters;
+
+	counters.board_copies = this->board_copies - p_counters_ref.board_copies;
+	counters.hand_copies = this->hand_copies - p_counters_ref.hand_copies;
+
+	counters.checks = this->checks - p_counters_ref.checks;
+	counters.checkmates = this->checkmates - p_counters_ref.checkmates;
+	counters.mates_cached = this->mates_cached - p_counters_ref.mates_cached;
+	counters.drops = this->drops - p_counters_ref.drops;
+
+	counters.nodes = this->nodes - p_counters_ref.nodes;
+	counters.iterations = this->iterations - p_counters_ref.iterations;
+
+	counters.probes = this->probes - p_counters_ref.probes;
+	counters.hits = this->hits - p_counters_ref.hits;
+
+	for (int i = 0; i < STATS_CUTOFFS; ++i)
+		counters.cutoffs[i] = this->cutoffs[i] - p_counters_ref.cutoffs[i];
+
+	counters.depth = this->depth;
+
+	return counters;
+}
+
+// Effective branching factor, as root of nodes by deepest ply
+double Stats::getBranchingFactor() const
+{
+	if (this->counters.depth <= 0 || this->counters.nodes == 0)
+		return 0.0;
+
+	return std::pow(static_cast<double>(this->counters.nodes), 1.0 / this->counters.depth);
+}
+
+// Milliseconds per iteration
+double Stats::getIterationTime() const
+{
+	return (this->counters.iterations ? this->ms / this->counters.iterations : 0.0);
+}
+
+// Writes as single line of JSON
+void Stats::write(std::ostream &p_stream_ref) const
+{
+	const Counters &counters = this->counters;
+
+	p_stream_ref << "{\"turn\":" << this->turn << ",\"ms\":" << this->ms;
+	p_stream_ref << ",\"board_copies\":" << counters.board_copies << ",\"hand_copies\":" << counters.hand_copies;
+	p_stream_ref << ",\"checks\":" << counters.checks << ",\"checkmates\":" << counters.checkmates << ",\"mates_cached\":" << counters.mates_cached << ",\"drops\":" << counters.drops;
+	p_stream_ref << ",\"nodes\":" << counters.nodes << ",\"iterations\":" << counters.iterations << ",\"depth\":" << counters.depth;
+	p_stream_ref << ",\"probes\":" << counters.probes << ",\"hits\":" << counters.hits << ",\"cutoffs\":[";
+
+	for (int i = 0; i < STATS_CUTOFFS; ++i)
+		p_stream_ref << (i ? "," : "") << counters.cutoffs[i];
+
+	p_stream_ref << "],\"branching_factor\":" << this->getBranchingFactor() << ",\"ms_per_iteration\":" << this->getIterationTime() << "}" << std::endl;
+}
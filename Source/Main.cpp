@@ -20,12 +20,29 @@
 #include "Renderer/Backbuffer.h"
 #include "Renderer/Depthmap.h"
 #include "Renderer/Font.h"
+#include "Game/Explorer.h"
 #include "World/Camera.h"
 #include "World/Scene.h"
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
 #include <random>
+#include <sstream>
 #include <thread>
 
+#define STATS_PATH "Stats.json" // Search statistics are appended per move while debug text is shown
+#define JOURNAL_PATH "Autosave.journal" // Game in progress is journaled per action, and recovered on startup
+#define EXPLORER_PATH "Explorer.gdx" // Actions played from positions in indexed games are listed while debug text is shown
+
+#define EXPLORER_LINES 5 // Most played actions listed
+
+#define LOAD_SCREEN_DOT_RATE 4.0 // Dots per second trailing name of game being loaded in background
+
 // For Windows 32-bit & 64-bit
 #ifdef _WIN32
 #pragma comment(linker, "/SUBSYSTEM:windows /ENTRY:mainCRTStartup")
@@ -40,6 +57,7 @@ CLimitSingleInstance g_instance(TEXT("Global\\{06F0C117-9399-4705-98A4-02CC3B134
 // Function prototypes
 // -------------------
 extern void drawLoadScreen(const std::string &p_path_ref, void *p_window_ptr = nullptr);
+void renderLoadScreen(const std::string &p_path_ref);
 extern int rand(int p_min, int p_max);
 
 void initDisplay();
@@ -57,6 +75,10 @@ void render();
 void renderHUD();
 void renderDebug();
 
+void writeStats(Player *p_player_ptr);
+
+std::vector<std::string> explore(); // Lists actions most played from current position in explorer index, if any
+
 void renderText(Font &p_font_ref, const std::string &p_text_ref, glm::vec2 p_pos, glm::vec4 p_face_color, glm::vec4 p_stroke_color = glm::vec4(0.0f));
 
 void pollKeys(GLFWwindow *p_window_ptr);
@@ -75,6 +97,10 @@ void exitDialog(GLFWwindow *p_window_ptr);
 
 void openDialog(GLFWwindow *p_window_ptr);
 void saveDialog(GLFWwindow *p_window_ptr);
+void saveGames(); // Lays out and writes out queued saves in turn, from save thread
+
+void loadGame(State *p_state_ptr, const std::string &p_path_ref); // Loads game into staging state, from load thread
+void showGame(GLFWwindow *p_window_ptr); // Shows game loaded in background in place of current one
 
 // Callbacks
 void window_pos_callback(GLFWwindow *p_window_ptr, int p_xpos, int p_ypos);
@@ -131,6 +157,21 @@ int g_display_refresh_rate;
 // -----------------
 std::thread g_thread;
 
+std::thread g_save_thread; // Lays out and writes out games gathered between frames, in order they were saved
+std::thread g_load_thread; // Loads games into staging state while load screen is shown
+
+std::mutex g_save_mutex; // Guards saves awaiting save thread
+std::condition_variable g_save_condition;
+
+std::deque<std::pair<std::string, Archive::Contents>> g_saves; // Paths along with games gathered for them
+bool g_saves_closed;
+
+std::atomic<bool> g_loaded; // Load thread is done with staging state
+bool g_load_succeeded;
+
+bool g_loading;
+std::string g_load_path;
+
 double g_prev_time;
 double g_delta_time;
 
@@ -160,6 +201,9 @@ glm::mat4 g_view;
 Scene g_scene;
 Backbuffer g_backbuffer;
 
+Journal g_journal;
+Explorer g_explorer;
+
 GLint g_polygon_mode = GL_FILL;
 
 bool g_render_shadows = true;
@@ -340,9 +384,19 @@ int main()
 	glClearColor(0.0f, 0.0f, 0.5f, 1.0f);
 	drawLoadScreen("", window_ptr);
 
-	g_scene.build();
+	g_scene.build(g_seed);
 	glClearColor(0.01f, 0.01f, 0.01f, 1.0f);
 
+	// Resume game left in progress, whether or not last run ended cleanly
+	// -------------------------------------------------------------------
+	g_scene.getStatePtr()->recover(JOURNAL_PATH);
+
+	if (g_journal.open(JOURNAL_PATH))
+		g_scene.getStatePtr()->setJournalPtr(&g_journal);
+
+	// Index is optional, being built by database tool
+	g_explorer.map(EXPLORER_PATH);
+
 	// Render static models into cubemapped depth buffer
 	// -------------------------------------------------
 	genDepthmapCube();
@@ -363,12 +417,23 @@ int main()
 		if (g_frame_count % 20 == 0)
 			g_frame_rate = static_cast<int>(1.0 / g_delta_time);
 
+		// Game loaded in background is shown between frames
+		// --------------------------------------------------
+		if (g_loading && g_loaded)
+			showGame(window_ptr);
+
 		// Execution
 		// ---------
 		if (!g_window_minimized)
 		{
-			update(window_ptr);
-			render();
+			if (g_loading)
+				renderLoadScreen(g_load_path);
+
+			else
+			{
+				update(window_ptr);
+				render();
+			}
 		}
 
 		// GLFW: Swap framebuffers and process events
@@ -377,6 +442,23 @@ int main()
 		glfwPollEvents();
 	}
 
+	if (g_load_thread.joinable())
+		g_load_thread.join();
+
+	// Saves still queued are written out before exiting
+	{
+		std::lock_guard<std::mutex> lock(g_save_mutex);
+		g_saves_closed = true;
+	}
+
+	g_save_condition.notify_all();
+
+	if (g_save_thread.joinable())
+		g_save_thread.join();
+
+	g_scene.getStatePtr()->setJournalPtr(nullptr);
+	g_journal.close();
+
 	glfwTerminate();
 	return 0;
 }
@@ -384,7 +466,17 @@ int main()
 extern void drawLoadScreen(const std::string &p_path_ref, void *p_window_ptr)
 {
 	static GLFWwindow *window_ptr = static_cast<GLFWwindow*>(p_window_ptr);
-	
+
+	renderLoadScreen(p_path_ref);
+
+	glfwSwapBuffers(window_ptr);
+
+	if (!p_path_ref.empty())
+		glfwPollEvents();
+}
+
+void renderLoadScreen(const std::string &p_path_ref)
+{
 	glClear(GL_COLOR_BUFFER_BIT);
 	glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
@@ -395,13 +487,12 @@ extern void drawLoadScreen(const std::string &p_path_ref, void *p_window_ptr)
 	renderText(g_logo_inner_font, "Gungi3D", glm::vec2(containerWidth() / 2 - 295, containerHeight() / 2 - 33), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.5f, 1.0f));
 
 	renderText(g_info_font, "v1.0", glm::vec2(containerWidth() / 2 + 262, containerHeight() / 2 - 50), glm::vec4(1.0f));
-	renderText(g_info_font, "Loading: " + p_path_ref.substr(p_path_ref.find_last_of("/\\") + 1), glm::vec2(5.0f), glm::vec4(1.0f));
-	renderText(g_info_font, "2018 Chris Malnick", glm::vec2(containerWidth() - 130, 5.0f), glm::vec4(1.0f));
 
-	glfwSwapBuffers(window_ptr);
+	// Games loaded in background are trailed by dots, which keep screen moving until they are shown
+	std::string dots(g_loading ? static_cast<int>(glfwGetTime() * LOAD_SCREEN_DOT_RATE) % 4 : 0, '.');
 
-	if (!p_path_ref.empty())
-		glfwPollEvents();
+	renderText(g_info_font, "Loading: " + p_path_ref.substr(p_path_ref.find_last_of("/\\") + 1) + dots, glm::vec2(5.0f), glm::vec4(1.0f));
+	renderText(g_info_font, "2018 Chris Malnick", glm::vec2(containerWidth() - 130, 5.0f), glm::vec4(1.0f));
 }
 
 extern int rand(int p_min, int p_max)
@@ -538,6 +629,10 @@ void update(GLFWwindow *p_window_ptr)
 	if (!state_ptr->gameOver() && !player_ptr->controllable() && !player_ptr->evaluating())
 		g_thread = std::thread(&Player::eval, player_ptr);
 
+	// Adopt legal actions determined in background
+	// --------------------------------------------
+	state_ptr->getBoardPtr()->poll();
+
 	// Update scene and handle AI move
 	// -------------------------------
 	if (g_scene.update(g_delta_time) && state_ptr->handleAI())
@@ -545,6 +640,9 @@ void update(GLFWwindow *p_window_ptr)
 		if (g_thread.joinable())
 			g_thread.join();
 
+		if (g_show_debug)
+			writeStats(player_ptr);
+
 		calcMouseRay(g_xprev, g_yprev);
 	}
 }
@@ -647,6 +745,40 @@ void renderDebug()
 
 	renderText(g_debug_font, std::to_string(g_scene.getLightPtr()->getBrightness()), glm::vec2(5.0f, containerHeight() - 165.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
+	// Statistics are of last player to act, which is not evaluating while the other is
+	Player *player_ptr = g_scene.getStatePtr()->getPassivePlayerPtr();
+
+	if (!player_ptr->controllable() && player_ptr->getStatsPtr()->turn)
+	{
+		const Stats &stats = *player_ptr->getStatsPtr();
+		const Counters &counters = stats.counters;
+
+		std::ostringstream search;
+		search << std::fixed << std::setprecision(2) << counters.nodes << " nodes, " << counters.depth << " plies, " << stats.getBranchingFactor() << " EBF";
+
+		std::ostringstream time;
+		time << std::fixed << std::setprecision(2) << stats.ms << " ms, " << counters.iterations << " iters, " << stats.getIterationTime() << " ms/iter";
+
+		std::ostringstream calls;
+		calls << counters.board_copies << "/" << counters.hand_copies << " copies, " << counters.checks << " chk, " << counters.checkmates << "+" << counters.mates_cached << " mate, " << counters.drops << " drop";
+
+		std::ostringstream cutoffs;
+		cutoffs << counters.hits << "/" << counters.probes << " hits, cutoffs";
+
+		for (int i = 0; i < STATS_CUTOFFS; ++i)
+			cutoffs << " " << counters.cutoffs[i];
+
+		renderText(g_debug_font, search.str(), glm::vec2(5.0f, containerHeight() - 195.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		renderText(g_debug_font, time.str(), glm::vec2(5.0f, containerHeight() - 210.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		renderText(g_debug_font, calls.str(), glm::vec2(5.0f, containerHeight() - 225.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+		renderText(g_debug_font, cutoffs.str(), glm::vec2(5.0f, containerHeight() - 240.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	}
+
+	std::vector<std::string> lines = explore();
+
+	for (unsigned int i = 0; i < lines.size(); ++i)
+		renderText(g_debug_font, lines[i], glm::vec2(5.0f, containerHeight() - 270.0f - 15.0f * i), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
 	renderText(g_debug_font, std::to_string(g_seed).insert(0, 10 - std::to_string(g_seed).size(), '0'), glm::vec2(containerWidth() - 105.0f, containerHeight() - 15.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 
 	switch (g_polygon_mode)
@@ -683,8 +815,87 @@ void renderDebug()
 	int black_level = g_scene.getStatePtr()->getBlackPlayerPtr()->getLevel();
 	int white_level = g_scene.getStatePtr()->getWhitePlayerPtr()->getLevel();
 
-	renderText(g_debug_font, (black_level == HUMAN ? "Black: HMN" : "Black: CPU" + std::to_string(black_level)), glm::vec2(containerWidth() - (black_level == HUMAN ? 105.0f : 115.0f), containerHeight() - 135.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
-	renderText(g_debug_font, (white_level == HUMAN ? "White: HMN" : "White: CPU" + std::to_string(white_level)), glm::vec2(containerWidth() - (white_level == HUMAN ? 105.0f : 115.0f), containerHeight() - 150.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	bool black_MCTS = (g_scene.getStatePtr()->getBlackPlayerPtr()->getBackend() == Player::MONTE_CARLO);
+	bool white_MCTS = (g_scene.getStatePtr()->getWhitePlayerPtr()->getBackend() == Player::MONTE_CARLO);
+
+	bool black_NNUE = (g_scene.getStatePtr()->getBlackPlayerPtr()->getEvaluation() == Player::NEURAL);
+	bool white_NNUE = (g_scene.getStatePtr()->getWhitePlayerPtr()->getEvaluation() == Player::NEURAL);
+
+	std::string black_text = (black_level == HUMAN ? "Black: HMN" : (black_MCTS ? "Black: MCTS" : "Black: CPU") + std::to_string(black_level) + (black_NNUE ? " NN" : ""));
+	std::string white_text = (white_level == HUMAN ? "White: HMN" : (white_MCTS ? "White: MCTS" : "White: CPU") + std::to_string(white_level) + (white_NNUE ? " NN" : ""));
+
+	// Text is right aligned at roughly ten pixels per character
+	renderText(g_debug_font, black_text, glm::vec2(containerWidth() - (5.0f + 10.0f * black_text.size()), containerHeight() - 135.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+	renderText(g_debug_font, white_text, glm::vec2(containerWidth() - (5.0f + 10.0f * white_text.size()), containerHeight() - 150.0f), glm::vec4(1.0f), glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+}
+
+// Appends statistics of specified player's last evaluation as single line of JSON
+void writeStats(Player *p_player_ptr)
+{
+	if (p_player_ptr->controllable())
+		return;
+
+	std::ofstream file(STATS_PATH, std::ios_base::app);
+
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR::MAIN::WRITE_STATS::FILE::OPEN_FAILED >> " << STATS_PATH << std::endl;
+		return;
+	}
+
+	p_player_ptr->getStatsPtr()->write(file);
+}
+
+// Lists actions most played from current position in explorer index, if any
+// Lines are kept until position changes, as token of each action is written against it
+std::vector<std::string> explore()
+{
+	static std::uint64_t prev_hash;
+	static std::vector<std::string> lines;
+
+	if (!g_explorer.mapped())
+		return lines;
+
+	State *state_ptr = g_scene.getStatePtr();
+	int turn = state_ptr->getTurn();
+
+	Hand *active_hand_ptr = (turn % 2 ? state_ptr->getBlackHandPtr() : state_ptr->getWhiteHandPtr());
+	Hand *passive_hand_ptr = (turn % 2 ? state_ptr->getWhiteHandPtr() : state_ptr->getBlackHandPtr());
+
+	std::uint64_t hash = state_ptr->getBoardPtr()->getHash(turn, active_hand_ptr, passive_hand_ptr);
+
+	if (hash == prev_hash)
+		return lines;
+
+	prev_hash = hash;
+	lines.clear();
+
+	const Explorer::Stat *stats_ptr = nullptr;
+	std::size_t count = g_explorer.find(hash, stats_ptr);
+
+	std::vector<const Explorer::Stat*> stat_ptrs;
+
+	for (std::size_t i = 0; i < count; ++i)
+		stat_ptrs.push_back(stats_ptr + i);
+
+	std::sort(stat_ptrs.begin(), stat_ptrs.end(), [](const Explorer::Stat *p_lhs_ptr, const Explorer::Stat *p_rhs_ptr) { return p_lhs_ptr->games > p_rhs_ptr->games; });
+
+	for (unsigned int i = 0; i < stat_ptrs.size() && i < EXPLORER_LINES; ++i)
+	{
+		const Explorer::Stat &stat = *stat_ptrs[i];
+
+		char token[NOTATION_MOVE_SIZE + 1];
+		char *end = Notation::writeMove(token, token + NOTATION_MOVE_SIZE, Player::unpack(stat.word), turn, active_hand_ptr, passive_hand_ptr, state_ptr->getBoardPtr());
+
+		*(end != nullptr ? end : token) = '\0';
+
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(0) << token << " " << stat.games << " games, " << 100.0 * stat.wins / stat.games << "/" << 100.0 * stat.draws / stat.games << "/" << 100.0 * stat.losses / stat.games << " W/D/L, " << static_cast<double>(stat.score) / stat.games << " score";
+
+		lines.push_back(oss.str());
+	}
+
+	return lines;
 }
 
 void renderText(Font &p_font_ref, const std::string &p_text_ref, glm::vec2 p_pos, glm::vec4 p_face_color, glm::vec4 p_stroke_color)
@@ -872,15 +1083,15 @@ void openDialog(GLFWwindow *p_window_ptr)
 	if (g_thread.joinable())
 		g_thread.join();
 
-	g_backbuffer.init();
+	// Game is loaded into staging state, which nothing else touches until it is shown
+	g_loading = true;
+	g_loaded = false;
 
-	g_scene.init();
-	g_scene.getStatePtr()->load(path);
+	g_load_path = path;
 
-	g_camera.init(Camera::FIXED);
-	glfwSetInputMode(p_window_ptr, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+	glClearColor(0.0f, 0.0f, 0.5f, 1.0f);
 
-	calcMouseRay(g_xprev, g_yprev);
+	g_load_thread = std::thread(loadGame, g_scene.getStagingPtr(), path);
 }
 
 void saveDialog(GLFWwindow *p_window_ptr)
@@ -892,7 +1103,79 @@ void saveDialog(GLFWwindow *p_window_ptr)
 	if (path.empty())
 		return;
 
-	g_scene.getStatePtr()->save(path);
+	// Game is only gathered between frames, then laid out and written out in background without waiting on saves before it
+	Archive::Contents contents;
+	g_scene.getStatePtr()->archive(contents);
+
+	{
+		std::lock_guard<std::mutex> lock(g_save_mutex);
+		g_saves.emplace_back(path, std::move(contents));
+	}
+
+	g_save_condition.notify_all();
+
+	if (!g_save_thread.joinable())
+		g_save_thread = std::thread(saveGames);
+}
+
+// Lays out and writes out queued saves in turn, from save thread, until told to close once queue is drained
+void saveGames()
+{
+	while (true)
+	{
+		std::pair<std::string, Archive::Contents> save;
+
+		{
+			std::unique_lock<std::mutex> lock(g_save_mutex);
+			g_save_condition.wait(lock, [] { return (g_saves_closed || !g_saves.empty()); });
+
+			if (g_saves.empty())
+				break;
+
+			save = std::move(g_saves.front());
+			g_saves.pop_front();
+		}
+
+		State::write(save.first, save.second);
+	}
+}
+
+// Loads game into staging state, from load thread
+// Check, checkmate, and rearrangement of loaded game are determined here as well, rather than between frames
+void loadGame(State *p_state_ptr, const std::string &p_path_ref)
+{
+	g_load_succeeded = p_state_ptr->load(p_path_ref);
+	g_loaded = true;
+}
+
+// Shows game loaded in background in place of current one
+// Current game is kept if file could not be read, as it was before loads were made in background
+void showGame(GLFWwindow *p_window_ptr)
+{
+	g_load_thread.join();
+	g_loading = false;
+
+	glClearColor(0.01f, 0.01f, 0.01f, 1.0f);
+
+	g_prev_time = glfwGetTime();
+
+	if (!g_load_succeeded)
+		return;
+
+	// Journal follows game being shown
+	Journal *journal_ptr = g_scene.getStatePtr()->getJournalPtr();
+
+	g_scene.getStatePtr()->setJournalPtr(nullptr);
+	g_scene.promote();
+	g_scene.getStatePtr()->setJournalPtr(journal_ptr);
+
+	g_backbuffer.init();
+	g_scene.init();
+
+	g_camera.init(Camera::FIXED);
+	glfwSetInputMode(p_window_ptr, GLFW_CURSOR, GLFW_CURSOR_NORMAL);
+
+	calcMouseRay(g_xprev, g_yprev);
 }
 
 // GLFW: Handle window move
@@ -920,6 +1203,14 @@ void window_refresh_callback(GLFWwindow *p_window_ptr)
 		return;
 	}
 
+	if (g_loading)
+	{
+		renderLoadScreen(g_load_path);
+		glfwSwapBuffers(p_window_ptr);
+
+		return;
+	}
+
 	g_perspective = glm::perspective(glm::radians(g_camera.getZoom()), static_cast<float>(containerWidth()) / static_cast<float>(containerHeight()), 0.1f, 100.0f);
 
 	render();
@@ -968,7 +1259,7 @@ void framebuffer_size_callback(GLFWwindow *p_window_ptr, int p_width, int p_heig
 // ----------------------
 void key_callback(GLFWwindow *p_window_ptr, int p_key, int p_scancode, int p_action, int p_mods)
 {
-	if (!g_ready)
+	if (!g_ready || g_loading)
 		return;
 	
 	if (p_key == GLFW_KEY_F1 && p_action == GLFW_PRESS)
@@ -998,12 +1289,28 @@ void key_callback(GLFWwindow *p_window_ptr, int p_key, int p_scancode, int p_act
 	if (p_key == GLFW_KEY_3 && p_action == GLFW_PRESS)
 	{
 		if (!(g_scene.getStatePtr()->getBoardPtr()->getAnimateRef() ^= g_debug_mode))
-			g_scene.getStatePtr()->getBoardPtr()->getAnimationsPtr()->clear();
+			g_scene.getAnimationsPtr()->clear();
 	}
 
 	if (p_key == GLFW_KEY_4 && p_action == GLFW_PRESS)
 		g_render_shadows ^= g_debug_mode;
 
+	// Players are only switched while no search thread is running, as it reads backend and evaluation of player it searches with
+	if (p_action == GLFW_PRESS && g_debug_mode && !g_thread.joinable())
+	{
+		if (p_key == GLFW_KEY_5)
+			g_scene.getStatePtr()->getBlackPlayerPtr()->switchBackend();
+
+		if (p_key == GLFW_KEY_6)
+			g_scene.getStatePtr()->getWhitePlayerPtr()->switchBackend();
+
+		if (p_key == GLFW_KEY_7)
+			g_scene.getStatePtr()->getBlackPlayerPtr()->switchEvaluation();
+
+		if (p_key == GLFW_KEY_8)
+			g_scene.getStatePtr()->getWhitePlayerPtr()->switchEvaluation();
+	}
+
 	if (p_key == GLFW_KEY_SPACE && p_action == GLFW_PRESS)
 		setSpeedMod(SPEED_FAST);
 
@@ -1042,7 +1349,7 @@ void key_callback(GLFWwindow *p_window_ptr, int p_key, int p_scancode, int p_act
 // ------------------------
 void mouse_button_callback(GLFWwindow *p_window_ptr, int p_button, int p_action, int p_mods)
 {
-	if (!g_ready)
+	if (!g_ready || g_loading)
 		return;
 	
 	if (g_camera.getMode() == Camera::FIXED)
@@ -29,12 +29,20 @@ void Scene::init()
 	this->m_picture_model.init();
 }
 
-void Scene::build()
+// Seeds each state apart, sharing network of first with second
+void Scene::build(unsigned int p_seed)
 {
 	int settings[2] = { 0, 0 };
 	
-	this->m_state.build();
-	this->m_state.init(settings);
+	for (State &state : this->m_states)
+	{
+		state.build(&state == &this->m_states[0] ? nullptr : this->m_states[0].getNetworkPtr());
+		state.seed(p_seed + static_cast<unsigned int>(&state - this->m_states));
+		state.init(settings);
+	}
+
+	// Only current state is animated
+	this->m_state_ptr->getBoardPtr()->setObserverPtr(this);
 	
 	// Models
 	this->m_board_model.build("./Resources/Models/Board/Board.obj");
@@ -72,21 +80,32 @@ void Scene::build()
 	this->m_square_model.build();
 }
 
+// Shows staging state in place of current one, which is staged in turn
+// Animations under way belong to pieces of state no longer shown, so they are dropped
+void Scene::promote()
+{
+	State *staging_ptr = this->getStagingPtr();
+
+	this->m_state_ptr->getBoardPtr()->setObserverPtr(nullptr);
+	staging_ptr->getBoardPtr()->setObserverPtr(this);
+
+	this->m_state_ptr = staging_ptr;
+	this->m_animations.clear();
+}
+
 // Updates queued animations and determines if they all have complete
 bool Scene::update(double p_delta_time)
 {
-	std::vector<Animation> *animations_ptr = this->m_state.getBoardPtr()->getAnimationsPtr();
-	
-	for (auto i = animations_ptr->begin(); i != animations_ptr->end();)
+	for (auto i = this->m_animations.begin(); i != this->m_animations.end();)
 	{
-		if ((*animations_ptr)[i - animations_ptr->begin()].update(p_delta_time))
-			i = animations_ptr->erase(i);
+		if (this->m_animations[i - this->m_animations.begin()].update(p_delta_time))
+			i = this->m_animations.erase(i);
 
 		else
 			++i;
 	}
 
-	return animations_ptr->empty();
+	return this->m_animations.empty();
 }
 
 void Scene::renderModels(const Shader &p_shader_ref)
@@ -484,7 +503,7 @@ void Scene::renderSquares(const Shader &p_shader_ref)
 {
 	p_shader_ref.setFloat("u_overlay.brightness", this->m_light.getBrightness());
 
-	Set *set_ptr = this->m_state.getSetPtr();
+	Set *set_ptr = this->m_state_ptr->getSetPtr();
 
 	for (int i = 0; i < NUM_SQUARES; ++i)
 		this->renderSquare(p_shader_ref, set_ptr->getSquarePtr(i));
@@ -496,7 +515,7 @@ void Scene::mousePick(glm::vec3 p_position, glm::vec3 p_direction)
 {
 	this->clearSquares();
 
-	Set *set_ptr = this->m_state.getSetPtr();
+	Set *set_ptr = this->m_state_ptr->getSetPtr();
 
 	for (int i = game::Square::BOARD; i < NUM_SQUARES; ++i)
 	{
@@ -511,9 +530,41 @@ void Scene::mousePick(glm::vec3 p_position, glm::vec3 p_direction)
 	}
 }
 
+void Scene::moved(game::Piece *p_piece_ptr, game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, game::Square *p_mid_square_ptr, int z1, int z2, int z3)
+{
+	glm::vec3 src_coords = this->getWorldCoords(p_src_square_ptr, z1);
+	glm::vec3 end_coords = this->getWorldCoords(p_end_square_ptr, z2);
+	glm::vec3 mid_coords = this->getWorldCoords(p_mid_square_ptr, z3);
+
+	this->endAnimation(p_piece_ptr);
+	this->m_animations.push_back({ p_piece_ptr, src_coords, end_coords, mid_coords });
+}
+
+void Scene::moved(game::Piece *p_piece_ptr, game::Square *p_src_square_ptr, game::Square *p_end_square_ptr, int z1, int z2)
+{
+	glm::vec3 src_coords = this->getWorldCoords(p_src_square_ptr, z1);
+	glm::vec3 end_coords = this->getWorldCoords(p_end_square_ptr, z2);
+
+	this->endAnimation(p_piece_ptr);
+	this->m_animations.push_back({ p_piece_ptr, src_coords, end_coords });
+}
+
+void Scene::flipped(game::Piece *p_piece_ptr, game::Square *p_square_ptr, int z)
+{
+	glm::vec3 coords = this->getWorldCoords(p_square_ptr, z);
+
+	this->endAnimation(p_piece_ptr);
+	this->m_animations.push_back({ p_piece_ptr, coords });
+}
+
+void Scene::reset()
+{
+	this->m_animations.clear();
+}
+
 void Scene::renderBoardPieces(const Shader &p_shader_ref)
 {
-	Board *board_ptr = this->m_state.getBoardPtr();
+	Board *board_ptr = this->m_state_ptr->getBoardPtr();
 
 	for (int i = 0; i < BOARD_ROWS; ++i)
 	{
@@ -547,7 +598,7 @@ void Scene::renderBoardPieces(const Shader &p_shader_ref)
 
 void Scene::renderHandPieces(const Shader &p_shader_ref, game::Piece::Color p_color)
 {
-	Hand *hand_ptr = this->m_state.getHandPtr(p_color);
+	Hand *hand_ptr = this->m_state_ptr->getHandPtr(p_color);
 	int sign = (p_color == game::Piece::WHITE ? -1 : 1);
 	
 	for (int i = 0; i < HAND_ROWS; ++i)
@@ -618,33 +669,34 @@ void Scene::renderSquare(const Shader &p_shader_ref, game::Square *p_square_ptr)
 
 	p_shader_ref.setMat4("u_model", model);
 
-	this->m_square_model.render(p_shader_ref, p_square_ptr->getRGBA());
+	this->m_square_model.render(p_shader_ref, RGBA[p_square_ptr->getColor()]);
 }
 
 void Scene::clearSquares()
 {
-	this->m_state.getBoardPtr()->clear(game::Square::PURPLE);
+	this->m_state_ptr->getBoardPtr()->clear(game::Square::PURPLE);
 
-	if (this->m_state.getCurrSquarePtr() == nullptr)
+	if (this->m_state_ptr->getCurrSquarePtr() == nullptr)
 		return;
 
-	if (this->m_state.getCurrPiecePtr() == nullptr)
-		this->m_state.getCurrSquarePtr()->setColor(game::Square::CLEAR);
+	if (this->m_state_ptr->getCurrPiecePtr() == nullptr)
+		this->m_state_ptr->getCurrSquarePtr()->setColor(game::Square::CLEAR);
 
-	else if (this->m_state.getCurrSquarePtr()->getColor() == game::Square::GRAY)
-		this->m_state.getCurrSquarePtr()->setColor(game::Square::CLEAR);
+	else if (this->m_state_ptr->getCurrSquarePtr()->getColor() == game::Square::GRAY)
+		this->m_state_ptr->getCurrSquarePtr()->setColor(game::Square::CLEAR);
 
-	this->m_state.setCurrSquarePtr(nullptr);
+	this->m_state_ptr->setCurrSquarePtr(nullptr);
 }
 
 bool Scene::handleBoardAnimation(glm::mat4 &p_model_ref, game::Piece *p_piece_ptr)
 {
-	for (auto &elem : *this->m_state.getBoardPtr()->getAnimationsPtr())
+	for (auto &elem : this->m_animations)
 	{
 		if (!elem.inBoard())
 			continue;
 
-		if (elem.getPiecePtr() != p_piece_ptr)
+		// Pieces turning over are exchanged for their counterparts, so animations are matched by identifier
+		if (elem.getPiecePtr()->getID() != p_piece_ptr->getID())
 			continue;
 
 		p_model_ref = glm::translate(p_model_ref, elem.getPos());
@@ -663,12 +715,12 @@ bool Scene::handleBoardAnimation(glm::mat4 &p_model_ref, game::Piece *p_piece_pt
 
 bool Scene::handleHandAnimation(const Shader &p_shader_ref, glm::mat4 &p_model_ref, game::Piece *p_piece_ptr)
 {
-	for (auto &elem : *this->m_state.getBoardPtr()->getAnimationsPtr())
+	for (auto &elem : this->m_animations)
 	{
 		if (elem.inBoard())
 			continue;
 
-		if (elem.getPiecePtr() != p_piece_ptr)
+		if (elem.getPiecePtr()->getID() != p_piece_ptr->getID())
 			continue;
 		
 		p_model_ref = glm::translate(p_model_ref, elem.getPos());
@@ -718,28 +770,83 @@ bool Scene::pickSquare(glm::vec3 p_position, glm::vec3 p_direction, game::Square
 
 	if (intersect.x >= offset.x - 0.0975f && intersect.x <= offset.x + 0.0975f && intersect.z >= offset.z - 0.0975f && intersect.z <= offset.z + 0.0975f)
 	{
-		this->m_state.setCurrSquarePtr(p_square_ptr);
+		this->m_state_ptr->setCurrSquarePtr(p_square_ptr);
 		
 		switch (location)
 		{
 		case game::Square::BLACK_HAND:
-			this->m_state.getBlackHandPtr()->mouseOver();
+			this->m_state_ptr->getBlackHandPtr()->mouseOver();
 			break;
 
 		case game::Square::WHITE_HAND:
-			this->m_state.getWhiteHandPtr()->mouseOver();
+			this->m_state_ptr->getWhiteHandPtr()->mouseOver();
 			break;
 
 		case game::Square::BOARD:
-			this->m_state.getBoardPtr()->mouseOver();
+			this->m_state_ptr->getBoardPtr()->mouseOver();
 			break;
 		}
 
-		if (!this->m_state.getActivePlayerPtr()->controllable() || this->m_state.gameOver())
-			this->m_state.getCurrSquarePtr()->setColor(game::Square::GRAY);
+		if (!this->m_state_ptr->getActivePlayerPtr()->controllable() || this->m_state_ptr->gameOver())
+			this->m_state_ptr->getCurrSquarePtr()->setColor(game::Square::GRAY);
 
 		return true;
 	}
 
 	return false;
 }
+
+glm::vec3 Scene::getWorldCoords(game::Square *p_square_ptr, int z)
+{
+	if (p_square_ptr == nullptr)
+		return SKIP_ROTATION;
+	
+	glm::vec3 coords;
+
+	int x = p_square_ptr->getX();
+	int y = p_square_ptr->getY();
+
+	switch (p_square_ptr->getLocation())
+	{
+	case game::Square::BLACK_HAND:
+		coords.x = 1.85f + 0.2f * (static_cast<float>(x) - 4.0f);
+		coords.y = -0.09f + 0.015f * static_cast<float>(z);
+		coords.z = 0.6f + 0.2f * (static_cast<float>(y) - 4.0f);
+
+		break;
+
+	case game::Square::WHITE_HAND:
+		coords.x = -1.85f - 0.2f * (static_cast<float>(x) - 4.0f);
+		coords.y = -0.09f + 0.015f * static_cast<float>(z);
+		coords.z = -0.6f - 0.2f * (static_cast<float>(y) - 4.0f);
+
+		break;
+
+	case game::Square::BOARD:
+		Board *board_ptr = this->m_state_ptr->getBoardPtr();
+		float y_off = 0.0f;
+
+		for (int i = 1; i <= z; ++i)
+			y_off += (board_ptr->getPiecePtr(x, y, i)->getSide() != board_ptr->getPiecePtr(x, y, i - 1)->getSide() ? 0.02f : 0.015f);
+
+		coords.x = 0.0f + 0.2f * (static_cast<float>(x) - 4.0f);
+		coords.y = 0.01f + y_off;
+		coords.z = 0.0f + 0.2f * (static_cast<float>(y) - 4.0f);
+
+		break;
+	}
+
+	return coords;
+}
+
+void Scene::endAnimation(game::Piece *p_piece_ptr)
+{
+	for (auto i = this->m_animations.begin(); i != this->m_animations.end();)
+	{
+		if (this->m_animations[i - this->m_animations.begin()].getPiecePtr()->getID() == p_piece_ptr->getID())
+			i = this->m_animations.erase(i);
+
+		else
+			++i;
+	}
+}
@@ -0,0 +1,949 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Analyzer.cpp
+ * 
+ * Summary:	Analyses positions and saved games headlessly in batches, one
+ *		search per core, reading requests and writing results as lines
+ *		of JSON in the order requests were read
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Analyzer [options]
+ * 
+ * Options
+ *	-i <file>		Requests to read (default standard input)
+ *	-o <file>		Results to write (default standard output)
+ *	-level <1-9>		CPU level searched up to (default 9)
+ *	-depth <plies>		Depth searched up to (default that of level)
+ *	-nodes <n>		Nodes searched per position (default no limit)
+ *	-movetime <ms>		Time searched per position (default no limit)
+ *	-backend <minimax|mcts>	Search backend (default minimax)
+ *	-threads <n>		MCTS threads searching each position (default 1)
+ *	-w <workers>		Positions searched at once (default number of cores over threads)
+ *	-seed <seed>		Seed of choice among equally scored actions (default random)
+ * 
+ * Requests are objects, one per line, which may set level, depth, nodes, and
+ * movetime of their own
+ *	{"id": 1, "fen": "<notation>", "moves": ["e5e4", ...]}
+ *				Position reached by actions, from outset if no notation
+ *	{"id": 2, "game": "<file>"}
+ *				Every position of saved game, from its origin
+ * 
+ * Results are objects, one per line, e.g.
+ *	{"line":1,"id":1,"best":"e5e4","score":{"cp":120},"pv":["e5e4","d4d5"],"depth":2,"nodes":53626,"ms":310.2}
+ * games listing such results under plies along with each action played, and
+ * failed requests answering error instead
+ * 
+ * Minimax searches each position on single thread, deepening by level as
+ * engine does, so that workers fill cores, whereas tree search may spread each
+ * position over several threads instead
+ * Principal variation is searched out one depth shallower after each of its
+ * actions, and nodes and time are those of search of position itself
+ */
+
+#include "Game/Notation.h"
+#include "Game/State.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ANALYZER_LEVEL 9
+#define ANALYZER_WINDOW 4 // Requests in flight per worker, which bounds results held back behind slow one
+#define ANALYZER_WATCH_INTERVAL 1 // Milliseconds between checks of search deadlines
+
+typedef std::chrono::steady_clock Clock;
+
+struct Limits
+{
+	int level = ANALYZER_LEVEL;
+	int depth = 0;
+	std::uint64_t nodes = 0;
+	int movetime = 0;
+};
+
+struct Request
+{
+	std::string id; // As written, so that it is answered in kind
+
+	std::string fen;
+	std::vector<std::string> moves;
+
+	std::string game;
+
+	Limits limits;
+};
+
+struct Job
+{
+	std::uint64_t index; // Order among requests
+	std::uint64_t line; // Line of input, blank lines included
+
+	std::string text;
+};
+
+struct Result
+{
+	State::Search search;
+	double ms = 0.0;
+
+	std::vector<std::string> pv;
+};
+
+// Search of single worker, stopped by watching thread once its time has passed
+struct Slot
+{
+	std::atomic<bool> stop { false };
+
+	std::mutex mutex; // Guards deadline, so that search is never stopped by that of one before it
+	bool timed = false;
+	Clock::time_point deadline;
+};
+
+// Function prototypes
+// -------------------
+void work(int p_index);
+void watch(); // Raises stop flags of searches whose time has passed
+void complete(std::uint64_t p_index, const std::string &p_line_ref); // Holds back result until those of requests before it are written
+
+std::string analyse(Slot &p_slot_ref, State *p_state_ptr, State *p_scratch_ptr, const Job &p_job_ref); // Answers request as line of JSON
+
+bool search(Slot &p_slot_ref, State *p_state_ptr, const Limits &p_limits_ref, Result &p_result_ref);
+void trace(State *p_state_ptr, State *p_scratch_ptr, Result &p_result_ref); // Searches out principal variation from position of state
+
+void writeResult(std::ostream &p_stream_ref, const Result &p_result_ref);
+
+std::string quote(const std::string &p_value_ref);
+
+bool parseRequest(const std::string &p_text_ref, Request &p_request_ref, std::string &p_error_ref);
+
+const char* skipSpace(const char *p_first, const char *p_last);
+const char* readString(const char *p_first, const char *p_last, std::string &p_value_ref); // Returns end of string, or null if there is none
+const char* readScalar(const char *p_first, const char *p_last, std::string &p_value_ref); // Returns end of string, number, or literal, which is kept as written
+const char* skipArray(const char *p_first, const char *p_last); // Returns end of array of scalars
+
+// Instance properties
+// -------------------
+unsigned int g_seed;
+
+NNUE g_network; // Loaded once and shared by states of every worker, as its weights are only read
+
+// Analysis properties
+// -------------------
+Limits g_limits;
+
+Player::Backend g_backend = Player::MINIMAX;
+int g_threads = 1;
+
+std::deque<Slot> g_slots;
+std::atomic<bool> g_finished;
+
+// Requests and results, guarded by mutex
+// --------------------------------------
+std::mutex g_mutex;
+std::condition_variable g_condition;
+
+std::deque<Job> g_jobs;
+bool g_eof;
+
+std::map<std::uint64_t, std::string> g_results; // Results held back until those before them are written
+std::uint64_t g_written;
+
+std::ostream *g_output_ptr = &std::cout;
+
+int main(int argc, char **argv)
+{
+	g_seed = std::random_device()();
+
+	std::string input_path;
+	std::string output_path;
+
+	int workers = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::ANALYZER::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-i")
+			input_path = value;
+
+		else if (arg == "-o")
+			output_path = value;
+
+		else if (arg == "-level")
+			g_limits.level = std::max(1, std::min(9, std::stoi(value)));
+
+		else if (arg == "-depth")
+			g_limits.depth = std::stoi(value);
+
+		else if (arg == "-nodes")
+			g_limits.nodes = std::stoull(value);
+
+		else if (arg == "-movetime")
+			g_limits.movetime = std::stoi(value);
+
+		else if (arg == "-backend")
+			g_backend = (value == "mcts" ? Player::MONTE_CARLO : Player::MINIMAX);
+
+		else if (arg == "-threads")
+			g_threads = std::max(1, std::stoi(value));
+
+		else if (arg == "-w")
+			workers = std::max(1, std::stoi(value));
+
+		else if (arg == "-seed")
+			g_seed = static_cast<unsigned int>(std::stoul(value));
+
+		else
+		{
+			std::cerr << "ERROR::ANALYZER::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	// Threads of each tree search take up cores of their own
+	if (workers == 0)
+		workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) / (g_backend == Player::MONTE_CARLO ? g_threads : 1));
+
+	std::ifstream input_file;
+	std::ofstream output_file;
+
+	if (!input_path.empty())
+	{
+		input_file.open(input_path);
+
+		if (!input_file.is_open())
+		{
+			std::cerr << "ERROR::ANALYZER::INPUT_UNREADABLE >> " << input_path << std::endl;
+			return 1;
+		}
+	}
+
+	if (!output_path.empty())
+	{
+		output_file.open(output_path, std::ios_base::out | std::ios_base::trunc);
+
+		if (!output_file.is_open())
+		{
+			std::cerr << "ERROR::ANALYZER::OUTPUT_UNWRITABLE >> " << output_path << std::endl;
+			return 1;
+		}
+
+		g_output_ptr = &output_file;
+	}
+
+	std::istream &input_ref = (input_path.empty() ? std::cin : input_file);
+
+	g_network.load(NNUE_PATH);
+
+	g_slots.resize(workers);
+
+	std::thread watch_thread(watch);
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < workers; ++i)
+		threads.push_back(std::thread(work, i));
+
+	std::uint64_t index = 0;
+	std::uint64_t line = 0;
+
+	std::string text;
+
+	// Reading waits on results once window is full, so that input of any size is read in bounded memory
+	while (std::getline(input_ref, text))
+	{
+		++line;
+
+		if (skipSpace(text.data(), text.data() + text.size()) == text.data() + text.size())
+			continue;
+
+		std::unique_lock<std::mutex> lock(g_mutex);
+		g_condition.wait(lock, [&] { return (index - g_written < static_cast<std::uint64_t>(workers) * ANALYZER_WINDOW); });
+
+		g_jobs.push_back({ index++, line, text });
+
+		lock.unlock();
+		g_condition.notify_all();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+		g_eof = true;
+	}
+
+	g_condition.notify_all();
+
+	for (auto &elem : threads)
+		elem.join();
+
+	g_finished = true;
+	watch_thread.join();
+
+	return 0;
+}
+
+// States are built once per worker, and set up afresh by each request
+void work(int p_index)
+{
+	State state;
+	state.build(&g_network);
+
+	State scratch;
+	scratch.build(&g_network);
+
+	while (true)
+	{
+		Job job;
+
+		{
+			std::unique_lock<std::mutex> lock(g_mutex);
+			g_condition.wait(lock, [] { return (g_eof || !g_jobs.empty()); });
+
+			if (g_jobs.empty())
+				break;
+
+			job = g_jobs.front();
+			g_jobs.pop_front();
+		}
+
+		// Choices among equally scored actions depend on request alone, whichever worker takes it
+		state.seed(g_seed + static_cast<unsigned int>(job.index));
+		scratch.seed(g_seed + static_cast<unsigned int>(job.index));
+
+		complete(job.index, analyse(g_slots[p_index], &state, &scratch, job));
+	}
+}
+
+// Raises stop flags of searches whose time has passed
+void watch()
+{
+	while (!g_finished)
+	{
+		Clock::time_point now = Clock::now();
+
+		for (auto &elem : g_slots)
+		{
+			std::lock_guard<std::mutex> lock(elem.mutex);
+
+			if (elem.timed && now >= elem.deadline)
+				elem.stop = true;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(ANALYZER_WATCH_INTERVAL));
+	}
+}
+
+// Holds back result until those of requests before it are written
+void complete(std::uint64_t p_index, const std::string &p_line_ref)
+{
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+
+		g_results[p_index] = p_line_ref;
+
+		bool written = false;
+
+		while (!g_results.empty() && g_results.begin()->first == g_written)
+		{
+			*g_output_ptr << g_results.begin()->second << '\n';
+
+			g_results.erase(g_results.begin());
+			++g_written;
+
+			written = true;
+		}
+
+		if (written)
+			g_output_ptr->flush();
+	}
+
+	g_condition.notify_all();
+}
+
+// Answers request as line of JSON
+// Actions are checked for legality before each is performed, and request fails at first illegal one
+std::string analyse(Slot &p_slot_ref, State *p_state_ptr, State *p_scratch_ptr, const Job &p_job_ref)
+{
+	Request request;
+	request.limits = g_limits;
+
+	std::string error;
+
+	std::ostringstream oss;
+	oss << "{\"line\":" << p_job_ref.line;
+
+	if (!parseRequest(p_job_ref.text, request, error))
+	{
+		oss << ",\"error\":" << quote(error) << "}";
+		return oss.str();
+	}
+
+	if (!request.id.empty())
+		oss << ",\"id\":" << request.id;
+
+	int settings[] = { request.limits.level, request.limits.level };
+	p_state_ptr->init(settings);
+
+	Board *board_ptr = p_state_ptr->getBoardPtr();
+
+	if (!request.game.empty())
+	{
+		if (!p_state_ptr->load(request.game))
+		{
+			oss << ",\"error\":\"GAME_UNREADABLE\"}";
+			return oss.str();
+		}
+
+		// Record is replaced as game is set back to its origin
+		std::string origin = p_state_ptr->getOriginRef();
+		std::vector<State::Entry> entries = p_state_ptr->getRecordRef();
+
+		// Levels recorded in game are those of client, which analysis does not search by
+		p_state_ptr->getBlackPlayerPtr()->init(request.limits.level);
+		p_state_ptr->getWhitePlayerPtr()->init(request.limits.level);
+
+		if (!p_state_ptr->readPosition(origin.data(), origin.data() + origin.size()))
+		{
+			oss << ",\"error\":\"GAME_UNREADABLE\"}";
+			return oss.str();
+		}
+
+		p_state_ptr->suspend();
+
+		oss << ",\"plies\":[";
+
+		for (std::size_t i = 0; i < entries.size(); ++i)
+		{
+			int turn = p_state_ptr->getTurn();
+
+			Hand *active_hand_ptr = p_state_ptr->getHandPtr(turn % 2 ? game::Piece::BLACK : game::Piece::WHITE);
+			Hand *passive_hand_ptr = p_state_ptr->getHandPtr(turn % 2 ? game::Piece::WHITE : game::Piece::BLACK);
+
+			if (p_state_ptr->gameOver() || !p_state_ptr->getActivePlayerPtr()->legal(entries[i].move, turn, active_hand_ptr, passive_hand_ptr, board_ptr))
+			{
+				oss << "],\"error\":\"ILLEGAL_ACTION\",\"action\":" << quote(entries[i].token) << "}";
+				return oss.str();
+			}
+
+			Result result;
+
+			search(p_slot_ref, p_state_ptr, request.limits, result);
+			trace(p_state_ptr, p_scratch_ptr, result);
+
+			oss << (i ? "," : "") << "{\"turn\":" << turn << ",\"played\":" << quote(entries[i].token);
+			writeResult(oss, result);
+			oss << "}";
+
+			p_state_ptr->play(entries[i].move);
+		}
+
+		oss << "]}";
+		return oss.str();
+	}
+
+	if (!request.fen.empty() && !p_state_ptr->readPosition(request.fen.data(), request.fen.data() + request.fen.size()))
+	{
+		oss << ",\"error\":\"BAD_NOTATION\"}";
+		return oss.str();
+	}
+
+	for (const auto &elem : request.moves)
+	{
+		int turn = p_state_ptr->getTurn();
+
+		Hand *active_hand_ptr = p_state_ptr->getHandPtr(turn % 2 ? game::Piece::BLACK : game::Piece::WHITE);
+		Hand *passive_hand_ptr = p_state_ptr->getHandPtr(turn % 2 ? game::Piece::WHITE : game::Piece::BLACK);
+
+		Player::Move move;
+
+		if (p_state_ptr->gameOver() || !Notation::readMove(elem.data(), elem.data() + elem.size(), move, active_hand_ptr) || !p_state_ptr->getActivePlayerPtr()->legal(move, turn, active_hand_ptr, passive_hand_ptr, board_ptr))
+		{
+			oss << ",\"error\":\"ILLEGAL_ACTION\",\"action\":" << quote(elem) << "}";
+			return oss.str();
+		}
+
+		p_state_ptr->play(move);
+	}
+
+	Result result;
+
+	search(p_slot_ref, p_state_ptr, request.limits, result);
+	trace(p_state_ptr, p_scratch_ptr, result);
+
+	oss << ",\"turn\":" << p_state_ptr->getTurn();
+	writeResult(oss, result);
+	oss << "}";
+
+	return oss.str();
+}
+
+// Search is stopped by watching thread once movetime has passed
+bool search(Slot &p_slot_ref, State *p_state_ptr, const Limits &p_limits_ref, Result &p_result_ref)
+{
+	if (p_state_ptr->gameOver())
+		return false;
+
+	Clock::time_point start = Clock::now();
+
+	int turn = p_state_ptr->getTurn();
+
+	p_state_ptr->getActivePlayerPtr()->setBackend(g_backend);
+
+	MCTS *mcts_ptr = (turn % 2 ? p_state_ptr->getBlackMCTSPtr() : p_state_ptr->getWhiteMCTSPtr());
+
+	mcts_ptr->setThreads(g_threads);
+	mcts_ptr->setBudget(p_limits_ref.movetime);
+
+	{
+		std::lock_guard<std::mutex> lock(p_slot_ref.mutex);
+
+		p_slot_ref.stop = false;
+		p_slot_ref.timed = (p_limits_ref.movetime > 0);
+		p_slot_ref.deadline = start + std::chrono::milliseconds(p_limits_ref.movetime);
+	}
+
+	State::Limits limits;
+	limits.level = p_limits_ref.level;
+	limits.depth = p_limits_ref.depth;
+	limits.nodes = p_limits_ref.nodes;
+
+	bool found = p_state_ptr->search(limits, &p_slot_ref.stop, p_result_ref.search);
+
+	{
+		std::lock_guard<std::mutex> lock(p_slot_ref.mutex);
+		p_slot_ref.timed = false;
+	}
+
+	p_result_ref.ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	return found;
+}
+
+// Searches out principal variation from position of state
+// Each reply is searched one depth shallower on copy of position, without limits, as it is shallower than search already completed
+void trace(State *p_state_ptr, State *p_scratch_ptr, Result &p_result_ref)
+{
+	const State::Search &search_ref = p_result_ref.search;
+
+	if (!search_ref.found)
+		return;
+
+	p_result_ref.pv.push_back(p_state_ptr->format(search_ref.best));
+
+	if (!search_ref.deepens || search_ref.level - 4 < 2)
+		return;
+
+	char buffer[NOTATION_POSITION_SIZE * 2];
+	char *end = p_state_ptr->writePosition(buffer, buffer + sizeof(buffer));
+
+	if (end == nullptr || !p_scratch_ptr->readPosition(buffer, end))
+		return;
+
+	Player::Move move = search_ref.best;
+
+	for (int level = search_ref.level - 4; level >= 2; level -= 4)
+	{
+		p_scratch_ptr->play(move);
+
+		if (p_scratch_ptr->gameOver())
+			break;
+
+		Player *player_ptr = p_scratch_ptr->getActivePlayerPtr();
+
+		player_ptr->setBackend(Player::MINIMAX);
+		player_ptr->init(level);
+		player_ptr->eval();
+
+		std::vector<Player::Move> &choices_ref = player_ptr->getChoicesRef();
+
+		if (choices_ref.empty())
+			break;
+
+		move = choices_ref[p_scratch_ptr->random(0, choices_ref.size() - 1)];
+
+		p_result_ref.pv.push_back(p_scratch_ptr->format(move));
+	}
+}
+
+void writeResult(std::ostream &p_stream_ref, const Result &p_result_ref)
+{
+	const State::Search &search_ref = p_result_ref.search;
+
+	if (!search_ref.found)
+	{
+		p_stream_ref << ",\"best\":null";
+		return;
+	}
+
+	p_stream_ref << ",\"best\":" << quote(p_result_ref.pv.front()) << ",\"score\":";
+
+	if (search_ref.mate != 0)
+		p_stream_ref << "{\"mate\":" << search_ref.mate << "}";
+
+	else if (search_ref.scored)
+		p_stream_ref << "{\"cp\":" << search_ref.best.score << "}";
+
+	else
+		p_stream_ref << "null";
+
+	p_stream_ref << ",\"pv\":[";
+
+	for (std::size_t i = 0; i < p_result_ref.pv.size(); ++i)
+		p_stream_ref << (i ? "," : "") << quote(p_result_ref.pv[i]);
+
+	p_stream_ref << "],\"depth\":" << search_ref.depth << ",\"nodes\":" << search_ref.nodes << ",\"ms\":" << p_result_ref.ms;
+}
+
+std::string quote(const std::string &p_value_ref)
+{
+	static const char HEX[] = "0123456789abcdef";
+
+	std::string quoted = "\"";
+
+	for (char elem : p_value_ref)
+	{
+		if (elem == '"' || elem == '\\')
+		{
+			quoted += '\\';
+			quoted += elem;
+		}
+
+		else if (static_cast<unsigned char>(elem) < 0x20)
+		{
+			quoted += "\\u00";
+			quoted += HEX[elem >> 4];
+			quoted += HEX[elem & 0xF];
+		}
+
+		else
+			quoted += elem;
+	}
+
+	return quoted + "\"";
+}
+
+// Members other than those understood are passed over, as long as they are scalars or arrays of scalars
+bool parseRequest(const std::string &p_text_ref, Request &p_request_ref, std::string &p_error_ref)
+{
+	const char *it = p_text_ref.data();
+	const char *last = p_text_ref.data() + p_text_ref.size();
+
+	p_error_ref = "BAD_JSON";
+
+	it = skipSpace(it, last);
+
+	if (it == last || *it != '{')
+		return false;
+
+	it = skipSpace(it + 1, last);
+
+	bool first = true;
+
+	while (it != last && *it != '}')
+	{
+		if (!first)
+		{
+			if (*it != ',')
+				return false;
+
+			it = skipSpace(it + 1, last);
+		}
+
+		first = false;
+
+		std::string key;
+
+		if ((it = readString(it, last, key)) == nullptr)
+			return false;
+
+		it = skipSpace(it, last);
+
+		if (it == last || *it != ':')
+			return false;
+
+		it = skipSpace(it + 1, last);
+
+		if (it == last)
+			return false;
+
+		std::string value;
+
+		if (key == "moves")
+		{
+			if (*it != '[')
+				return false;
+
+			it = skipSpace(it + 1, last);
+
+			p_request_ref.moves.clear();
+
+			while (it != last && *it != ']')
+			{
+				if (!p_request_ref.moves.empty())
+				{
+					if (*it != ',')
+						return false;
+
+					it = skipSpace(it + 1, last);
+				}
+
+				if ((it = readString(it, last, value)) == nullptr)
+					return false;
+
+				p_request_ref.moves.push_back(value);
+
+				it = skipSpace(it, last);
+			}
+
+			if (it == last)
+				return false;
+
+			++it;
+		}
+
+		else if (*it == '[')
+		{
+			if ((it = skipArray(it, last)) == nullptr)
+				return false;
+		}
+
+		else
+		{
+			if ((it = readScalar(it, last, value)) == nullptr)
+				return false;
+
+			bool quoted = (value.front() == '"');
+
+			if (key == "id")
+				p_request_ref.id = value;
+
+			else if (key == "fen" || key == "game")
+			{
+				if (!quoted || readString(value.data(), value.data() + value.size(), (key == "fen" ? p_request_ref.fen : p_request_ref.game)) == nullptr)
+					return false;
+			}
+
+			else if (key == "level" || key == "depth" || key == "nodes" || key == "movetime")
+			{
+				char *end;
+				long long number = std::strtoll(value.c_str(), &end, 10);
+
+				if (quoted || *end != '\0' || number < 0)
+				{
+					p_error_ref = "BAD_LIMIT";
+					return false;
+				}
+
+				if (key == "level")
+					p_request_ref.limits.level = static_cast<int>(std::max(1LL, std::min(9LL, number)));
+
+				else if (key == "depth")
+					p_request_ref.limits.depth = static_cast<int>(std::min<long long>(number, INT_MAX));
+
+				else if (key == "nodes")
+					p_request_ref.limits.nodes = static_cast<std::uint64_t>(number);
+
+				else
+					p_request_ref.limits.movetime = static_cast<int>(std::min<long long>(number, INT_MAX));
+			}
+		}
+
+		it = skipSpace(it, last);
+	}
+
+	if (it == last || skipSpace(it + 1, last) != last)
+		return false;
+
+	if (!p_request_ref.game.empty() && (!p_request_ref.fen.empty() || !p_request_ref.moves.empty()))
+	{
+		p_error_ref = "GAME_WITH_POSITION";
+		return false;
+	}
+
+	return true;
+}
+
+const char* skipSpace(const char *p_first, const char *p_last)
+{
+	while (p_first != p_last && std::isspace(static_cast<unsigned char>(*p_first)))
+		++p_first;
+
+	return p_first;
+}
+
+// Returns end of string, or null if there is none
+// Escaped characters are decoded as UTF-8, surrogate pairs aside
+const char* readString(const char *p_first, const char *p_last, std::string &p_value_ref)
+{
+	if (p_first == p_last || *p_first != '"')
+		return nullptr;
+
+	p_value_ref.clear();
+
+	for (const char *it = p_first + 1; it != p_last; ++it)
+	{
+		if (*it == '"')
+			return it + 1;
+
+		if (*it != '\\')
+		{
+			p_value_ref += *it;
+			continue;
+		}
+
+		if (++it == p_last)
+			return nullptr;
+
+		switch (*it)
+		{
+		case 'b':
+			p_value_ref += '\b';
+			break;
+
+		case 'f':
+			p_value_ref += '\f';
+			break;
+
+		case 'n':
+			p_value_ref += '\n';
+			break;
+
+		case 'r':
+			p_value_ref += '\r';
+			break;
+
+		case 't':
+			p_value_ref += '\t';
+			break;
+
+		case 'u':
+		{
+			if (p_last - it < 5)
+				return nullptr;
+
+			unsigned int code = 0;
+
+			for (int i = 1; i <= 4; ++i)
+			{
+				if (!std::isxdigit(static_cast<unsigned char>(it[i])))
+					return nullptr;
+
+				code = code * 16 + (std::isdigit(static_cast<unsigned char>(it[i])) ? it[i] - '0' : std::tolower(static_cast<unsigned char>(it[i])) - 'a' + 10);
+			}
+
+			if (code < 0x80)
+				p_value_ref += static_cast<char>(code);
+
+			else if (code < 0x800)
+			{
+				p_value_ref += static_cast<char>(0xC0 | (code >> 6));
+				p_value_ref += static_cast<char>(0x80 | (code & 0x3F));
+			}
+
+			else
+			{
+				p_value_ref += static_cast<char>(0xE0 | (code >> 12));
+				p_value_ref += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				p_value_ref += static_cast<char>(0x80 | (code & 0x3F));
+			}
+
+			it += 4;
+
+			break;
+		}
+
+		default:
+			p_value_ref += *it;
+		}
+	}
+
+	return nullptr;
+}
+
+// Returns end of string, number, or literal, which is kept as written
+const char* readScalar(const char *p_first, const char *p_last, std::string &p_value_ref)
+{
+	const char *end = p_first;
+
+	if (p_first != p_last && *p_first == '"')
+	{
+		// String is scanned for its end, escapes included
+		if ((end = readString(p_first, p_last, p_value_ref)) == nullptr)
+			return nullptr;
+	}
+
+	else
+	{
+		while (end != p_last && (std::isalnum(static_cast<unsigned char>(*end)) || *end == '-' || *end == '+' || *end == '.'))
+			++end;
+	}
+
+	if (end == p_first)
+		return nullptr;
+
+	p_value_ref.assign(p_first, end);
+
+	return end;
+}
+
+// Returns end of array of scalars
+const char* skipArray(const char *p_first, const char *p_last)
+{
+	const char *it = skipSpace(p_first + 1, p_last);
+
+	std::string value;
+	bool first = true;
+
+	while (it != p_last && *it != ']')
+	{
+		if (!first)
+		{
+			if (*it != ',')
+				return nullptr;
+
+			it = skipSpace(it + 1, p_last);
+		}
+
+		first = false;
+
+		if ((it = readScalar(it, p_last, value)) == nullptr)
+			return nullptr;
+
+		it = skipSpace(it, p_last);
+	}
+
+	return (it != p_last ? it + 1 : nullptr);
+}
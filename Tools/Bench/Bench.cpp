@@ -0,0 +1,546 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Bench.cpp
+ * 
+ * Summary:	Times the rules engine and search over a fixed corpus of positions,
+ *		reporting time and allocations per call along with nodes per
+ *		second, optionally as JSON for tracking regressions
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Bench [options]
+ * 
+ * Corpus positions are found by playing random games from fixed seeds, so they
+ * are identical between runs of the same rules
+ *	opening			First position after arrangement
+ *	towers			Most pieces stacked upon others
+ *	drops			Most pieces in hand of color to act, late in game
+ *	mate			Fewest legal actions while in check
+ * 
+ * Options
+ *	-ms <milliseconds>	Time spent on each benchmark (default 250)
+ *	-games <games>		Random games searched for corpus (default 32)
+ *	-level <1-9>		CPU level of timed search (default 6)
+ *	-d <depth>		Plies of perft (default 2)
+ *	-filter <name>		Only run benchmarks whose name contains this
+ *	-json <file>		Write results as JSON
+ */
+
+#include "Game/Perft.h"
+#include "Game/State.h"
+
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#define BENCH_MS 250
+#define BENCH_GAMES 32
+#define BENCH_LEVEL 6
+#define BENCH_DEPTH 2
+
+#define BENCH_MAX_PLIES 300
+#define BENCH_LATE_PLIES 60
+
+struct Corpus
+{
+	std::string name;
+
+	unsigned int seed;
+	int plies; // Random plies after arrangement
+
+	int score; // Rank of best position found so far
+};
+
+struct Result
+{
+	std::string corpus;
+	std::string name;
+
+	std::uint64_t ops;
+	double ns; // Per op
+	double allocs; // Per op
+	double nps; // Nodes per second, where op visits nodes
+};
+
+// Function prototypes
+// -------------------
+void play(State &p_state_ref, unsigned int p_seed, int p_plies); // Plays random arrangement and specified number of random plies
+
+void search(std::vector<Corpus> &p_corpora_ref, int p_games); // Finds highest ranked position of each corpus among random games
+
+void bench(State &p_state_ref, const std::string &p_corpus_ref);
+
+void measure(const std::string &p_corpus_ref, const std::string &p_name_ref, const std::function<std::uint64_t()> &p_op_ref); // Repeats op, which returns number of calls made, until time allotted has passed
+void rate(const std::string &p_name_ref, std::uint64_t p_nodes); // Derives nodes per second of last result, if it was of specified op
+
+void write(const std::string &p_path_ref);
+
+// Instance properties
+// -------------------
+NNUE g_network; // Loaded once and shared by every state, as its weights are only read
+
+std::uint64_t g_allocations = 0;
+volatile std::uint64_t g_sink = 0; // Keeps results of timed calls from being optimized away
+
+int g_ms = BENCH_MS;
+int g_level = BENCH_LEVEL;
+int g_depth = BENCH_DEPTH;
+
+std::string g_filter;
+
+std::vector<Result> g_results;
+
+// Allocations are counted by replacing global operator new, which array new defers to
+void* operator new(std::size_t p_size)
+{
+	++g_allocations;
+
+	if (void *ptr = std::malloc(p_size ? p_size : 1))
+		return ptr;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p_ptr) noexcept
+{
+	std::free(p_ptr);
+}
+
+void operator delete(void *p_ptr, std::size_t) noexcept
+{
+	std::free(p_ptr);
+}
+
+int main(int argc, char **argv)
+{
+	int games = BENCH_GAMES;
+
+	std::string path;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::BENCH::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-ms")
+			g_ms = std::stoi(value);
+
+		else if (arg == "-games")
+			games = std::stoi(value);
+
+		else if (arg == "-level")
+			g_level = std::stoi(value);
+
+		else if (arg == "-d")
+			g_depth = std::stoi(value);
+
+		else if (arg == "-filter")
+			g_filter = value;
+
+		else if (arg == "-json")
+			path = value;
+
+		else
+		{
+			std::cerr << "ERROR::BENCH::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<Corpus> corpora =
+	{
+		{ "opening", 0, 0, 0 },
+		{ "towers", 0, 0, INT_MIN },
+		{ "drops", 0, 0, INT_MIN },
+		{ "mate", 0, 0, INT_MIN },
+	};
+
+	g_network.load(NNUE_PATH);
+
+	search(corpora, games);
+
+	// States are not copyable, since their members refer to one another, so they are constructed in place
+	std::deque<State> states;
+
+	for (auto &elem : corpora)
+	{
+		if (elem.score == INT_MIN)
+		{
+			std::cerr << "ERROR::BENCH::CORPUS_NOT_FOUND >> " << elem.name << std::endl;
+			continue;
+		}
+
+		states.emplace_back();
+		play(states.back(), elem.seed, elem.plies);
+
+		std::cout << "Corpus: " << elem.name << " | Seed: " << elem.seed << " | Turn: " << states.back().getTurn() << std::endl;
+		bench(states.back(), elem.name);
+	}
+
+	if (!path.empty())
+		write(path);
+
+	return 0;
+}
+
+// Plays random arrangement and specified number of random plies
+void play(State &p_state_ref, unsigned int p_seed, int p_plies)
+{
+	p_state_ref.build(&g_network);
+	p_state_ref.seed(p_seed);
+
+	// Level one players choose uniformly among legal actions
+	int settings[] = { 1, 1 };
+	p_state_ref.init(settings);
+
+	while (!p_state_ref.gameOver() && p_state_ref.getTurn() <= INITIAL_ARRANGEMENT + p_plies)
+	{
+		p_state_ref.getActivePlayerPtr()->eval();
+		p_state_ref.handleAI();
+	}
+}
+
+// Finds highest ranked position of each corpus among random games
+// Ranking does not draw from generator, so replaying same seed and plies reaches same position
+void search(std::vector<Corpus> &p_corpora_ref, int p_games)
+{
+	for (int i = 0; i < p_games; ++i)
+	{
+		State state;
+		play(state, i, 0);
+
+		for (int j = 0; j < BENCH_MAX_PLIES && !state.gameOver(); ++j)
+		{
+			int turn = state.getTurn();
+
+			game::Piece::Color active = (turn % 2 ? game::Piece::BLACK : game::Piece::WHITE);
+
+			Hand *active_hand_ptr = state.getHandPtr(active);
+			Hand *passive_hand_ptr = state.getHandPtr(active == game::Piece::WHITE ? game::Piece::BLACK : game::Piece::WHITE);
+
+			Board *board_ptr = state.getBoardPtr();
+
+			int scores[] = { INT_MIN, 0, INT_MIN, INT_MIN };
+
+			for (int y = 0; y < BOARD_ROWS; ++y)
+			{
+				for (int x = 0; x < BOARD_COLS; ++x)
+				{
+					if (board_ptr->getHeight(x, y) > 1)
+						scores[1] += board_ptr->getHeight(x, y) - 1;
+				}
+			}
+
+			if (j >= BENCH_LATE_PLIES)
+				scores[2] = active_hand_ptr->getPiecePtrs().size();
+
+			if (board_ptr->getCheckRef(active))
+				scores[3] = -static_cast<int>(state.getActivePlayerPtr()->getMoves(turn, active_hand_ptr, passive_hand_ptr, board_ptr).size());
+
+			for (unsigned int k = 1; k < p_corpora_ref.size(); ++k)
+			{
+				// Checkmated positions are not worth timing, as nothing is left to search
+				if (k == 3 && scores[k] == 0)
+					continue;
+
+				if (scores[k] > p_corpora_ref[k].score)
+					p_corpora_ref[k] = { p_corpora_ref[k].name, static_cast<unsigned int>(i), j, scores[k] };
+			}
+
+			state.getActivePlayerPtr()->eval();
+			state.handleAI();
+		}
+	}
+}
+
+void bench(State &p_state_ref, const std::string &p_corpus_ref)
+{
+	int turn = p_state_ref.getTurn();
+
+	game::Piece::Color active = (turn % 2 ? game::Piece::BLACK : game::Piece::WHITE);
+
+	Hand *active_hand_ptr = p_state_ref.getHandPtr(active);
+	Hand *passive_hand_ptr = p_state_ref.getHandPtr(active == game::Piece::WHITE ? game::Piece::BLACK : game::Piece::WHITE);
+
+	Board *board_ptr = p_state_ref.getBoardPtr();
+	Player *player_ptr = p_state_ref.getActivePlayerPtr();
+
+	// Arguments are gathered beforehand so as not to be timed
+	std::vector<Coords3D> tops; // Topmost pieces
+	std::vector<Coords3D> tiers; // All pieces
+	std::vector<game::Piece*> hand = active_hand_ptr->getPiecePtrs();
+
+	// Moves within bounds of accessible pieces, and those of them which are possible
+	std::vector<std::pair<Move, Move>> moves;
+	std::vector<std::pair<Move, Move>> possible;
+
+	for (int y = 0; y < BOARD_ROWS; ++y)
+	{
+		for (int x = 0; x < BOARD_COLS; ++x)
+		{
+			int height = board_ptr->getHeight(x, y);
+
+			if (!height)
+				continue;
+
+			tops.push_back({ x, y, height - 1 });
+
+			for (int z = 0; z < height; ++z)
+				tiers.push_back({ x, y, z });
+
+			if (!board_ptr->selectable(x, y, turn))
+				continue;
+
+			for (auto &elem : board_ptr->getMoves(x, y))
+			{
+				moves.push_back({ { x, y }, elem });
+
+				if (board_ptr->moveable(x, y, elem.x, elem.y))
+					possible.push_back({ { x, y }, elem });
+			}
+		}
+	}
+
+	measure(p_corpus_ref, "Piece::getMoves", [&]()
+	{
+		for (auto &elem : tiers)
+			g_sink += board_ptr->getPiecePtr(elem.x, elem.y, elem.z)->getMoves(elem.x, elem.y, elem.z).size();
+
+		return tiers.size();
+	});
+
+	measure(p_corpus_ref, "Board::getMoves", [&]()
+	{
+		for (auto &elem : tops)
+			g_sink += board_ptr->getMoves(elem.x, elem.y).size();
+
+		return tops.size();
+	});
+
+	measure(p_corpus_ref, "Board::blocked", [&]()
+	{
+		for (auto &elem : moves)
+			g_sink += board_ptr->blocked(elem.first.x, elem.first.y, elem.second.x, elem.second.y);
+
+		return moves.size();
+	});
+
+	measure(p_corpus_ref, "Board::check", [&]()
+	{
+		g_sink += board_ptr->check(game::Piece::BLACK);
+		g_sink += board_ptr->check(game::Piece::WHITE);
+
+		return 2;
+	});
+
+	// Repeated in same position, so all but first are remembered
+	measure(p_corpus_ref, "Board::checkmate", [&]()
+	{
+		g_sink += board_ptr->checkmate(turn, active_hand_ptr, passive_hand_ptr);
+
+		return 1;
+	});
+
+	measure(p_corpus_ref, "Board::hasAction", [&]()
+	{
+		g_sink += (board_ptr->hasAction(turn, active_hand_ptr, passive_hand_ptr, false) || board_ptr->hasAction(turn, active_hand_ptr, passive_hand_ptr, true));
+
+		return 1;
+	});
+
+	measure(p_corpus_ref, "Board::droppable", [&]()
+	{
+		for (auto &elem : hand)
+		{
+			for (int y = 0; y < BOARD_ROWS; ++y)
+			{
+				for (int x = 0; x < BOARD_COLS; ++x)
+					g_sink += board_ptr->droppable(elem, x, y, turn, active_hand_ptr, passive_hand_ptr);
+			}
+		}
+
+		return hand.size() * BOARD_ROWS * BOARD_COLS;
+	});
+
+	measure(p_corpus_ref, "Board::getDrops", [&]()
+	{
+		for (auto &elem : board_ptr->getDrops(turn, active_hand_ptr, passive_hand_ptr))
+			g_sink += elem.squares.count();
+
+		return hand.size() * BOARD_ROWS * BOARD_COLS;
+	});
+
+	measure(p_corpus_ref, "Board::moveable", [&]()
+	{
+		for (auto &elem : possible)
+			g_sink += board_ptr->moveable(elem.first.x, elem.first.y, elem.second.x, elem.second.y, turn, active_hand_ptr, passive_hand_ptr);
+
+		return possible.size();
+	});
+
+	measure(p_corpus_ref, "Board::strikeable", [&]()
+	{
+		for (auto &elem : possible)
+			g_sink += board_ptr->strikeable(elem.first.x, elem.first.y, elem.second.x, elem.second.y, turn, active_hand_ptr, passive_hand_ptr);
+
+		return possible.size();
+	});
+
+	measure(p_corpus_ref, "Board::exchangeable", [&]()
+	{
+		for (auto &elem : tops)
+			g_sink += board_ptr->exchangeable(elem.x, elem.y, turn, active_hand_ptr, passive_hand_ptr);
+
+		return tops.size();
+	});
+
+	measure(p_corpus_ref, "Player::getMoves", [&]()
+	{
+		g_sink += player_ptr->getMoves(turn, active_hand_ptr, passive_hand_ptr, board_ptr).size();
+
+		return 1;
+	});
+
+	measure(p_corpus_ref, "Player::evalMaterial", [&]()
+	{
+		g_sink += player_ptr->evalMaterial(turn, active_hand_ptr, passive_hand_ptr, board_ptr);
+
+		return 1;
+	});
+
+	measure(p_corpus_ref, "Player::evalMobility", [&]()
+	{
+		g_sink += player_ptr->evalMobility(turn, active_hand_ptr, passive_hand_ptr, board_ptr);
+
+		return 1;
+	});
+
+	std::uint64_t nodes = 0;
+
+	// Search is timed through evaluation of live position, which is left unaltered until player acts
+	measure(p_corpus_ref, "Player::minimax", [&]()
+	{
+		player_ptr->init(g_level);
+		player_ptr->eval();
+
+		nodes = player_ptr->getStatsPtr()->counters.nodes;
+
+		return 1;
+	});
+
+	rate("Player::minimax", nodes);
+
+	player_ptr->init(1);
+
+	Perft perft;
+	perft.setThreads(1);
+
+	measure(p_corpus_ref, "Perft", [&]()
+	{
+		nodes = perft.count(player_ptr, g_depth, turn, active_hand_ptr, passive_hand_ptr, board_ptr).nodes;
+
+		return 1;
+	});
+
+	rate("Perft", nodes);
+}
+
+// Derives nodes per second of last result, if it was of specified op
+void rate(const std::string &p_name_ref, std::uint64_t p_nodes)
+{
+	if (g_results.empty() || g_results.back().name != p_name_ref || g_results.back().ns <= 0.0)
+		return;
+
+	Result &result = g_results.back();
+	result.nps = p_nodes / (result.ns / 1e9);
+
+	std::cout << "  " << std::left << std::setw(24) << "Nodes/sec" << std::right << std::setw(14) << std::setprecision(0) << result.nps << std::endl;
+}
+
+// Repeats op, which returns number of calls made, until time allotted has passed
+void measure(const std::string &p_corpus_ref, const std::string &p_name_ref, const std::function<std::uint64_t()> &p_op_ref)
+{
+	if (!g_filter.empty() && p_name_ref.find(g_filter) == std::string::npos)
+		return;
+
+	// Nothing to call upon in this position, such as drops with empty hand
+	if (!p_op_ref())
+		return;
+
+	std::uint64_t ops = 0;
+	std::uint64_t allocations = g_allocations;
+
+	auto start = std::chrono::steady_clock::now();
+	auto end = start + std::chrono::milliseconds(g_ms);
+
+	auto now = start;
+
+	do
+	{
+		ops += p_op_ref();
+		now = std::chrono::steady_clock::now();
+	} while (now < end);
+
+	allocations = g_allocations - allocations;
+
+	double ns = std::chrono::duration<double, std::nano>(now - start).count();
+
+	Result result = { p_corpus_ref, p_name_ref, ops, (ops ? ns / ops : 0.0), (ops ? static_cast<double>(allocations) / ops : 0.0), 0.0 };
+	g_results.push_back(result);
+
+	std::cout << "  " << std::left << std::setw(24) << p_name_ref << std::right << std::fixed << std::setprecision(1) << std::setw(14) << result.ns << " ns/op" << std::setw(10) << std::setprecision(2) << result.allocs << " allocs/op" << std::setw(12) << ops << " ops" << std::endl;
+}
+
+void write(const std::string &p_path_ref)
+{
+	std::ofstream file(p_path_ref, std::ios_base::out);
+
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR::BENCH::WRITE::FILE::OPEN_FAILED >> " << p_path_ref << std::endl;
+		return;
+	}
+
+	file << "{\"ms\":" << g_ms << ",\"level\":" << g_level << ",\"depth\":" << g_depth << ",\"results\":[" << std::fixed << std::setprecision(2);
+
+	for (unsigned int i = 0; i < g_results.size(); ++i)
+	{
+		const Result &result = g_results[i];
+
+		file << (i ? "," : "") << "{\"corpus\":\"" << result.corpus << "\",\"name\":\"" << result.name << "\",\"ops\":" << result.ops << ",\"ns_per_op\":" << result.ns << ",\"allocs_per_op\":" << result.allocs;
+
+		if (result.nps > 0.0)
+			file << ",\"nodes_per_sec\":" << result.nps;
+
+		file << "}";
+	}
+
+	file << "]}" << std::endl;
+}
@@ -0,0 +1,524 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Database.cpp
+ * 
+ * Summary:	Indexes saved games by position, recording for each action played
+ *		from it how often it was played, how those games ended, and how
+ *		its outcome was evaluated, and looks positions up in such indexes
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Database -db <index> [options]
+ * 
+ * Options
+ *	-add <path>,...		Saved games, or directories searched for them, to index
+ *	-merge <index>,...	Indexes built before, whose statistics are merged into index
+ *	-t <threads>		Threads replaying games (default number of cores)
+ *	-run <records>		Records each thread gathers before sorting them out to run file (default 4000000)
+ *	-query <file>		Lists actions played from position of saved game, instead of building index
+ * 
+ * Index is written beside itself and renamed into place once complete, so it
+ * may be merged into itself, e.g. Database -db games.gdx -merge games.gdx -add new
+ */
+
+#include "Game/Explorer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DATABASE_RUN_RECORDS 4000000 // Records gathered by each thread before they are sorted out to run file
+#define DATABASE_READ_RECORDS 4096 // Records read at once from each run file while merging
+#define DATABASE_REPORT_INTERVAL 10000 // Games replayed between progress reports
+#define DATABASE_QUERY_REPEATS 100000 // Lookups timed by queries
+
+// Records of one run file or index, read in order while merging
+struct Cursor
+{
+	std::ifstream file;
+	std::vector<Explorer::Record> buffer;
+	std::size_t next = 0;
+
+	Explorer *explorer_ptr = nullptr;
+	std::uint64_t position = 0;
+	std::uint64_t stat = 0;
+
+	Explorer::Record record; // Current, once advanced
+};
+
+// Function prototypes
+// -------------------
+void gather(const std::string &p_path_ref); // Lists saved games at path, searching directories throughout
+
+void work();
+void spill(std::vector<Explorer::Record> &p_records_ref); // Sorts records out to new run file
+
+bool advance(Cursor &p_cursor_ref); // Reads next record, unless cursor is exhausted
+
+bool write(const std::string &p_path_ref, std::vector<Cursor> &p_cursors_ref, std::uint64_t p_games); // Merges records of cursors into index, written beside path
+
+int query(const std::string &p_db_path_ref, const std::string &p_path_ref);
+
+// Instance properties
+// -------------------
+NNUE g_network; // Loaded once and shared by states of every worker, as its weights are only read
+
+// Database properties
+// -------------------
+std::string g_db_path;
+
+std::vector<std::string> g_paths; // Saved games to index
+std::vector<std::string> g_runs; // Run files written so far
+
+std::size_t g_run_records = DATABASE_RUN_RECORDS;
+
+std::atomic<std::size_t> g_next;
+
+std::atomic<std::uint64_t> g_games;
+std::atomic<std::uint64_t> g_failed;
+
+std::mutex g_mutex;
+
+int main(int argc, char **argv)
+{
+	std::vector<std::string> merges;
+	std::string query_path;
+
+	int threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::DATABASE::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-db")
+			g_db_path = value;
+
+		else if (arg == "-t")
+			threads = std::max(1, std::stoi(value));
+
+		else if (arg == "-run")
+			g_run_records = std::max(1, std::stoi(value));
+
+		else if (arg == "-query")
+			query_path = value;
+
+		else if (arg == "-add" || arg == "-merge")
+		{
+			std::istringstream iss(value);
+			std::string token;
+
+			while (std::getline(iss, token, ','))
+			{
+				if (arg == "-add")
+					gather(token);
+
+				else
+					merges.push_back(token);
+			}
+		}
+
+		else
+		{
+			std::cerr << "ERROR::DATABASE::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	if (g_db_path.empty())
+	{
+		std::cerr << "ERROR::DATABASE::INDEX_UNSPECIFIED" << std::endl;
+		return 1;
+	}
+
+	if (!query_path.empty())
+		return query(g_db_path, query_path);
+
+	// Indexes to merge are mapped before games are replayed, so that unusable ones are found out at once
+	std::vector<Explorer> explorers(merges.size());
+	std::uint64_t games = 0;
+
+	for (std::size_t i = 0; i < merges.size(); ++i)
+	{
+		if (!explorers[i].map(merges[i]))
+		{
+			std::cerr << "ERROR::DATABASE::INDEX::INVALID >> " << merges[i] << std::endl;
+			return 1;
+		}
+
+		games += explorers[i].getHeaderPtr()->games;
+	}
+
+	std::cout << "Games: " << g_paths.size() << " | Indexes: " << merges.size() << " | Threads: " << threads << std::endl;
+
+	auto start = std::chrono::steady_clock::now();
+
+	g_network.load(NNUE_PATH);
+
+	std::vector<std::thread> workers;
+
+	for (int i = 0; i < threads; ++i)
+		workers.push_back(std::thread(work));
+
+	for (auto &elem : workers)
+		elem.join();
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Replayed: " << g_games << " | Failed: " << g_failed << " | Runs: " << g_runs.size() << " | Time: " << std::fixed << std::setprecision(3) << seconds << " s" << std::endl;
+
+	// Runs and indexes alike are sorted, so they are merged in one pass
+	std::vector<Cursor> cursors(g_runs.size() + explorers.size());
+
+	for (std::size_t i = 0; i < g_runs.size(); ++i)
+		cursors[i].file.open(g_runs[i], std::ios_base::in | std::ios_base::binary);
+
+	for (std::size_t i = 0; i < explorers.size(); ++i)
+		cursors[g_runs.size() + i].explorer_ptr = &explorers[i];
+
+	start = std::chrono::steady_clock::now();
+
+	bool written = write(g_db_path, cursors, games + g_games);
+
+	seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	cursors.clear();
+	explorers.clear();
+
+	for (auto &elem : g_runs)
+		std::remove(elem.c_str());
+
+	// Indexes merged are no longer mapped, so index may replace one of them
+#ifdef _WIN32
+	if (written)
+		std::remove(g_db_path.c_str());
+#endif
+
+	written = (written && std::rename((g_db_path + ".tmp").c_str(), g_db_path.c_str()) == 0);
+
+	if (!written)
+	{
+		std::cerr << "ERROR::DATABASE::INDEX::WRITE_FAILED >> " << g_db_path << std::endl;
+		return 1;
+	}
+
+	Explorer explorer;
+	explorer.map(g_db_path);
+
+	const Explorer::Header *header_ptr = explorer.getHeaderPtr();
+
+	std::cout << "Indexed: " << header_ptr->games << " games | " << header_ptr->positions << " positions | " << header_ptr->stats << " actions | Time: " << seconds << " s" << std::endl;
+
+	return 0;
+}
+
+// Lists saved games at path, searching directories throughout
+void gather(const std::string &p_path_ref)
+{
+	std::error_code error;
+
+	if (!std::filesystem::is_directory(p_path_ref, error))
+	{
+		g_paths.push_back(p_path_ref);
+		return;
+	}
+
+	for (const auto &elem : std::filesystem::recursive_directory_iterator(p_path_ref, error))
+	{
+		if (elem.is_regular_file(error))
+			g_paths.push_back(elem.path().string());
+	}
+
+	// Games are indexed in same order whatever order directories list them in
+	std::sort(g_paths.begin(), g_paths.end());
+}
+
+void work()
+{
+	State state;
+	state.build(&g_network);
+
+	int settings[] = { 1, 1 };
+	state.init(settings);
+
+	std::vector<Explorer::Record> records;
+	std::size_t index;
+
+	while ((index = g_next++) < g_paths.size())
+	{
+		std::size_t size = records.size();
+
+		// Records of game cut short are dropped along with it
+		if (!state.load(g_paths[index]) || !Explorer::collect(&state, records))
+		{
+			records.resize(size);
+			++g_failed;
+
+			continue;
+		}
+
+		if (++g_games % DATABASE_REPORT_INTERVAL == 0)
+		{
+			std::lock_guard<std::mutex> lock(g_mutex);
+			std::cout << "Replayed: " << g_games << " | Failed: " << g_failed << std::endl;
+		}
+
+		if (records.size() >= g_run_records)
+			spill(records);
+	}
+
+	spill(records);
+}
+
+// Sorts records out to new run file
+void spill(std::vector<Explorer::Record> &p_records_ref)
+{
+	if (p_records_ref.empty())
+		return;
+
+	Explorer::reduce(p_records_ref);
+
+	std::string path;
+
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+
+		path = g_db_path + ".run" + std::to_string(g_runs.size());
+		g_runs.push_back(path);
+	}
+
+	std::ofstream file(path, std::ios_base::out | std::ios_base::binary);
+	file.write(reinterpret_cast<const char*>(p_records_ref.data()), p_records_ref.size() * sizeof(Explorer::Record));
+
+	if (!file.good())
+		std::cerr << "ERROR::DATABASE::RUN::WRITE_FAILED >> " << path << std::endl;
+
+	p_records_ref.clear();
+}
+
+// Reads next record, unless cursor is exhausted
+bool advance(Cursor &p_cursor_ref)
+{
+	if (p_cursor_ref.explorer_ptr != nullptr)
+	{
+		const Explorer::Header *header_ptr = p_cursor_ref.explorer_ptr->getHeaderPtr();
+		const Explorer::Key *keys_ptr = p_cursor_ref.explorer_ptr->getKeysPtr();
+
+		if (p_cursor_ref.stat >= header_ptr->stats)
+			return false;
+
+		// Positions without actions are passed over
+		while (p_cursor_ref.position < header_ptr->positions && keys_ptr[p_cursor_ref.position + 1].first <= p_cursor_ref.stat)
+			++p_cursor_ref.position;
+
+		p_cursor_ref.record.hash = keys_ptr[p_cursor_ref.position].hash;
+		p_cursor_ref.record.stat = p_cursor_ref.explorer_ptr->getStatsPtr()[p_cursor_ref.stat++];
+
+		return true;
+	}
+
+	if (p_cursor_ref.next == p_cursor_ref.buffer.size())
+	{
+		p_cursor_ref.buffer.resize(DATABASE_READ_RECORDS);
+		p_cursor_ref.file.read(reinterpret_cast<char*>(p_cursor_ref.buffer.data()), DATABASE_READ_RECORDS * sizeof(Explorer::Record));
+
+		p_cursor_ref.buffer.resize(static_cast<std::size_t>(p_cursor_ref.file.gcount()) / sizeof(Explorer::Record));
+		p_cursor_ref.next = 0;
+
+		if (p_cursor_ref.buffer.empty())
+			return false;
+	}
+
+	p_cursor_ref.record = p_cursor_ref.buffer[p_cursor_ref.next++];
+
+	return true;
+}
+
+// Merges records of cursors into index, written beside path
+// Statistics are written out as they are merged, whereas keys are set aside until statistics are complete, so that neither is held in memory
+bool write(const std::string &p_path_ref, std::vector<Cursor> &p_cursors_ref, std::uint64_t p_games)
+{
+	std::string keys_path = p_path_ref + ".keys";
+
+	std::ofstream file(p_path_ref + ".tmp", std::ios_base::out | std::ios_base::binary);
+	std::ofstream keys_file(keys_path, std::ios_base::out | std::ios_base::binary);
+
+	if (!file.is_open() || !keys_file.is_open())
+		return false;
+
+	Explorer::Header header = {};
+
+	std::memcpy(header.magic, EXPLORER_MAGIC, sizeof(EXPLORER_MAGIC));
+
+	header.version = EXPLORER_VERSION;
+	header.order = EXPLORER_ORDER;
+	header.games = p_games;
+
+	// Header is written over once counts are known
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	Explorer::Key key = {};
+
+	// Statistic opening group of position is keyed
+	auto append = [&](const Explorer::Record &p_record_ref)
+	{
+		if (header.stats == 0 || key.hash != p_record_ref.hash)
+		{
+			key = { p_record_ref.hash, header.stats };
+			keys_file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+
+			++header.positions;
+		}
+
+		file.write(reinterpret_cast<const char*>(&p_record_ref.stat), sizeof(p_record_ref.stat));
+		++header.stats;
+	};
+
+	// Cursor holding earliest record is on top
+	auto later = [&p_cursors_ref](std::size_t p_lhs, std::size_t p_rhs) { return Explorer::precedes(p_cursors_ref[p_rhs].record, p_cursors_ref[p_lhs].record); };
+	std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> queue(later);
+
+	for (std::size_t i = 0; i < p_cursors_ref.size(); ++i)
+	{
+		if (advance(p_cursors_ref[i]))
+			queue.push(i);
+	}
+
+	Explorer::Record current = {};
+	bool pending = false;
+
+	while (!queue.empty())
+	{
+		std::size_t index = queue.top();
+		queue.pop();
+
+		Explorer::Record record = p_cursors_ref[index].record;
+
+		if (advance(p_cursors_ref[index]))
+			queue.push(index);
+
+		if (pending && Explorer::matches(current, record))
+		{
+			Explorer::combine(current.stat, record.stat);
+			continue;
+		}
+
+		if (pending)
+			append(current);
+
+		current = record;
+		pending = true;
+	}
+
+	if (pending)
+		append(current);
+
+	// Closing key bounds group of last position
+	key = { UINT64_MAX, header.stats };
+	keys_file.write(reinterpret_cast<const char*>(&key), sizeof(key));
+
+	keys_file.close();
+
+	std::ifstream keys_stream(keys_path, std::ios_base::in | std::ios_base::binary);
+	file << keys_stream.rdbuf();
+
+	keys_stream.close();
+	std::remove(keys_path.c_str());
+
+	file.seekp(0);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+	file.close();
+
+	return !file.fail();
+}
+
+int query(const std::string &p_db_path_ref, const std::string &p_path_ref)
+{
+	Explorer explorer;
+
+	if (!explorer.map(p_db_path_ref))
+	{
+		std::cerr << "ERROR::DATABASE::INDEX::INVALID >> " << p_db_path_ref << std::endl;
+		return 1;
+	}
+
+	State state;
+	state.build();
+
+	int settings[] = { 1, 1 };
+	state.init(settings);
+
+	if (!state.load(p_path_ref))
+		return 1;
+
+	int turn = state.getTurn();
+
+	Hand *active_hand_ptr = (turn % 2 ? state.getBlackHandPtr() : state.getWhiteHandPtr());
+	Hand *passive_hand_ptr = (turn % 2 ? state.getWhiteHandPtr() : state.getBlackHandPtr());
+
+	std::uint64_t hash = state.getBoardPtr()->getHash(turn, active_hand_ptr, passive_hand_ptr);
+
+	const Explorer::Stat *stats_ptr = nullptr;
+	std::size_t count = 0;
+
+	auto start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < DATABASE_QUERY_REPEATS; ++i)
+		count = explorer.find(hash, stats_ptr);
+
+	double microseconds = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / DATABASE_QUERY_REPEATS;
+
+	std::cout << "Turn: " << turn << " | Hash: " << std::hex << hash << std::dec << " | Actions: " << count << " | Lookup: " << std::fixed << std::setprecision(3) << microseconds << " us" << std::endl;
+
+	std::vector<const Explorer::Stat*> stat_ptrs;
+
+	for (std::size_t i = 0; i < count; ++i)
+		stat_ptrs.push_back(stats_ptr + i);
+
+	std::sort(stat_ptrs.begin(), stat_ptrs.end(), [](const Explorer::Stat *p_lhs_ptr, const Explorer::Stat *p_rhs_ptr) { return p_lhs_ptr->games > p_rhs_ptr->games; });
+
+	for (auto &elem : stat_ptrs)
+	{
+		char token[NOTATION_MOVE_SIZE + 1];
+		char *end = Notation::writeMove(token, token + NOTATION_MOVE_SIZE, Player::unpack(elem->word), turn, active_hand_ptr, passive_hand_ptr, state.getBoardPtr());
+
+		*(end != nullptr ? end : token) = '\0';
+
+		std::cout << std::left << std::setw(16) << token << std::right << std::setw(10) << elem->games;
+		std::cout << std::setprecision(1) << " | W " << 100.0 * elem->wins / elem->games << "% D " << 100.0 * elem->draws / elem->games << "% L " << 100.0 * elem->losses / elem->games << "%";
+		std::cout << " | Score " << static_cast<double>(elem->score) / elem->games << std::endl;
+	}
+
+	return 0;
+}
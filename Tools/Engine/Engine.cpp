@@ -0,0 +1,619 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Engine.cpp
+ * 
+ * Summary:	Plays headlessly through a line based protocol modelled on USI
+ *		and UCI over standard input and output, so that the engine may be
+ *		driven by tournament managers and analysis pipelines
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Engine [options]
+ * 
+ * Options
+ *	-seed <seed>		Seed of choice among equally scored actions (default random)
+ * 
+ * Commands
+ *	usi, uci		Identifies engine and lists its options
+ *	isready			Answers readyok
+ *	setoption name <name> value <value>
+ *				Level <1-9>, Threads <n>, MCTSNodes <n>, Backend <minimax|mcts>
+ *	usinewgame, ucinewgame	Discards search trees
+ *	position startpos [moves <action> ...]
+ *	position load <file> [moves <action> ...]
+ *	position fen <notation> [moves <action> ...]
+ *	go [depth <plies>] [nodes <n>] [movetime <ms>] [btime <ms>] [wtime <ms>]
+ *	   [binc <ms>] [winc <ms>] [movestogo <n>] [infinite] [ponder]
+ *	stop			Ends search, answering bestmove
+ *	ponderhit		Move pondered upon was played, so time is counted from now
+ *	d			Writes current position
+ *	quit
+ * 
+ * Actions and positions are written as described in Notation.h, sfen being
+ * accepted for fen
+ * Minimax deepens by level up to that set, and only whole depths are reported
+ */
+
+#include "Game/Notation.h"
+#include "Game/State.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <climits>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define ENGINE_LEVEL 9
+#define ENGINE_MAX_THREADS 256
+#define ENGINE_MAX_MCTS_NODES 50000000
+
+#define ENGINE_MOVES_TO_GO 30 // Moves remaining assumed when time control does not say
+#define ENGINE_OVERHEAD 50 // Milliseconds kept back from clock for communication
+
+typedef std::chrono::steady_clock Clock;
+
+struct Limits
+{
+	int depth = 0;
+	std::uint64_t nodes = 0;
+
+	int movetime = 0;
+
+	int time[2] = {}; // Remaining by color, black first
+	int increment[2] = {};
+	int moves_to_go = 0;
+
+	bool infinite = false;
+	bool ponder = false;
+};
+
+// Function prototypes
+// -------------------
+void send(const std::string &p_line_ref); // Writes single line of output whole, as search thread writes alongside main thread
+
+template <typename T>
+bool parse(const std::string &p_value_ref, T &p_number_ref); // Reads whole value as number, leaving specified one as it was otherwise
+
+void identify(const std::string &p_protocol_ref);
+void setOption(std::istringstream &p_stream_ref);
+void setPosition(std::istringstream &p_stream_ref);
+void restore(const std::string &p_origin_ref, const std::vector<State::Entry> &p_record_ref); // Sets position up again from its origin and actions since
+
+void go(std::istringstream &p_stream_ref);
+void ponderhit();
+void stop();
+
+void search(Limits p_limits);
+void watch(int p_budget); // Raises stop flag once time allotted has passed
+
+void report(const State::Search &p_search_ref, Clock::time_point p_start);
+
+// Instance properties
+// -------------------
+State g_state;
+
+bool g_usi = true; // Protocol by which engine was identified, which decides how no action is answered
+
+// Options
+// -------
+int g_level = ENGINE_LEVEL;
+Player::Backend g_backend = Player::MINIMAX;
+
+// Search properties
+// -----------------
+std::thread g_search_thread;
+std::thread g_watch_thread;
+
+std::atomic<bool> g_stop;
+
+std::mutex g_mutex; // Guards properties below, which are waited upon
+std::condition_variable g_condition;
+
+bool g_done = true;
+bool g_pondering;
+bool g_infinite;
+
+int g_budget; // Milliseconds allotted to search, or zero for no limit
+Clock::time_point g_deadline;
+
+std::mutex g_output_mutex;
+
+int main(int argc, char **argv)
+{
+	unsigned int seed = std::random_device()();
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::ENGINE::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-seed")
+		{
+			if (!parse(value, seed))
+			{
+				std::cerr << "ERROR::ENGINE::BAD_VALUE >> " << arg << " " << value << std::endl;
+				return 1;
+			}
+		}
+
+		else
+		{
+			std::cerr << "ERROR::ENGINE::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	g_state.build();
+	g_state.seed(seed);
+
+	int settings[] = { g_level, g_level };
+	g_state.init(settings);
+
+	std::string line;
+
+	while (std::getline(std::cin, line))
+	{
+		std::istringstream stream(line);
+		std::string command;
+
+		if (!(stream >> command))
+			continue;
+
+		if (command == "usi" || command == "uci")
+			identify(command);
+
+		else if (command == "isready")
+			send("readyok");
+
+		else if (command == "setoption")
+			setOption(stream);
+
+		else if (command == "usinewgame" || command == "ucinewgame")
+		{
+			stop();
+
+			g_state.getBlackMCTSPtr()->init();
+			g_state.getWhiteMCTSPtr()->init();
+		}
+
+		else if (command == "position")
+			setPosition(stream);
+
+		else if (command == "go")
+			go(stream);
+
+		else if (command == "ponderhit")
+			ponderhit();
+
+		else if (command == "d")
+		{
+			stop();
+
+			char buffer[NOTATION_POSITION_SIZE * 2];
+			char *end = g_state.writePosition(buffer, buffer + sizeof(buffer));
+
+			if (end != nullptr)
+				send("Fen: " + std::string(buffer, end));
+		}
+
+		else if (command == "stop")
+			stop();
+
+		else if (command == "quit")
+			break;
+
+		else
+			std::cerr << "ERROR::ENGINE::UNKNOWN_COMMAND >> " << command << std::endl;
+	}
+
+	stop();
+
+	return 0;
+}
+
+// Writes single line of output whole, as search thread writes alongside main thread
+void send(const std::string &p_line_ref)
+{
+	std::lock_guard<std::mutex> lock(g_output_mutex);
+	std::cout << p_line_ref << std::endl;
+}
+
+// Reads whole value as number, leaving specified one as it was otherwise
+template <typename T>
+bool parse(const std::string &p_value_ref, T &p_number_ref)
+{
+	T number;
+	std::from_chars_result result = std::from_chars(p_value_ref.data(), p_value_ref.data() + p_value_ref.size(), number);
+
+	if (result.ec != std::errc() || result.ptr != p_value_ref.data() + p_value_ref.size())
+		return false;
+
+	p_number_ref = number;
+	return true;
+}
+
+void identify(const std::string &p_protocol_ref)
+{
+	g_usi = (p_protocol_ref == "usi");
+
+	send("id name Gungi3D");
+	send("id author Chris Malnick");
+
+	send("option name Level type spin default " + std::to_string(ENGINE_LEVEL) + " min 1 max 9");
+	send("option name Threads type spin default 1 min 1 max " + std::to_string(ENGINE_MAX_THREADS));
+	send("option name MCTSNodes type spin default " + std::to_string(MCTS_MAX_NODES) + " min 1 max " + std::to_string(ENGINE_MAX_MCTS_NODES));
+	send("option name Backend type combo default minimax var minimax var mcts");
+	send("option name Ponder type check default false");
+
+	send(g_usi ? "usiok" : "uciok");
+}
+
+// Threads and nodes only bear upon tree search, as minimax searches on single thread without table
+void setOption(std::istringstream &p_stream_ref)
+{
+	std::string token;
+	std::string name;
+	std::string value;
+
+	p_stream_ref >> token;
+
+	if (token != "name")
+	{
+		std::cerr << "ERROR::ENGINE::SETOPTION::NAME_MISSING" << std::endl;
+		return;
+	}
+
+	// Names may span several words, up to value
+	while (p_stream_ref >> token && token != "value")
+		name += (name.empty() ? "" : " ") + token;
+
+	p_stream_ref >> value;
+
+	std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+
+	stop();
+
+	// Spin options ignore values that are not numbers
+	int number = 0;
+	bool numeric = parse(value, number);
+
+	if (!numeric && (name == "level" || name == "threads" || name == "mctsnodes"))
+		std::cerr << "ERROR::ENGINE::SETOPTION::BAD_VALUE >> " << name << " " << value << std::endl;
+
+	else if (name == "level")
+		g_level = std::max(1, std::min(9, number));
+
+	else if (name == "threads")
+	{
+		g_state.getBlackMCTSPtr()->setThreads(number);
+		g_state.getWhiteMCTSPtr()->setThreads(number);
+	}
+
+	else if (name == "mctsnodes")
+	{
+		g_state.getBlackMCTSPtr()->setMaxNodes(std::max(1, std::min(ENGINE_MAX_MCTS_NODES, number)));
+		g_state.getWhiteMCTSPtr()->setMaxNodes(std::max(1, std::min(ENGINE_MAX_MCTS_NODES, number)));
+	}
+
+	else if (name == "backend")
+		g_backend = (value == "mcts" ? Player::MONTE_CARLO : Player::MINIMAX);
+
+	else if (name != "ponder")
+		std::cerr << "ERROR::ENGINE::SETOPTION::UNKNOWN_OPTION >> " << name << std::endl;
+}
+
+// Actions are checked for legality before each is performed, and any after an illegal one are ignored
+void setPosition(std::istringstream &p_stream_ref)
+{
+	std::string token;
+	p_stream_ref >> token;
+
+	stop();
+
+	// Position is kept as its origin and actions since, so that it can be set up again should game or notation fail to load
+	std::string origin = g_state.getOriginRef();
+	std::vector<State::Entry> record = g_state.getRecordRef();
+
+	int settings[] = { g_level, g_level };
+	g_state.init(settings);
+
+	if (token == "load")
+	{
+		std::string path;
+		p_stream_ref >> path;
+
+		if (!g_state.load(path))
+		{
+			send("info string ERROR::ENGINE::POSITION::LOAD_FAILED >> " + path);
+			restore(origin, record);
+
+			return;
+		}
+
+		// Levels recorded in game are those of client, which engine does not play by
+		g_state.getBlackPlayerPtr()->init(g_level);
+		g_state.getWhitePlayerPtr()->init(g_level);
+	}
+
+	// Notation spans several words, up to actions
+	else if (token == "fen" || token == "sfen")
+	{
+		std::string notation;
+
+		while (p_stream_ref >> token && token != "moves")
+			notation += (notation.empty() ? "" : " ") + token;
+
+		if (!g_state.readPosition(notation.data(), notation.data() + notation.size()))
+		{
+			std::cerr << "ERROR::ENGINE::POSITION::BAD_NOTATION >> " << notation << std::endl;
+			restore(origin, record);
+
+			return;
+		}
+
+		if (token != "moves")
+			return;
+	}
+
+	else if (token != "startpos")
+	{
+		std::cerr << "ERROR::ENGINE::POSITION::UNKNOWN_SOURCE >> " << token << std::endl;
+		return;
+	}
+
+	if (token != "moves" && !(p_stream_ref >> token))
+		return;
+
+	if (token != "moves")
+	{
+		std::cerr << "ERROR::ENGINE::POSITION::UNEXPECTED_TOKEN >> " << token << std::endl;
+		return;
+	}
+
+	while (p_stream_ref >> token)
+	{
+		int turn = g_state.getTurn();
+
+		Hand *active_hand_ptr = (turn % 2 ? g_state.getBlackHandPtr() : g_state.getWhiteHandPtr());
+		Hand *passive_hand_ptr = (turn % 2 ? g_state.getWhiteHandPtr() : g_state.getBlackHandPtr());
+
+		Player::Move move;
+
+		if (g_state.gameOver() || !Notation::readMove(token.data(), token.data() + token.size(), move, active_hand_ptr) || !g_state.getActivePlayerPtr()->legal(move, turn, active_hand_ptr, passive_hand_ptr, g_state.getBoardPtr()))
+		{
+			std::cerr << "ERROR::ENGINE::POSITION::ILLEGAL_ACTION >> " << token << std::endl;
+			return;
+		}
+
+		g_state.play(move);
+	}
+}
+
+// Sets position up again from its origin and actions since
+void restore(const std::string &p_origin_ref, const std::vector<State::Entry> &p_record_ref)
+{
+	int settings[] = { g_level, g_level };
+	g_state.init(settings);
+
+	g_state.readPosition(p_origin_ref.data(), p_origin_ref.data() + p_origin_ref.size());
+
+	for (const auto &elem : p_record_ref)
+		g_state.play(elem.move);
+}
+
+void go(std::istringstream &p_stream_ref)
+{
+	stop();
+
+	Limits limits;
+	std::string token;
+
+	while (p_stream_ref >> token)
+	{
+		if (token == "infinite")
+			limits.infinite = true;
+
+		else if (token == "ponder")
+			limits.ponder = true;
+
+		else
+		{
+			std::string value;
+
+			if (!(p_stream_ref >> value))
+			{
+				std::cerr << "ERROR::ENGINE::GO::MISSING_VALUE >> " << token << std::endl;
+				return;
+			}
+
+			// Limits whose values are not numbers are ignored
+			bool parsed = true;
+
+			if (token == "depth")
+				parsed = parse(value, limits.depth);
+
+			else if (token == "nodes")
+				parsed = parse(value, limits.nodes);
+
+			else if (token == "movetime")
+				parsed = parse(value, limits.movetime);
+
+			else if (token == "btime")
+				parsed = parse(value, limits.time[0]);
+
+			else if (token == "wtime")
+				parsed = parse(value, limits.time[1]);
+
+			else if (token == "binc")
+				parsed = parse(value, limits.increment[0]);
+
+			else if (token == "winc")
+				parsed = parse(value, limits.increment[1]);
+
+			else if (token == "movestogo")
+				parsed = parse(value, limits.moves_to_go);
+
+			else
+				std::cerr << "ERROR::ENGINE::GO::UNKNOWN_LIMIT >> " << token << std::endl;
+
+			if (!parsed)
+				std::cerr << "ERROR::ENGINE::GO::BAD_VALUE >> " << token << " " << value << std::endl;
+		}
+	}
+
+	// Clock of active color is shared evenly among moves remaining, keeping back time for communication
+	int color = (g_state.getTurn() % 2 ? 0 : 1);
+	int budget = limits.movetime;
+
+	if (budget == 0 && limits.time[color] > 0)
+	{
+		budget = limits.time[color] / (limits.moves_to_go > 0 ? limits.moves_to_go : ENGINE_MOVES_TO_GO) + limits.increment[color];
+		budget = std::max(1, std::min(budget, limits.time[color] - ENGINE_OVERHEAD));
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+
+		g_done = false;
+		g_pondering = limits.ponder;
+		g_infinite = limits.infinite;
+
+		g_budget = budget;
+		g_deadline = Clock::now() + std::chrono::milliseconds(budget);
+	}
+
+	g_stop = false;
+
+	g_search_thread = std::thread(search, limits);
+	g_watch_thread = std::thread(watch, budget);
+}
+
+// Move pondered upon was played, so time is counted from now
+void ponderhit()
+{
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+
+		g_pondering = false;
+		g_deadline = Clock::now() + std::chrono::milliseconds(g_budget);
+	}
+
+	g_condition.notify_all();
+}
+
+void stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+		g_stop = true;
+	}
+
+	g_condition.notify_all();
+
+	if (g_search_thread.joinable())
+		g_search_thread.join();
+
+	if (g_watch_thread.joinable())
+		g_watch_thread.join();
+}
+
+// Each level completed is reported as it is, and best action once search is done
+void search(Limits p_limits)
+{
+	Clock::time_point start = Clock::now();
+
+	int turn = g_state.getTurn();
+
+	g_state.getActivePlayerPtr()->setBackend(g_backend);
+
+	MCTS *mcts_ptr = (turn % 2 ? g_state.getBlackMCTSPtr() : g_state.getWhiteMCTSPtr());
+	mcts_ptr->setBudget(p_limits.ponder || p_limits.infinite ? INT_MAX : g_budget);
+
+	State::Limits limits;
+	limits.level = g_level;
+	limits.depth = p_limits.depth;
+	limits.nodes = p_limits.nodes;
+
+	State::Search result;
+	bool found = g_state.search(limits, &g_stop, result, [&](const State::Search &p_search_ref) { report(p_search_ref, start); });
+
+	// Infinite search and pondering await being told to stop before answering
+	{
+		std::unique_lock<std::mutex> lock(g_mutex);
+		g_condition.wait(lock, [] { return (g_stop || !(g_infinite || g_pondering)); });
+
+		g_done = true;
+	}
+
+	g_condition.notify_all();
+
+	if (found)
+		send("bestmove " + g_state.format(result.best));
+
+	else
+		send(g_usi ? "bestmove resign" : "bestmove (none)");
+}
+
+// Raises stop flag once time allotted has passed
+// Time is not counted while pondering, nor once stopped
+void watch(int p_budget)
+{
+	std::unique_lock<std::mutex> lock(g_mutex);
+
+	while (!g_done)
+	{
+		if (p_budget <= 0 || g_pondering || g_stop)
+			g_condition.wait(lock);
+
+		else if (g_condition.wait_until(lock, g_deadline) == std::cv_status::timeout && !g_pondering && Clock::now() >= g_deadline)
+		{
+			g_stop = true;
+			g_condition.notify_all();
+		}
+	}
+}
+
+void report(const State::Search &p_search_ref, Clock::time_point p_start)
+{
+	std::int64_t ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - p_start).count();
+
+	std::ostringstream oss;
+	oss << "info depth " << p_search_ref.depth;
+
+	if (p_search_ref.mate != 0)
+		oss << " score mate " << p_search_ref.mate;
+
+	else if (p_search_ref.scored)
+		oss << " score cp " << p_search_ref.best.score;
+
+	oss << " nodes " << p_search_ref.nodes << " nps " << (ms > 0 ? p_search_ref.nodes * 1000 / ms : p_search_ref.nodes) << " time " << ms << " pv " << g_state.format(p_search_ref.best);
+
+	send(oss.str());
+}
@@ -0,0 +1,664 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Fuzzer.cpp
+ * 
+ * Summary:	Plays random games on the current game board while a candidate
+ *		rules engine follows along, comparing positions, legal actions,
+ *		check, and checkmate after every action, and shrinks any mismatch
+ *		to a minimal reproducer
+ *		Mismatches found and fixed before are replayed first, from the
+ *		positions preceding them, so that none can return unnoticed, as
+ *		are scores once taken for checkmate by tools reporting search
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Fuzzer [options]
+ * 
+ * Options
+ *	-g <games>		Number of games (default 1000)
+ *	-c <concurrency>	Games played at once (default number of cores)
+ *	-seed <seed>		Seed of first game, each following game adding one (default random)
+ *	-max <plies>		Plies after arrangement at which games are abandoned (default 300)
+ *	-o <file>		Saved game of position preceding mismatch (default Fuzzer.dat)
+ */
+
+#include "Game/State.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define FUZZER_GAMES 1000
+#define FUZZER_MAX_PLIES 300
+
+// Everything compared between engines after each action
+struct Snapshot
+{
+	std::string position;
+	std::vector<std::string> moves; // Legal actions of color to act, sorted
+
+	bool check[2]; // Black and white
+	bool checkmate[2];
+};
+
+// Rules engine which must agree with live play on the current game board
+class Candidate
+{
+public:
+	virtual ~Candidate() {}
+
+	virtual void reset(State &p_state_ref) = 0; // Adopts position of specified game
+	virtual void play(const Player::Move &p_move_ref) = 0;
+
+	virtual Snapshot snapshot() = 0;
+};
+
+// Simulation path used by search, which acts on copies of the board
+// Any replacement engine is to be compared by implementing Candidate likewise
+class Simulation : public Candidate
+{
+public:
+	void reset(State &p_state_ref) override;
+	void play(const Player::Move &p_move_ref) override;
+
+	Snapshot snapshot() override;
+
+private:
+	inline Hand* getActiveHandPtr() { return (this->m_turn % 2 ? &this->m_black_hands.back() : &this->m_white_hands.back()); }
+	inline Hand* getPassiveHandPtr() { return (this->m_turn % 2 ? &this->m_white_hands.back() : &this->m_black_hands.back()); }
+
+	Player *m_player_ptr;
+	int m_turn;
+
+	// Boards are copied rather than assigned, so each action is simulated on new copy of position before it
+	std::deque<Board> m_boards;
+	std::deque<Hand> m_black_hands;
+	std::deque<Hand> m_white_hands;
+};
+
+// Mismatch found before, replayed from position preceding it
+struct Regression
+{
+	const char *position; // In notation
+	const char *action; // As formatted
+};
+
+const Regression REGRESSIONS[] =
+{
+	// Spy striking Fortress is recovered at once, leaving Fortress standing (seed 9)
+	{ "4P(s+s)3/bF(ABD)PP3T/(PY)1(Sy)2Y2y/C1(py)P1G2(+rS)/8g/+v2pb2p1/tp1R1+P2(+Pa)/2V+p1(+Bc)2+Y/2f1(da)1pp1 A/- w 262 -", "Strike 2,6 > 1,7 + 0,0" },
+};
+
+// Score of minimax at level, along with actions until checkmate it is to be reported as
+struct Mate
+{
+	int score;
+	int level;
+
+	int mate;
+};
+
+const Mate MATES[] =
+{
+	// Evaluations equal to checkmate scored down by some power of two are no checkmate (engine reported mate 15 for 3)
+	{ 3, 9, 0 },
+	{ -7, 9, 0 },
+	{ 953, 9, 0 },
+	{ CHECKMATE >> 2, 9, 0 },
+
+	// Checkmate is only scored at plies minimax determines it upon
+	{ CHECKMATE, 5, 1 },
+	{ CHECKMATE, 4, 0 },
+	{ -(CHECKMATE >> 1), 9, -1 },
+	{ CHECKMATE >> 1, 8, 0 },
+};
+
+struct Result
+{
+	int ply = -1; // Index of action after which engines disagree, or -1 if they do not
+	bool legal = true; // Whether every action replayed was legal
+
+	std::string difference;
+};
+
+// Function prototypes
+// -------------------
+void arrange(State &p_state_ref, unsigned int p_seed); // Plays random arrangement determined by seed
+
+std::string regress(const Regression &p_regression_ref); // Describes mismatch (if any), or why regression could not be replayed
+
+Result replay(unsigned int p_seed, const std::vector<Player::Move> &p_moves_ref, const std::string &p_path_ref = ""); // Saves position preceding mismatch to specified path (if any)
+
+std::vector<Player::Move> shrink(unsigned int p_seed, std::vector<Player::Move> p_moves);
+
+std::string format(const Player::Move &p_move_ref);
+
+std::string describe(Board *p_board_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, int p_turn); // Lists every piece by location and orientation
+
+std::vector<std::string> describe(std::vector<Player::Move> p_moves);
+
+std::string compare(const Snapshot &p_live_ref, const Snapshot &p_candidate_ref); // Describes first difference (if any)
+
+Snapshot snapshot(State &p_state_ref);
+
+void work();
+
+// Instance properties
+// -------------------
+unsigned int g_seed;
+
+NNUE g_network; // Loaded once and shared by every state, as its weights are only read
+
+// Fuzzing properties
+// ------------------
+int g_games = FUZZER_GAMES;
+int g_max_plies = FUZZER_MAX_PLIES;
+
+std::atomic<int> g_next;
+std::atomic<bool> g_done;
+
+std::mutex g_mutex;
+
+int g_played;
+
+// First mismatch found
+int g_failed_game = -1;
+std::vector<Player::Move> g_failed_moves;
+
+int main(int argc, char **argv)
+{
+	g_seed = std::random_device()();
+
+	int concurrency = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	std::string path = "Fuzzer.dat";
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::FUZZER::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-g")
+			g_games = std::stoi(value);
+
+		else if (arg == "-c")
+			concurrency = std::max(1, std::stoi(value));
+
+		else if (arg == "-seed")
+			g_seed = static_cast<unsigned int>(std::stoul(value));
+
+		else if (arg == "-max")
+			g_max_plies = std::stoi(value);
+
+		else if (arg == "-o")
+			path = value;
+
+		else
+		{
+			std::cerr << "ERROR::FUZZER::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	std::cout << "Seed: " << g_seed << std::endl;
+
+	g_network.load(NNUE_PATH);
+
+	for (auto &elem : MATES)
+	{
+		int mate = Player::getMate(elem.score, elem.level);
+
+		if (mate != elem.mate)
+		{
+			std::cout << "Regression of score " << elem.score << " at level " << elem.level << std::endl;
+			std::cout << "Mate " << mate << " where " << elem.mate << " is expected" << std::endl;
+
+			return 1;
+		}
+	}
+
+	for (auto &elem : REGRESSIONS)
+	{
+		std::string difference = regress(elem);
+
+		if (!difference.empty())
+		{
+			std::cout << "Regression from " << elem.position << std::endl;
+			std::cout << difference << std::endl;
+
+			return 1;
+		}
+	}
+
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < concurrency; ++i)
+		threads.push_back(std::thread(work));
+
+	for (auto &elem : threads)
+		elem.join();
+
+	if (g_failed_game < 0)
+	{
+		std::cout << "Games: " << g_played << " | No mismatch" << std::endl;
+		return 0;
+	}
+
+	unsigned int seed = g_seed + g_failed_game;
+
+	std::cout << "Games: " << g_played << " | Mismatch in game with seed " << seed << " after " << g_failed_moves.size() << " actions" << std::endl;
+
+	std::vector<Player::Move> moves = shrink(seed, g_failed_moves);
+	Result result = replay(seed, moves, path);
+
+	std::cout << "Reproducer (seed " << seed << ", " << moves.size() << " actions after arrangement):" << std::endl;
+
+	for (auto &elem : moves)
+		std::cout << "\t" << format(elem) << std::endl;
+
+	std::cout << result.difference << std::endl;
+	std::cout << "Position preceding last action saved to " << path << std::endl;
+
+	return 1;
+}
+
+// Plays random arrangement determined by seed
+void arrange(State &p_state_ref, unsigned int p_seed)
+{
+	p_state_ref.build(&g_network);
+	p_state_ref.seed(p_seed);
+
+	// Level one players choose uniformly among legal actions
+	int settings[] = { 1, 1 };
+	p_state_ref.init(settings);
+
+	while (p_state_ref.getTurn() <= INITIAL_ARRANGEMENT)
+	{
+		p_state_ref.getActivePlayerPtr()->eval();
+		p_state_ref.handleAI();
+	}
+}
+
+// Describes mismatch (if any), or why regression could not be replayed
+std::string regress(const Regression &p_regression_ref)
+{
+	State state;
+	state.build(&g_network);
+
+	int settings[] = { 1, 1 };
+	state.init(settings);
+
+	std::string notation = p_regression_ref.position;
+
+	if (!state.readPosition(notation.data(), notation.data() + notation.size()))
+		return "Position cannot be read";
+
+	int turn = state.getTurn();
+
+	Hand *active_hand_ptr = (turn % 2 ? state.getBlackHandPtr() : state.getWhiteHandPtr());
+	Hand *passive_hand_ptr = (turn % 2 ? state.getWhiteHandPtr() : state.getBlackHandPtr());
+
+	std::vector<Player::Move> legal = state.getActivePlayerPtr()->getMoves(turn, active_hand_ptr, passive_hand_ptr, state.getBoardPtr());
+
+	auto it = std::find_if(legal.begin(), legal.end(), [&](const Player::Move &p_move_ref) { return format(p_move_ref) == p_regression_ref.action; });
+
+	if (it == legal.end())
+		return "Action is not legal: " + std::string(p_regression_ref.action);
+
+	Simulation simulation;
+	simulation.reset(state);
+
+	state.play(*it);
+	simulation.play(*it);
+
+	std::string difference = compare(snapshot(state), simulation.snapshot());
+
+	return (difference.empty() ? "" : "After " + format(*it) + ": " + difference);
+}
+
+// Saves position preceding mismatch to specified path (if any)
+Result replay(unsigned int p_seed, const std::vector<Player::Move> &p_moves_ref, const std::string &p_path_ref)
+{
+	Result result;
+
+	State state;
+	arrange(state, p_seed);
+
+	Simulation simulation;
+	simulation.reset(state);
+
+	for (unsigned int i = 0; i < p_moves_ref.size(); ++i)
+	{
+		Snapshot live = snapshot(state);
+
+		// Actions are compared by description since equivalent moves may differ in unused fields
+		if (!std::binary_search(live.moves.begin(), live.moves.end(), format(p_moves_ref[i])))
+		{
+			result.legal = false;
+			return result;
+		}
+
+		if (!p_path_ref.empty())
+			state.save(p_path_ref);
+
+		state.play(p_moves_ref[i]);
+		simulation.play(p_moves_ref[i]);
+
+		std::string difference = compare(snapshot(state), simulation.snapshot());
+
+		if (!difference.empty())
+		{
+			result.ply = i;
+			result.difference = "After " + format(p_moves_ref[i]) + ": " + difference;
+
+			return result;
+		}
+	}
+
+	return result;
+}
+
+// Removes ever smaller runs of actions preceding mismatch for as long as it still occurs
+// Runs are of even length, since removing odd numbers of actions leaves each remaining one to wrong color
+std::vector<Player::Move> shrink(unsigned int p_seed, std::vector<Player::Move> p_moves)
+{
+	auto even = [](unsigned int p_size) { return std::max(2u, p_size & ~1u); };
+
+	for (unsigned int size = even(p_moves.size() / 2); p_moves.size() > 2;)
+	{
+		bool reduced = false;
+
+		for (unsigned int i = 0; i + 1 < p_moves.size(); i += size)
+		{
+			std::vector<Player::Move> moves(p_moves.begin(), p_moves.begin() + i);
+			moves.insert(moves.end(), p_moves.begin() + std::min<unsigned int>(i + size, p_moves.size() - 1), p_moves.end());
+
+			Result result = replay(p_seed, moves);
+
+			if (result.legal && result.ply >= 0)
+			{
+				moves.resize(result.ply + 1);
+				p_moves = moves;
+
+				reduced = true;
+				break;
+			}
+		}
+
+		if (reduced)
+			size = std::min(size, even(p_moves.size() / 2));
+
+		else if (size > 2)
+			size = even(size / 2);
+
+		else
+			break;
+	}
+
+	return p_moves;
+}
+
+std::string format(const Player::Move &p_move_ref)
+{
+	std::ostringstream oss;
+	oss << FUNCTION_STRINGS[p_move_ref.func] << " " << p_move_ref.src.x << "," << p_move_ref.src.y;
+
+	switch (p_move_ref.func)
+	{
+	case Player::SET:
+	case Player::MOVE:
+		oss << " > " << p_move_ref.dest.x << "," << p_move_ref.dest.y;
+		break;
+
+	case Player::STRIKE:
+		oss << " > " << p_move_ref.dest.x << "," << p_move_ref.dest.y << " + " << p_move_ref.rear.x << "," << p_move_ref.rear.y;
+		break;
+
+	case Player::DOWN:
+	case Player::UP:
+		oss << "," << p_move_ref.src.z << " + " << p_move_ref.rear.x << "," << p_move_ref.rear.y;
+		break;
+
+	default:
+		break;
+	}
+
+	return oss.str();
+}
+
+// Lists every piece by location and orientation
+std::string describe(Board *p_board_ptr, Hand *p_black_hand_ptr, Hand *p_white_hand_ptr, int p_turn)
+{
+	auto piece = [](game::Piece *p_piece_ptr) { return std::to_string(p_piece_ptr->getAlignment()) + ":" + p_piece_ptr->getFrontString() + "/" + p_piece_ptr->getBackString() + ":" + std::to_string(p_piece_ptr->getSide()); };
+
+	std::ostringstream oss;
+	oss << "Turn " << p_turn << ";";
+
+	for (int i = 0; i < BOARD_ROWS; ++i)
+	{
+		for (int j = 0; j < BOARD_COLS; ++j)
+		{
+			for (auto &elem : p_board_ptr->getStackRef(j, i))
+				oss << " " << j << "," << i << "=" << piece(elem);
+		}
+	}
+
+	// Order within hand is immaterial
+	for (Hand *hand_ptr : { p_black_hand_ptr, p_white_hand_ptr })
+	{
+		std::vector<std::string> pieces;
+
+		for (auto &elem : hand_ptr->getPiecePtrs())
+			pieces.push_back(piece(elem));
+
+		std::sort(pieces.begin(), pieces.end());
+
+		oss << ";";
+
+		for (auto &elem : pieces)
+			oss << " " << elem;
+	}
+
+	return oss.str();
+}
+
+std::vector<std::string> describe(std::vector<Player::Move> p_moves)
+{
+	std::vector<std::string> moves;
+
+	for (auto &elem : p_moves)
+		moves.push_back(format(elem));
+
+	std::sort(moves.begin(), moves.end());
+
+	return moves;
+}
+
+// Describes first difference (if any)
+std::string compare(const Snapshot &p_live_ref, const Snapshot &p_candidate_ref)
+{
+	static const std::string COLORS[] = { "black", "white" };
+
+	if (p_live_ref.position != p_candidate_ref.position)
+		return "Position differs\n\tLive:      " + p_live_ref.position + "\n\tCandidate: " + p_candidate_ref.position;
+
+	for (int i = 0; i < 2; ++i)
+	{
+		if (p_live_ref.check[i] != p_candidate_ref.check[i])
+			return "Check of " + COLORS[i] + " differs (live " + std::to_string(p_live_ref.check[i]) + ")";
+
+		if (p_live_ref.checkmate[i] != p_candidate_ref.checkmate[i])
+			return "Checkmate of " + COLORS[i] + " differs (live " + std::to_string(p_live_ref.checkmate[i]) + ")";
+	}
+
+	if (p_live_ref.moves != p_candidate_ref.moves)
+	{
+		std::vector<std::string> missing;
+		std::vector<std::string> extra;
+
+		std::set_difference(p_live_ref.moves.begin(), p_live_ref.moves.end(), p_candidate_ref.moves.begin(), p_candidate_ref.moves.end(), std::back_inserter(missing));
+		std::set_difference(p_candidate_ref.moves.begin(), p_candidate_ref.moves.end(), p_live_ref.moves.begin(), p_live_ref.moves.end(), std::back_inserter(extra));
+
+		std::string difference = "Legal actions differ";
+
+		for (auto &elem : missing)
+			difference += "\n\tMissing: " + elem;
+
+		for (auto &elem : extra)
+			difference += "\n\tExtra:   " + elem;
+
+		return difference;
+	}
+
+	return "";
+}
+
+Snapshot snapshot(State &p_state_ref)
+{
+	Snapshot snapshot;
+
+	int turn = p_state_ref.getTurn();
+	Board *board_ptr = p_state_ref.getBoardPtr();
+
+	Hand *active_hand_ptr = (turn % 2 ? p_state_ref.getBlackHandPtr() : p_state_ref.getWhiteHandPtr());
+	Hand *passive_hand_ptr = (turn % 2 ? p_state_ref.getWhiteHandPtr() : p_state_ref.getBlackHandPtr());
+
+	snapshot.position = describe(board_ptr, p_state_ref.getBlackHandPtr(), p_state_ref.getWhiteHandPtr(), turn);
+	snapshot.moves = describe(p_state_ref.getActivePlayerPtr()->getMoves(turn, active_hand_ptr, passive_hand_ptr, board_ptr));
+
+	snapshot.check[0] = board_ptr->getBlackCheckRef();
+	snapshot.check[1] = board_ptr->getWhiteCheckRef();
+
+	snapshot.checkmate[0] = board_ptr->getBlackCheckmateRef();
+	snapshot.checkmate[1] = board_ptr->getWhiteCheckmateRef();
+
+	return snapshot;
+}
+
+void work()
+{
+	for (int i = g_next++; i < g_games && !g_done; i = g_next++)
+	{
+		State state;
+		arrange(state, g_seed + i);
+
+		Simulation simulation;
+		simulation.reset(state);
+
+		std::vector<Player::Move> moves;
+
+		for (int j = 0; j < g_max_plies && !state.gameOver(); ++j)
+		{
+			int turn = state.getTurn();
+
+			Hand *active_hand_ptr = (turn % 2 ? state.getBlackHandPtr() : state.getWhiteHandPtr());
+			Hand *passive_hand_ptr = (turn % 2 ? state.getWhiteHandPtr() : state.getBlackHandPtr());
+
+			std::vector<Player::Move> legal = state.getActivePlayerPtr()->getMoves(turn, active_hand_ptr, passive_hand_ptr, state.getBoardPtr());
+
+			if (legal.empty())
+				break;
+
+			moves.push_back(legal[state.random(0, legal.size() - 1)]);
+
+			state.getActivePlayerPtr()->play(moves.back());
+			simulation.play(moves.back());
+
+			if (!compare(snapshot(state), simulation.snapshot()).empty())
+			{
+				std::lock_guard<std::mutex> lock(g_mutex);
+
+				// Earliest game is kept so that results do not depend on scheduling
+				if (g_failed_game < 0 || i < g_failed_game)
+				{
+					g_failed_game = i;
+					g_failed_moves = moves;
+				}
+
+				g_done = true;
+
+				break;
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(g_mutex);
+		++g_played;
+	}
+}
+
+// Member functions
+// ----------------
+void Simulation::reset(State &p_state_ref)
+{
+	this->m_player_ptr = p_state_ref.getActivePlayerPtr();
+	this->m_turn = p_state_ref.getTurn();
+
+	this->m_boards.clear();
+	this->m_black_hands.clear();
+	this->m_white_hands.clear();
+
+	this->m_boards.push_back(*p_state_ref.getBoardPtr());
+	this->m_black_hands.push_back(*p_state_ref.getBlackHandPtr());
+	this->m_white_hands.push_back(*p_state_ref.getWhiteHandPtr());
+}
+
+void Simulation::play(const Player::Move &p_move_ref)
+{
+	this->m_boards.push_back(this->m_boards.back());
+	this->m_black_hands.push_back(this->m_black_hands.back());
+	this->m_white_hands.push_back(this->m_white_hands.back());
+
+	this->m_player_ptr->actSim(p_move_ref, this->m_turn, this->getActiveHandPtr(), this->getPassiveHandPtr(), &this->m_boards.back());
+
+	++this->m_turn;
+}
+
+// Check and checkmate are derived as live play does, though checkmate by absence of legal actions
+Snapshot Simulation::snapshot()
+{
+	Snapshot snapshot;
+
+	Board *board_ptr = &this->m_boards.back();
+
+	std::vector<Player::Move> moves = this->m_player_ptr->getMoves(this->m_turn, this->getActiveHandPtr(), this->getPassiveHandPtr(), board_ptr);
+
+	snapshot.position = describe(board_ptr, &this->m_black_hands.back(), &this->m_white_hands.back(), this->m_turn);
+	snapshot.moves = describe(moves);
+
+	snapshot.check[0] = board_ptr->check(game::Piece::BLACK);
+	snapshot.check[1] = board_ptr->check(game::Piece::WHITE);
+
+	// Color which just acted loses by remaining in check, otherwise color to act loses by having no legal action
+	int active = (this->m_turn % 2 ? 1 : 0);
+	int passive = 1 - active;
+
+	snapshot.checkmate[active] = snapshot.check[active];
+	snapshot.checkmate[passive] = !snapshot.check[active] && moves.empty();
+
+	return snapshot;
+}
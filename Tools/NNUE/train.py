@@ -0,0 +1,225 @@
+# ============================================================================
+# Project:	Gungi3D
+# 
+# File:	train.py
+# 
+# Summary:	Trains the evaluation network from self-play samples and writes
+#		the quantized weights loaded by NNUE::load
+# 
+# Origin:	N/A
+# 
+# Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+#		Unauthorized duplication, reproduction, modification, and/or
+#		distribution is strictly prohibited
+#		All materials, including, but not limited to, code, resources
+#		(models, textures, etc.), documents, etc. are deliberately
+#		unlicensed
+# ============================================================================
+# 
+# Samples are lines written by NNUE::writeSample:
+#	<own features>;<opposing features>;<result for own side>
+# where features are comma separated indices and result is 0, 0.5, or 1
+# 
+# Usage:	python train.py <samples> [<samples> ...] [-o Gungi.nnue]
+
+import argparse
+import struct
+
+import numpy as np
+
+# Must match Game/NNUE.h
+MAGIC = 0x554E4E47
+VERSION = 1
+
+BOARD_COLS = 9
+BOARD_ROWS = 9
+MAX_HEIGHT = 3
+FACES = 20
+HAND_DEPTH = 4
+
+FEATURES = BOARD_COLS * BOARD_ROWS * MAX_HEIGHT * FACES * 2 + FACES * HAND_DEPTH * 2
+HIDDEN = 128
+LAYER = 32
+
+ACTIVATION_MAX = 127
+WEIGHT_SCALE = 64
+EVAL_UNIT = 100
+
+WEIGHT_LIMIT = 127 / WEIGHT_SCALE  # Largest dense layer weight representable by int8
+
+
+def load(paths):
+	samples = []
+
+	for path in paths:
+		with open(path) as file:
+			for line in file:
+				fields = line.strip().split(';')
+
+				if len(fields) != 3:
+					continue
+
+				own = [int(elem) for elem in fields[0].split(',') if elem]
+				opp = [int(elem) for elem in fields[1].split(',') if elem]
+
+				samples.append((own, opp, float(fields[2])))
+
+	return samples
+
+
+# Active features are padded to equal length with an extra all zero row
+def batch(samples):
+	width = max(max(len(own), len(opp)) for own, opp, _ in samples)
+
+	own = np.full((len(samples), width), FEATURES, dtype=np.int64)
+	opp = np.full((len(samples), width), FEATURES, dtype=np.int64)
+
+	for i, (elem1, elem2, _) in enumerate(samples):
+		own[i, :len(elem1)] = elem1
+		opp[i, :len(elem2)] = elem2
+
+	results = np.array([elem[2] for elem in samples], dtype=np.float32)
+
+	return own, opp, results
+
+
+class Network:
+	def __init__(self, rng):
+		self.params = {
+			'input_weights': rng.normal(0, 0.05, (FEATURES + 1, HIDDEN)).astype(np.float32),
+			'input_biases': np.full(HIDDEN, 0.25, dtype=np.float32),
+			'hidden_weights': rng.normal(0, 1 / np.sqrt(2 * HIDDEN), (LAYER, 2 * HIDDEN)).astype(np.float32),
+			'hidden_biases': np.zeros(LAYER, dtype=np.float32),
+			'output_weights': rng.normal(0, 1 / np.sqrt(LAYER), LAYER).astype(np.float32),
+			'output_bias': np.zeros(1, dtype=np.float32),
+		}
+
+		self.moments = {key: (np.zeros_like(elem), np.zeros_like(elem)) for key, elem in self.params.items()}
+		self.steps = 0
+
+	def forward(self, own, opp):
+		p = self.params
+
+		self.own = own
+		self.opp = opp
+
+		self.acc = np.concatenate([p['input_weights'][own].sum(axis=1), p['input_weights'][opp].sum(axis=1)], axis=1)
+		self.acc += np.concatenate([p['input_biases'], p['input_biases']])
+
+		self.input = np.clip(self.acc, 0, 1)
+
+		self.pre = self.input @ p['hidden_weights'].T + p['hidden_biases']
+		self.hidden = np.clip(self.pre, 0, 1)
+
+		return self.hidden @ p['output_weights'] + p['output_bias'][0]
+
+	def backward(self, grad_output):
+		p = self.params
+		g = {}
+
+		g['output_weights'] = self.hidden.T @ grad_output
+		g['output_bias'] = np.array([grad_output.sum()], dtype=np.float32)
+
+		grad_hidden = np.outer(grad_output, p['output_weights']) * ((self.pre > 0) & (self.pre < 1))
+
+		g['hidden_weights'] = grad_hidden.T @ self.input
+		g['hidden_biases'] = grad_hidden.sum(axis=0)
+
+		grad_input = (grad_hidden @ p['hidden_weights']) * ((self.acc > 0) & (self.acc < 1))
+
+		g['input_biases'] = grad_input[:, :HIDDEN].sum(axis=0) + grad_input[:, HIDDEN:].sum(axis=0)
+		g['input_weights'] = np.zeros_like(p['input_weights'])
+
+		for features, grad in ((self.own, grad_input[:, :HIDDEN]), (self.opp, grad_input[:, HIDDEN:])):
+			np.add.at(g['input_weights'], features, grad[:, None, :])
+
+		g['input_weights'][FEATURES] = 0
+
+		return g
+
+	# Adam with dense layer weights clipped to their quantized range
+	def step(self, grads, rate, beta1=0.9, beta2=0.999, epsilon=1e-8):
+		self.steps += 1
+
+		for key, grad in grads.items():
+			m, v = self.moments[key]
+
+			m *= beta1
+			m += (1 - beta1) * grad
+
+			v *= beta2
+			v += (1 - beta2) * grad * grad
+
+			m_hat = m / (1 - beta1 ** self.steps)
+			v_hat = v / (1 - beta2 ** self.steps)
+
+			self.params[key] -= rate * m_hat / (np.sqrt(v_hat) + epsilon)
+
+		for key in ('hidden_weights', 'output_weights'):
+			np.clip(self.params[key], -WEIGHT_LIMIT, WEIGHT_LIMIT, out=self.params[key])
+
+	# Layout read by NNUE::load
+	def write(self, path):
+		p = self.params
+
+		quantize = lambda elem, scale, dtype: np.round(elem * scale).clip(np.iinfo(dtype).min, np.iinfo(dtype).max).astype(dtype)
+
+		with open(path, 'wb') as file:
+			file.write(struct.pack('<5I', MAGIC, VERSION, FEATURES, HIDDEN, LAYER))
+
+			file.write(quantize(p['input_biases'], ACTIVATION_MAX, np.int16).astype('<i2').tobytes())
+			file.write(quantize(p['input_weights'][:FEATURES], ACTIVATION_MAX, np.int16).astype('<i2').tobytes())
+
+			file.write(quantize(p['hidden_biases'], ACTIVATION_MAX * WEIGHT_SCALE, np.int32).astype('<i4').tobytes())
+			file.write(quantize(p['hidden_weights'], WEIGHT_SCALE, np.int8).tobytes())
+
+			file.write(quantize(p['output_bias'], ACTIVATION_MAX * WEIGHT_SCALE, np.int32).astype('<i4').tobytes())
+			file.write(quantize(p['output_weights'], WEIGHT_SCALE, np.int8).tobytes())
+
+
+def main():
+	parser = argparse.ArgumentParser(description='Trains the Gungi3D evaluation network')
+
+	parser.add_argument('samples', nargs='+')
+	parser.add_argument('-o', '--output', default='Gungi.nnue')
+	parser.add_argument('-e', '--epochs', type=int, default=10)
+	parser.add_argument('-b', '--batch', type=int, default=1024)
+	parser.add_argument('-r', '--rate', type=float, default=1e-3)
+	parser.add_argument('-k', '--scale', type=float, default=400.0, help='evaluation corresponding to roughly three in four expected result')
+	parser.add_argument('-s', '--seed', type=int, default=0)
+
+	args = parser.parse_args()
+
+	rng = np.random.default_rng(args.seed)
+	samples = load(args.samples)
+
+	if not samples:
+		raise SystemExit('ERROR::TRAIN::NO_SAMPLES')
+
+	network = Network(rng)
+
+	# Output is scaled to evaluation units and mapped to expected result
+	factor = EVAL_UNIT / args.scale
+
+	for epoch in range(args.epochs):
+		order = rng.permutation(len(samples))
+		total = 0.0
+
+		for i in range(0, len(order), args.batch):
+			own, opp, results = batch([samples[j] for j in order[i:i + args.batch]])
+
+			output = network.forward(own, opp)
+			expected = 1 / (1 + np.exp(-output * factor))
+
+			total += float(((expected - results) ** 2).sum())
+
+			grad_output = (2 * (expected - results) * expected * (1 - expected) * factor / len(results)).astype(np.float32)
+			network.step(network.backward(grad_output), args.rate)
+
+		print('epoch %d loss %.6f' % (epoch + 1, total / len(samples)))
+
+	network.write(args.output)
+
+
+if __name__ == '__main__':
+	main()
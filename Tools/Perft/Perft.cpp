@@ -0,0 +1,207 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Perft.cpp
+ * 
+ * Summary:	Counts leaves of the legal move tree from a saved game or a random
+ *		arrangement, reporting the breakdown by action and the speed of
+ *		move generation
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Perft [options]
+ * 
+ * Options
+ *	-d <depth>		Plies to count (default 2)
+ *	-load <file>		Saved game to count from
+ *	-seed <seed>		Seed of random arrangement when no game is loaded (default 0)
+ *	-r <plies>		Random plies after arrangement (default 0)
+ *	-t <threads>		Threads splitting root actions (default number of cores)
+ *	-divide <0|1>		List counts beneath each root action
+ */
+
+#include "Game/Perft.h"
+#include "Game/State.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#define PERFT_DEPTH 2
+
+// Function prototypes
+// -------------------
+std::string format(const Perft::Division &p_division_ref); // Describes root action
+
+void print(const Perft::Counts &p_counts_ref);
+
+int main(int argc, char **argv)
+{
+	int depth = PERFT_DEPTH;
+	int plies = 0;
+
+	unsigned int seed = 0;
+
+	bool divide = false;
+
+	std::string path;
+
+	Perft perft;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::PERFT::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-d")
+			depth = std::stoi(value);
+
+		else if (arg == "-load")
+			path = value;
+
+		else if (arg == "-seed")
+			seed = static_cast<unsigned int>(std::stoul(value));
+
+		else if (arg == "-r")
+			plies = std::stoi(value);
+
+		else if (arg == "-t")
+			perft.setThreads(std::stoi(value));
+
+		else if (arg == "-divide")
+			divide = (value != "0");
+
+		else
+		{
+			std::cerr << "ERROR::PERFT::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	State state;
+	state.build();
+	state.seed(seed);
+
+	// Arrangement is played by level one players, which choose uniformly among legal actions
+	int settings[] = { 1, 1 };
+	state.init(settings);
+
+	if (!path.empty())
+	{
+		if (!state.load(path))
+		{
+			std::cerr << "ERROR::PERFT::LOAD_FAILED >> " << path << std::endl;
+			return 1;
+		}
+	}
+
+	else
+	{
+		while (!state.gameOver() && state.getTurn() <= INITIAL_ARRANGEMENT + plies)
+		{
+			state.getActivePlayerPtr()->eval();
+			state.handleAI();
+		}
+	}
+
+	int turn = state.getTurn();
+
+	// Actions during arrangement are placements, which are not generated as moves
+	if (turn <= INITIAL_ARRANGEMENT)
+	{
+		std::cerr << "ERROR::PERFT::ARRANGEMENT_INCOMPLETE >> Turn " << turn << std::endl;
+		return 1;
+	}
+
+	Player *player_ptr = state.getActivePlayerPtr();
+
+	Hand *active_hand_ptr = (turn % 2 ? state.getBlackHandPtr() : state.getWhiteHandPtr());
+	Hand *passive_hand_ptr = (turn % 2 ? state.getWhiteHandPtr() : state.getBlackHandPtr());
+
+	std::cout << "Turn: " << turn << " | Depth: " << depth << " | Threads: " << perft.getThreads() << std::endl;
+
+	auto start = std::chrono::steady_clock::now();
+
+	Perft::Counts counts;
+
+	if (divide)
+	{
+		for (auto &elem : perft.divide(player_ptr, depth, turn, active_hand_ptr, passive_hand_ptr, state.getBoardPtr()))
+		{
+			std::cout << std::left << std::setw(40) << format(elem) << elem.counts.nodes << std::endl;
+			counts.add(elem.counts);
+		}
+
+		std::cout << std::endl;
+	}
+
+	else
+		counts = perft.count(player_ptr, depth, turn, active_hand_ptr, passive_hand_ptr, state.getBoardPtr());
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	print(counts);
+
+	std::cout << "Time: " << std::fixed << std::setprecision(3) << seconds << " s | Nodes/sec: " << std::setprecision(0) << (seconds > 0.0 ? counts.nodes / seconds : 0.0) << std::endl;
+
+	return 0;
+}
+
+// Describes root action
+std::string format(const Perft::Division &p_division_ref)
+{
+	const Player::Move &move = p_division_ref.move;
+
+	std::ostringstream oss;
+	oss << FUNCTION_STRINGS[move.func] << " " << move.src.x << "," << move.src.y;
+
+	switch (move.func)
+	{
+	case Player::SET:
+	case Player::MOVE:
+	case Player::STRIKE:
+		oss << " > " << move.dest.x << "," << move.dest.y;
+		break;
+
+	case Player::DOWN:
+	case Player::UP:
+		oss << "," << move.src.z;
+		break;
+
+	default:
+		break;
+	}
+
+	if (p_division_ref.rearranged)
+		oss << " + " << move.rear.x << "," << move.rear.y;
+
+	return oss.str();
+}
+
+void print(const Perft::Counts &p_counts_ref)
+{
+	for (int i = 0; i < NUM_FUNCTIONS; ++i)
+		std::cout << std::left << std::setw(16) << FUNCTION_STRINGS[i] << p_counts_ref.functions[i] << std::endl;
+
+	std::cout << std::left << std::setw(16) << "Rearrangements" << p_counts_ref.rearrangements << std::endl;
+	std::cout << std::left << std::setw(16) << "Nodes" << p_counts_ref.nodes << std::endl;
+}
@@ -0,0 +1,838 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Server.cpp
+ * 
+ * Summary:	Hosts many games at once for clients connecting over loopback,
+ *		each game keeping its own state, and searches for engine players
+ *		of all games on shared pool of threads
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Server [options]
+ * 
+ * Options
+ *	-port <port>		Loopback port listened on (default 7878)
+ *	-w <workers>		Threads searching for engine players (default number of cores)
+ *	-games <n>		Games hosted at once (default 1000)
+ *	-movetime <ms>		Time engine searches per action unless game sets it (default 1000)
+ *	-maxtime <ms>		Time engine searches per action at most (default 10000)
+ *	-max <turns>		Turn after which games are drawn (default 1000)
+ *	-seed <seed>		Seed of choice among equally scored actions, each game adding its id (default random)
+ * 
+ * Commands, one per line, each connection hosting single game at a time
+ *	new [engine <b|w|both|none>] [level <1-9>] [movetime <ms>]
+ *				Starts game, discarding one before it, answering game <id>
+ *	move <action>		Performs action of side to move, answering ok
+ *	position		Answers position <notation>
+ *	quit
+ * 
+ * Engine answers move <action> once it has searched, and either side ending
+ * game is followed by over <black|white|draw>, whereas failed commands answer
+ * error <reason>
+ * 
+ * Actions and positions are written as described in Notation.h
+ * Searches are taken up in order they were asked for, and each game has at
+ * most one waiting at a time, so that games share workers evenly however many
+ * actions they perform; time of each is counted from when it is taken up
+ * Games share one network, which is loaded once, and draw from engines of
+ * their own, so that their choices do not depend on which worker takes them
+ * Events are waited upon through epoll, so server is only hosted on Linux
+ */
+
+#include "Game/Notation.h"
+#include "Game/State.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#define SERVER_PORT 7878
+#define SERVER_GAMES 1000
+#define SERVER_LEVEL 9
+#define SERVER_MOVETIME 1000
+#define SERVER_MAX_MOVETIME 10000
+#define SERVER_MAX_TURNS 1000
+
+#define SERVER_BACKLOG 128 // Connections awaiting acceptance
+#define SERVER_EVENTS 64 // Events taken at once from epoll
+#define SERVER_READ_SIZE 4096 // Bytes received at once from connection
+#define SERVER_MAX_LINE 4096 // Connections sending longer lines are closed
+#define SERVER_WATCH_INTERVAL 1 // Milliseconds between checks of search deadlines
+
+typedef std::chrono::steady_clock Clock;
+
+struct Connection;
+
+struct Game
+{
+	int id;
+
+	State state;
+
+	bool engine[2]; // Sides played by engine, black first
+	int level;
+	int movetime;
+
+	Connection *connection_ptr;
+
+	bool searching = false; // Awaiting search, during which state is only touched by worker
+	std::atomic<bool> abandoned { false }; // Connection was closed or moved on, so game is discarded once search returns
+
+	State::Search result; // Of search last returned, whose best action engine plays
+};
+
+struct Connection
+{
+	int descriptor;
+
+	std::string input;
+	std::string output;
+
+	bool writing = false; // Waiting to be writable, output being left over
+	bool closing = false;
+
+	Game *game_ptr = nullptr;
+};
+
+// Search of single worker, stopped by watching thread once its time has passed or its game is abandoned
+struct Slot
+{
+	std::atomic<bool> stop { false };
+
+	std::mutex mutex; // Guards game and deadline, so that search is never stopped by that of one before it
+	Game *game_ptr = nullptr;
+	Clock::time_point deadline;
+};
+
+// Function prototypes
+// -------------------
+void work(int p_index);
+void watch(); // Raises stop flags of searches whose time has passed or whose games are abandoned
+
+void search(Slot &p_slot_ref, Game *p_game_ptr);
+
+#ifdef __linux__
+int serve(int p_port); // Waits upon events until listening fails
+
+void acceptConnections(int p_listener);
+void receiveLines(Connection *p_connection_ptr);
+void flushOutput(Connection *p_connection_ptr);
+void closeConnection(Connection *p_connection_ptr);
+
+void sendLine(Connection *p_connection_ptr, const std::string &p_line_ref);
+
+void handle(Connection *p_connection_ptr, const std::string &p_line_ref);
+void start(Connection *p_connection_ptr, std::istringstream &p_stream_ref);
+void move(Connection *p_connection_ptr, std::istringstream &p_stream_ref);
+
+void advance(Game *p_game_ptr); // Ends game if it is over, or asks for search if engine is to act
+void finish(Game *p_game_ptr); // Performs action engine found, once search returns
+void discard(Game *p_game_ptr); // Game is freed at once, unless search of it has yet to return
+#endif
+
+// Instance properties
+// -------------------
+unsigned int g_seed;
+
+NNUE g_network; // Loaded once and shared by every game, as its weights are only read
+
+// Server properties
+// -----------------
+int g_max_games = SERVER_GAMES;
+int g_movetime = SERVER_MOVETIME;
+int g_max_movetime = SERVER_MAX_MOVETIME;
+int g_max_turns = SERVER_MAX_TURNS;
+
+int g_games; // Hosted, abandoned games included until freed
+int g_next_id = 1;
+
+std::deque<Slot> g_slots;
+
+// Searches, guarded by mutex
+// --------------------------
+std::mutex g_mutex;
+std::condition_variable g_condition;
+
+std::deque<Game*> g_searches; // Waiting to be taken up by workers
+std::vector<Game*> g_returned; // Searched, waiting to be performed by event loop
+
+// Event properties
+// ----------------
+int g_epoll = -1;
+int g_event = -1; // Signalled by workers as searches return
+
+std::unordered_map<int, Connection*> g_connections;
+
+int main(int argc, char **argv)
+{
+	g_seed = std::random_device()();
+
+	int port = SERVER_PORT;
+	int workers = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::SERVER::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-port")
+			port = std::stoi(value);
+
+		else if (arg == "-w")
+			workers = std::max(1, std::stoi(value));
+
+		else if (arg == "-games")
+			g_max_games = std::max(1, std::stoi(value));
+
+		else if (arg == "-movetime")
+			g_movetime = std::max(1, std::stoi(value));
+
+		else if (arg == "-maxtime")
+			g_max_movetime = std::max(1, std::stoi(value));
+
+		else if (arg == "-max")
+			g_max_turns = std::stoi(value);
+
+		else if (arg == "-seed")
+			g_seed = static_cast<unsigned int>(std::stoul(value));
+
+		else
+		{
+			std::cerr << "ERROR::SERVER::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+#ifdef __linux__
+	g_network.load(NNUE_PATH);
+
+	g_slots.resize(workers);
+
+	std::thread watch_thread(watch);
+	watch_thread.detach();
+
+	for (int i = 0; i < workers; ++i)
+		std::thread(work, i).detach();
+
+	return serve(port);
+#else
+	std::cerr << "ERROR::SERVER::UNSUPPORTED_PLATFORM" << std::endl;
+	return 1;
+#endif
+}
+
+void work(int p_index)
+{
+	while (true)
+	{
+		Game *game_ptr;
+
+		{
+			std::unique_lock<std::mutex> lock(g_mutex);
+			g_condition.wait(lock, [] { return !g_searches.empty(); });
+
+			game_ptr = g_searches.front();
+			g_searches.pop_front();
+		}
+
+		if (!game_ptr->abandoned)
+			search(g_slots[p_index], game_ptr);
+
+		{
+			std::lock_guard<std::mutex> lock(g_mutex);
+			g_returned.push_back(game_ptr);
+		}
+
+#ifdef __linux__
+		std::uint64_t count = 1;
+
+		if (::write(g_event, &count, sizeof(count)) < 0)
+			std::cerr << "ERROR::SERVER::SIGNAL_FAILED" << std::endl;
+#endif
+	}
+}
+
+// Raises stop flags of searches whose time has passed or whose games are abandoned
+void watch()
+{
+	while (true)
+	{
+		Clock::time_point now = Clock::now();
+
+		for (auto &elem : g_slots)
+		{
+			std::lock_guard<std::mutex> lock(elem.mutex);
+
+			if (elem.game_ptr != nullptr && (now >= elem.deadline || elem.game_ptr->abandoned))
+				elem.stop = true;
+		}
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(SERVER_WATCH_INTERVAL));
+	}
+}
+
+// Searches by level set, until slot is stopped
+void search(Slot &p_slot_ref, Game *p_game_ptr)
+{
+	State *state_ptr = &p_game_ptr->state;
+
+	int turn = state_ptr->getTurn();
+
+	MCTS *mcts_ptr = (turn % 2 ? state_ptr->getBlackMCTSPtr() : state_ptr->getWhiteMCTSPtr());
+	mcts_ptr->setBudget(p_game_ptr->movetime);
+
+	{
+		std::lock_guard<std::mutex> lock(p_slot_ref.mutex);
+
+		p_slot_ref.stop = false;
+		p_slot_ref.game_ptr = p_game_ptr;
+		p_slot_ref.deadline = Clock::now() + std::chrono::milliseconds(p_game_ptr->movetime);
+	}
+
+	State::Limits limits;
+	limits.level = p_game_ptr->level;
+
+	p_game_ptr->result = State::Search();
+	state_ptr->search(limits, &p_slot_ref.stop, p_game_ptr->result);
+
+	{
+		std::lock_guard<std::mutex> lock(p_slot_ref.mutex);
+		p_slot_ref.game_ptr = nullptr;
+	}
+}
+
+#ifdef __linux__
+// Waits upon events until listening fails
+// Connections and games are only touched by this thread, besides states being searched by workers
+int serve(int p_port)
+{
+	int listener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+	if (listener < 0)
+	{
+		std::cerr << "ERROR::SERVER::SOCKET_FAILED" << std::endl;
+		return 1;
+	}
+
+	int reuse = 1;
+	setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+	sockaddr_in address = {};
+
+	address.sin_family = AF_INET;
+	address.sin_port = htons(static_cast<std::uint16_t>(p_port));
+	address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, SERVER_BACKLOG) < 0)
+	{
+		std::cerr << "ERROR::SERVER::LISTEN_FAILED >> " << p_port << std::endl;
+		return 1;
+	}
+
+	g_epoll = epoll_create1(EPOLL_CLOEXEC);
+	g_event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+	if (g_epoll < 0 || g_event < 0)
+	{
+		std::cerr << "ERROR::SERVER::EPOLL_FAILED" << std::endl;
+		return 1;
+	}
+
+	epoll_event event = {};
+	event.events = EPOLLIN;
+
+	event.data.fd = listener;
+	epoll_ctl(g_epoll, EPOLL_CTL_ADD, listener, &event);
+
+	event.data.fd = g_event;
+	epoll_ctl(g_epoll, EPOLL_CTL_ADD, g_event, &event);
+
+	std::cout << "Listening on 127.0.0.1:" << p_port << std::endl;
+
+	epoll_event events[SERVER_EVENTS];
+
+	while (true)
+	{
+		int count = epoll_wait(g_epoll, events, SERVER_EVENTS, -1);
+
+		if (count < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			std::cerr << "ERROR::SERVER::WAIT_FAILED" << std::endl;
+			return 1;
+		}
+
+		for (int i = 0; i < count; ++i)
+		{
+			int descriptor = events[i].data.fd;
+
+			if (descriptor == listener)
+				acceptConnections(listener);
+
+			else if (descriptor == g_event)
+			{
+				std::uint64_t signals;
+
+				if (::read(g_event, &signals, sizeof(signals)) < 0 && errno != EAGAIN)
+					std::cerr << "ERROR::SERVER::SIGNAL_FAILED" << std::endl;
+
+				std::vector<Game*> returned;
+
+				{
+					std::lock_guard<std::mutex> lock(g_mutex);
+					returned.swap(g_returned);
+				}
+
+				for (auto &elem : returned)
+					finish(elem);
+			}
+
+			else
+			{
+				auto it = g_connections.find(descriptor);
+
+				if (it == g_connections.end())
+					continue;
+
+				Connection *connection_ptr = it->second;
+
+				if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+					receiveLines(connection_ptr);
+
+				if ((events[i].events & EPOLLOUT) && !connection_ptr->closing)
+					flushOutput(connection_ptr);
+			}
+		}
+
+		// Connections are closed once their events are handled, as games returning from search may have written to them too
+		for (auto it = g_connections.begin(); it != g_connections.end(); )
+		{
+			Connection *connection_ptr = it->second;
+
+			if (connection_ptr->closing)
+			{
+				it = g_connections.erase(it);
+				closeConnection(connection_ptr);
+			}
+
+			else
+				++it;
+		}
+	}
+}
+
+void acceptConnections(int p_listener)
+{
+	while (true)
+	{
+		int descriptor = accept4(p_listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+		if (descriptor < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR && errno != ECONNABORTED)
+				std::cerr << "ERROR::SERVER::ACCEPT_FAILED" << std::endl;
+
+			if (errno == EINTR || errno == ECONNABORTED)
+				continue;
+
+			return;
+		}
+
+		// Lines are short and answered at once, so they are not held back for coalescing
+		int delay = 1;
+		setsockopt(descriptor, IPPROTO_TCP, TCP_NODELAY, &delay, sizeof(delay));
+
+		Connection *connection_ptr = new Connection;
+		connection_ptr->descriptor = descriptor;
+
+		epoll_event event = {};
+
+		event.events = EPOLLIN;
+		event.data.fd = descriptor;
+
+		epoll_ctl(g_epoll, EPOLL_CTL_ADD, descriptor, &event);
+
+		g_connections[descriptor] = connection_ptr;
+	}
+}
+
+// Handles each whole line received, keeping partial one for next time
+void receiveLines(Connection *p_connection_ptr)
+{
+	char buffer[SERVER_READ_SIZE];
+
+	while (!p_connection_ptr->closing)
+	{
+		ssize_t size = ::recv(p_connection_ptr->descriptor, buffer, sizeof(buffer), 0);
+
+		if (size < 0 && errno == EINTR)
+			continue;
+
+		if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+
+		if (size <= 0)
+		{
+			p_connection_ptr->closing = true;
+			break;
+		}
+
+		p_connection_ptr->input.append(buffer, size);
+
+		std::size_t first = 0;
+		std::size_t last;
+
+		while (!p_connection_ptr->closing && (last = p_connection_ptr->input.find('\n', first)) != std::string::npos)
+		{
+			std::string line = p_connection_ptr->input.substr(first, last - first);
+
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+
+			handle(p_connection_ptr, line);
+
+			first = last + 1;
+		}
+
+		p_connection_ptr->input.erase(0, first);
+
+		if (p_connection_ptr->input.size() > SERVER_MAX_LINE)
+			p_connection_ptr->closing = true;
+	}
+}
+
+// Writes output left over, waiting to be writable again if not all of it is taken
+void flushOutput(Connection *p_connection_ptr)
+{
+	std::size_t written = 0;
+
+	while (written < p_connection_ptr->output.size())
+	{
+		ssize_t size = ::send(p_connection_ptr->descriptor, p_connection_ptr->output.data() + written, p_connection_ptr->output.size() - written, MSG_NOSIGNAL);
+
+		if (size < 0 && errno == EINTR)
+			continue;
+
+		if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			break;
+
+		if (size < 0)
+		{
+			p_connection_ptr->closing = true;
+			return;
+		}
+
+		written += static_cast<std::size_t>(size);
+	}
+
+	p_connection_ptr->output.erase(0, written);
+
+	bool writing = !p_connection_ptr->output.empty();
+
+	if (writing != p_connection_ptr->writing)
+	{
+		epoll_event event = {};
+
+		event.events = (writing ? EPOLLIN | EPOLLOUT : EPOLLIN);
+		event.data.fd = p_connection_ptr->descriptor;
+
+		epoll_ctl(g_epoll, EPOLL_CTL_MOD, p_connection_ptr->descriptor, &event);
+
+		p_connection_ptr->writing = writing;
+	}
+}
+
+void closeConnection(Connection *p_connection_ptr)
+{
+	if (p_connection_ptr->game_ptr != nullptr)
+		discard(p_connection_ptr->game_ptr);
+
+	::close(p_connection_ptr->descriptor);
+
+	delete p_connection_ptr;
+}
+
+void sendLine(Connection *p_connection_ptr, const std::string &p_line_ref)
+{
+	if (p_connection_ptr->closing)
+		return;
+
+	p_connection_ptr->output += p_line_ref;
+	p_connection_ptr->output += '\n';
+
+	// Output left over is written once connection is writable, in order
+	if (!p_connection_ptr->writing)
+		flushOutput(p_connection_ptr);
+}
+
+void handle(Connection *p_connection_ptr, const std::string &p_line_ref)
+{
+	std::istringstream stream(p_line_ref);
+	std::string command;
+
+	if (!(stream >> command))
+		return;
+
+	if (command == "new")
+		start(p_connection_ptr, stream);
+
+	else if (command == "move")
+		move(p_connection_ptr, stream);
+
+	else if (command == "position")
+	{
+		Game *game_ptr = p_connection_ptr->game_ptr;
+
+		if (game_ptr == nullptr)
+			sendLine(p_connection_ptr, "error NO_GAME");
+
+		else if (game_ptr->searching)
+			sendLine(p_connection_ptr, "error SEARCHING");
+
+		else
+		{
+			char buffer[NOTATION_POSITION_SIZE * 2];
+			char *end = game_ptr->state.writePosition(buffer, buffer + sizeof(buffer));
+
+			sendLine(p_connection_ptr, (end != nullptr ? "position " + std::string(buffer, end) : std::string("error POSITION_TOO_LONG")));
+		}
+	}
+
+	else if (command == "quit")
+		p_connection_ptr->closing = true;
+
+	else
+		sendLine(p_connection_ptr, "error UNKNOWN_COMMAND");
+}
+
+// Engine plays by level set, whereas sides played by client are checked for legality alone
+void start(Connection *p_connection_ptr, std::istringstream &p_stream_ref)
+{
+	std::string engine = "none";
+	int level = SERVER_LEVEL;
+	int movetime = g_movetime;
+
+	std::string token;
+	std::string value;
+
+	while (p_stream_ref >> token)
+	{
+		if (!(p_stream_ref >> value))
+		{
+			sendLine(p_connection_ptr, "error MISSING_VALUE");
+			return;
+		}
+
+		if (token == "engine" && (value == "b" || value == "w" || value == "both" || value == "none"))
+			engine = value;
+
+		else if (token == "level" && value.find_first_not_of("0123456789") == std::string::npos && value.size() == 1)
+			level = std::max(1, std::stoi(value));
+
+		else if (token == "movetime" && value.find_first_not_of("0123456789") == std::string::npos && value.size() <= 9)
+			movetime = std::max(1, std::min(g_max_movetime, std::stoi(value)));
+
+		else
+		{
+			sendLine(p_connection_ptr, "error BAD_OPTION");
+			return;
+		}
+	}
+
+	if (p_connection_ptr->game_ptr != nullptr)
+	{
+		discard(p_connection_ptr->game_ptr);
+		p_connection_ptr->game_ptr = nullptr;
+	}
+
+	if (g_games >= g_max_games)
+	{
+		sendLine(p_connection_ptr, "error TOO_MANY_GAMES");
+		return;
+	}
+
+	Game *game_ptr = new Game;
+	++g_games;
+
+	game_ptr->id = g_next_id++;
+
+	game_ptr->engine[0] = (engine == "b" || engine == "both");
+	game_ptr->engine[1] = (engine == "w" || engine == "both");
+
+	game_ptr->level = level;
+	game_ptr->movetime = std::min(movetime, g_max_movetime);
+
+	game_ptr->connection_ptr = p_connection_ptr;
+
+	// Sides played by client are not controlled through interaction, so that no legal actions are determined in background
+	int settings[] = { level, level };
+
+	game_ptr->state.build(&g_network);
+	game_ptr->state.seed(g_seed + game_ptr->id);
+	game_ptr->state.init(settings);
+
+	p_connection_ptr->game_ptr = game_ptr;
+
+	sendLine(p_connection_ptr, "game " + std::to_string(game_ptr->id));
+
+	advance(game_ptr);
+}
+
+void move(Connection *p_connection_ptr, std::istringstream &p_stream_ref)
+{
+	Game *game_ptr = p_connection_ptr->game_ptr;
+
+	std::string token;
+	p_stream_ref >> token;
+
+	if (game_ptr == nullptr)
+	{
+		sendLine(p_connection_ptr, "error NO_GAME");
+		return;
+	}
+
+	State *state_ptr = &game_ptr->state;
+
+	int turn = state_ptr->getTurn();
+
+	if (state_ptr->gameOver() || turn > g_max_turns)
+	{
+		sendLine(p_connection_ptr, "error GAME_OVER");
+		return;
+	}
+
+	if (game_ptr->searching || game_ptr->engine[turn % 2 ? 0 : 1])
+	{
+		sendLine(p_connection_ptr, "error NOT_YOUR_TURN");
+		return;
+	}
+
+	Hand *active_hand_ptr = state_ptr->getHandPtr(turn % 2 ? game::Piece::BLACK : game::Piece::WHITE);
+	Hand *passive_hand_ptr = state_ptr->getHandPtr(turn % 2 ? game::Piece::WHITE : game::Piece::BLACK);
+
+	Player::Move move;
+
+	if (!Notation::readMove(token.data(), token.data() + token.size(), move, active_hand_ptr) || !state_ptr->getActivePlayerPtr()->legal(move, turn, active_hand_ptr, passive_hand_ptr, state_ptr->getBoardPtr()))
+	{
+		sendLine(p_connection_ptr, "error ILLEGAL_ACTION");
+		return;
+	}
+
+	state_ptr->play(move);
+
+	sendLine(p_connection_ptr, "ok");
+
+	advance(game_ptr);
+}
+
+// Ends game if it is over, or asks for search if engine is to act
+void advance(Game *p_game_ptr)
+{
+	State *state_ptr = &p_game_ptr->state;
+
+	int turn = state_ptr->getTurn();
+
+	if (state_ptr->getBoardPtr()->getWhiteCheckmateRef())
+		sendLine(p_game_ptr->connection_ptr, "over black");
+
+	else if (state_ptr->getBoardPtr()->getBlackCheckmateRef())
+		sendLine(p_game_ptr->connection_ptr, "over white");
+
+	else if (state_ptr->stalemate() || turn > g_max_turns)
+		sendLine(p_game_ptr->connection_ptr, "over draw");
+
+	else if (p_game_ptr->engine[turn % 2 ? 0 : 1])
+	{
+		p_game_ptr->searching = true;
+
+		{
+			std::lock_guard<std::mutex> lock(g_mutex);
+			g_searches.push_back(p_game_ptr);
+		}
+
+		g_condition.notify_one();
+	}
+}
+
+// Performs action engine found, once search returns
+void finish(Game *p_game_ptr)
+{
+	p_game_ptr->searching = false;
+
+	if (p_game_ptr->abandoned)
+	{
+		delete p_game_ptr;
+		--g_games;
+
+		return;
+	}
+
+	if (!p_game_ptr->result.found)
+	{
+		sendLine(p_game_ptr->connection_ptr, "error ENGINE_FAILED");
+		return;
+	}
+
+	std::string token = p_game_ptr->state.format(p_game_ptr->result.best);
+
+	p_game_ptr->state.play(p_game_ptr->result.best);
+
+	sendLine(p_game_ptr->connection_ptr, "move " + token);
+
+	advance(p_game_ptr);
+}
+
+// Game is freed at once, unless search of it has yet to return
+void discard(Game *p_game_ptr)
+{
+	if (p_game_ptr->searching)
+	{
+		p_game_ptr->abandoned = true;
+		return;
+	}
+
+	delete p_game_ptr;
+	--g_games;
+}
+#endif
@@ -0,0 +1,499 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Tournament.cpp
+ * 
+ * Summary:	Plays engine configurations against each other headlessly, one
+ *		game per core, and reports Elo difference with error bars along
+ *		with a sequential probability ratio test verdict
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Usage:	Tournament -a <engine> -b <engine> [options]
+ * 
+ * Engines are comma separated settings, e.g. level=5,backend=mcts,time=500
+ *	level=<1-9>		CPU level (default 1)
+ *	backend=<minimax|mcts>	Search backend (default minimax)
+ *	eval=<hand|nnue>	Evaluation (default hand)
+ *	time=<ms>		MCTS time per move (default allotted by level)
+ *	threads=<n>		MCTS threads (default 1)
+ *	policy=<uct|puct>	MCTS selection policy (default puct)
+ *	parallel=<root|tree>	MCTS parallelism (default tree)
+ * 
+ * Options
+ *	-g <games>		Maximum number of games (default 100)
+ *	-c <concurrency>	Games played at once (default number of cores)
+ *	-r <plies>		Random plies after arrangement (default 8)
+ *	-book <file>,...	Saved games to start from instead of random openings
+ *	-max <turns>		Turn after which games are drawn (default 1000)
+ *	-seed <seed>		Seed of openings (default random)
+ *	-sprt <elo0>,<elo1>	Stop once either hypothesis is accepted
+ *	-alpha <a> -beta <b>	Error rates of test (default 0.05)
+ *	-nnue <file>		Append network training samples
+ *	-terms <file>		Append tuner samples
+ *	-records <dir>		Save record of each game, e.g. for database tool to index
+ */
+
+#include "Game/State.h"
+
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TOURNAMENT_GAMES 100
+#define TOURNAMENT_RANDOM_PLIES 8
+#define TOURNAMENT_MAX_TURNS 1000
+
+struct Engine
+{
+	int level = 1;
+
+	Player::Backend backend = Player::MINIMAX;
+	Player::Evaluation evaluation = Player::HANDCRAFTED;
+
+	int time = 0;
+	int threads = 1;
+
+	MCTS::Policy policy = MCTS::PUCT;
+	MCTS::Parallelism parallelism = MCTS::TREE;
+
+	std::string name;
+};
+
+struct Sample
+{
+	std::string nnue; // Network sample without result
+	std::string terms; // Tuner sample without result
+
+	game::Piece::Color color; // Color for which result is recorded
+};
+
+// Function prototypes
+// -------------------
+bool parseEngine(const std::string &p_spec_ref, Engine &p_engine_ref);
+
+void configure(Player *p_player_ptr, MCTS *p_mcts_ptr, const Engine &p_engine_ref);
+
+float play(int p_index, const Engine &p_black_ref, const Engine &p_white_ref); // Returns score of black
+
+void work();
+
+void report();
+
+double getLLR();
+
+// Instance properties
+// -------------------
+unsigned int g_seed;
+
+NNUE g_network; // Loaded once and shared by every game, as its weights are only read
+
+// Tournament properties
+// ---------------------
+Engine g_engine_a;
+Engine g_engine_b;
+
+int g_games = TOURNAMENT_GAMES;
+int g_random_plies = TOURNAMENT_RANDOM_PLIES;
+int g_max_turns = TOURNAMENT_MAX_TURNS;
+
+std::vector<std::string> g_book;
+
+bool g_sprt;
+
+double g_elo0;
+double g_elo1;
+
+double g_alpha = 0.05;
+double g_beta = 0.05;
+
+std::ofstream g_nnue_file;
+std::ofstream g_terms_file;
+
+std::string g_records_path;
+
+// Results from perspective of engine A
+// ------------------------------------
+std::atomic<int> g_next;
+std::atomic<bool> g_done;
+
+std::mutex g_mutex;
+
+int g_wins;
+int g_draws;
+int g_losses;
+
+int main(int argc, char **argv)
+{
+	g_seed = std::random_device()();
+
+	bool engine_a = false;
+	bool engine_b = false;
+
+	int concurrency = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		std::string value = (i + 1 < argc ? argv[i + 1] : "");
+
+		if (i + 1 < argc)
+			++i;
+
+		else
+		{
+			std::cerr << "ERROR::TOURNAMENT::MISSING_VALUE >> " << arg << std::endl;
+			return 1;
+		}
+
+		if (arg == "-a")
+			engine_a = parseEngine(value, g_engine_a);
+
+		else if (arg == "-b")
+			engine_b = parseEngine(value, g_engine_b);
+
+		else if (arg == "-g")
+			g_games = std::stoi(value);
+
+		else if (arg == "-c")
+			concurrency = std::max(1, std::stoi(value));
+
+		else if (arg == "-r")
+			g_random_plies = std::stoi(value);
+
+		else if (arg == "-max")
+			g_max_turns = std::stoi(value);
+
+		else if (arg == "-seed")
+			g_seed = static_cast<unsigned int>(std::stoul(value));
+
+		else if (arg == "-alpha")
+			g_alpha = std::stod(value);
+
+		else if (arg == "-beta")
+			g_beta = std::stod(value);
+
+		else if (arg == "-book")
+		{
+			std::istringstream iss(value);
+			std::string token;
+
+			while (std::getline(iss, token, ','))
+				g_book.push_back(token);
+		}
+
+		else if (arg == "-sprt")
+		{
+			std::size_t pos = value.find(',');
+
+			if (pos == std::string::npos)
+			{
+				std::cerr << "ERROR::TOURNAMENT::BAD_SPRT >> " << value << std::endl;
+				return 1;
+			}
+
+			g_sprt = true;
+
+			g_elo0 = std::stod(value.substr(0, pos));
+			g_elo1 = std::stod(value.substr(pos + 1));
+		}
+
+		else if (arg == "-nnue")
+			g_nnue_file.open(value, std::ios_base::out | std::ios_base::app);
+
+		else if (arg == "-terms")
+			g_terms_file.open(value, std::ios_base::out | std::ios_base::app);
+
+		else if (arg == "-records")
+			g_records_path = value;
+
+		else
+		{
+			std::cerr << "ERROR::TOURNAMENT::UNKNOWN_OPTION >> " << arg << std::endl;
+			return 1;
+		}
+	}
+
+	if (!engine_a || !engine_b)
+	{
+		std::cerr << "ERROR::TOURNAMENT::ENGINES_UNSPECIFIED" << std::endl;
+		return 1;
+	}
+
+	std::cout << "A: " << g_engine_a.name << std::endl;
+	std::cout << "B: " << g_engine_b.name << std::endl;
+
+	g_network.load(NNUE_PATH);
+
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < concurrency; ++i)
+		threads.push_back(std::thread(work));
+
+	for (auto &elem : threads)
+		elem.join();
+
+	return 0;
+}
+
+bool parseEngine(const std::string &p_spec_ref, Engine &p_engine_ref)
+{
+	std::istringstream iss1(p_spec_ref);
+	std::string token1;
+
+	p_engine_ref.name = p_spec_ref;
+
+	while (std::getline(iss1, token1, ','))
+	{
+		std::size_t pos = token1.find('=');
+
+		std::string key = token1.substr(0, pos);
+		std::string value = (pos == std::string::npos ? "" : token1.substr(pos + 1));
+
+		if (key == "level")
+			p_engine_ref.level = std::min(9, std::max(1, std::stoi(value)));
+
+		else if (key == "backend")
+			p_engine_ref.backend = (value == "mcts" ? Player::MONTE_CARLO : Player::MINIMAX);
+
+		else if (key == "eval")
+			p_engine_ref.evaluation = (value == "nnue" ? Player::NEURAL : Player::HANDCRAFTED);
+
+		else if (key == "time")
+			p_engine_ref.time = std::stoi(value);
+
+		else if (key == "threads")
+			p_engine_ref.threads = std::stoi(value);
+
+		else if (key == "policy")
+			p_engine_ref.policy = (value == "uct" ? MCTS::UCT : MCTS::PUCT);
+
+		else if (key == "parallel")
+			p_engine_ref.parallelism = (value == "root" ? MCTS::ROOT : MCTS::TREE);
+
+		else
+		{
+			std::cerr << "ERROR::TOURNAMENT::UNKNOWN_SETTING >> " << token1 << std::endl;
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void configure(Player *p_player_ptr, MCTS *p_mcts_ptr, const Engine &p_engine_ref)
+{
+	p_player_ptr->init(p_engine_ref.level);
+
+	p_player_ptr->setBackend(p_engine_ref.backend);
+	p_player_ptr->setEvaluation(p_engine_ref.evaluation);
+
+	p_mcts_ptr->setBudget(p_engine_ref.time);
+	p_mcts_ptr->setThreads(p_engine_ref.threads);
+
+	p_mcts_ptr->setPolicy(p_engine_ref.policy);
+	p_mcts_ptr->setParallelism(p_engine_ref.parallelism);
+}
+
+// Returns score of black
+// Both games of a pair share their opening so that neither engine is favored by it
+float play(int p_index, const Engine &p_black_ref, const Engine &p_white_ref)
+{
+	State state;
+	state.build(&g_network);
+	state.seed(g_seed + p_index / 2);
+
+	// Openings are played by level one players, which choose uniformly among legal actions
+	int settings[] = { 1, 1 };
+	state.init(settings);
+
+	if (!g_book.empty())
+	{
+		state.load(g_book[(p_index / 2) % g_book.size()]);
+
+		state.getBlackPlayerPtr()->init(1);
+		state.getWhitePlayerPtr()->init(1);
+	}
+
+	std::vector<Sample> samples;
+	NNUE network; // Only lists features of samples, so it needs no weights
+
+	int opening = (g_book.empty() ? INITIAL_ARRANGEMENT + g_random_plies : state.getTurn() - 1);
+
+	while (!state.gameOver() && state.getTurn() <= g_max_turns)
+	{
+		if (state.getTurn() == opening + 1)
+		{
+			configure(state.getBlackPlayerPtr(), state.getBlackMCTSPtr(), p_black_ref);
+			configure(state.getWhitePlayerPtr(), state.getWhiteMCTSPtr(), p_white_ref);
+		}
+
+		state.getActivePlayerPtr()->eval();
+		state.handleAI();
+
+		int turn = state.getTurn();
+
+		// Positions are sampled once out of opening with their active color to move
+		if (turn > opening && (g_nnue_file.is_open() || g_terms_file.is_open()))
+		{
+			game::Piece::Color active = (turn % 2 ? game::Piece::BLACK : game::Piece::WHITE);
+
+			Hand *active_hand_ptr = (active == game::Piece::BLACK ? state.getBlackHandPtr() : state.getWhiteHandPtr());
+			Hand *passive_hand_ptr = (active == game::Piece::BLACK ? state.getWhiteHandPtr() : state.getBlackHandPtr());
+
+			std::ostringstream oss1;
+			std::ostringstream oss2;
+
+			if (g_nnue_file.is_open())
+				network.writeSample(oss1, 0.0f, active, state.getBlackHandPtr(), state.getWhiteHandPtr(), state.getBoardPtr());
+
+			if (g_terms_file.is_open())
+				state.getActivePlayerPtr()->writeSample(oss2, 0.0f, turn, active_hand_ptr, passive_hand_ptr, state.getBoardPtr());
+
+			samples.push_back({ oss1.str(), oss2.str(), active });
+		}
+	}
+
+	if (!g_records_path.empty())
+		state.saveRecord(g_records_path + "/" + std::to_string(p_index) + ".rec");
+
+	float black_score = 0.5f;
+
+	if (state.getBoardPtr()->getBlackCheckmateRef())
+		black_score = 0.0f;
+
+	else if (state.getBoardPtr()->getWhiteCheckmateRef())
+		black_score = 1.0f;
+
+	if (!samples.empty())
+	{
+		std::lock_guard<std::mutex> lock(g_mutex);
+
+		// Placeholder results are replaced now that the outcome is known
+		for (auto &elem : samples)
+		{
+			float result = (elem.color == game::Piece::BLACK ? black_score : 1.0f - black_score);
+
+			if (g_nnue_file.is_open())
+				g_nnue_file << elem.nnue.substr(0, elem.nnue.rfind(';') + 1) << result << std::endl;
+
+			if (g_terms_file.is_open())
+				g_terms_file << elem.terms.substr(0, elem.terms.rfind(';') + 1) << result << std::endl;
+		}
+	}
+
+	return black_score;
+}
+
+void work()
+{
+	int index;
+
+	while (!g_done && (index = g_next++) < g_games)
+	{
+		// Engines alternate colors between games of a pair
+		bool a_black = (index % 2 == 0);
+
+		float black_score = play(index, (a_black ? g_engine_a : g_engine_b), (a_black ? g_engine_b : g_engine_a));
+		float a_score = (a_black ? black_score : 1.0f - black_score);
+
+		std::lock_guard<std::mutex> lock(g_mutex);
+
+		if (a_score == 1.0f)
+			++g_wins;
+
+		else if (a_score == 0.0f)
+			++g_losses;
+
+		else
+			++g_draws;
+
+		report();
+
+		if (g_sprt)
+		{
+			double LLR = getLLR();
+
+			if (LLR <= std::log(g_beta / (1.0 - g_alpha)) || LLR >= std::log((1.0 - g_beta) / g_alpha))
+				g_done = true;
+		}
+	}
+}
+
+void report()
+{
+	int games = g_wins + g_draws + g_losses;
+
+	if (games == 0)
+		return;
+
+	double score = (g_wins + 0.5 * g_draws) / games;
+
+	// Variance of score per game about its mean
+	double variance = (g_wins * std::pow(1.0 - score, 2) + g_draws * std::pow(0.5 - score, 2) + g_losses * std::pow(score, 2)) / games;
+	double deviation = std::sqrt(variance / games);
+
+	auto elo = [](double p_score) { p_score = std::min(std::max(p_score, 1e-6), 1.0 - 1e-6); return 0.0 - 400.0 * std::log10(1.0 / p_score - 1.0); };
+
+	double lower = elo(score - 1.96 * deviation);
+	double upper = elo(score + 1.96 * deviation);
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "Games: " << games << " | W: " << g_wins << " D: " << g_draws << " L: " << g_losses;
+	std::cout << " | Score: " << 100.0 * score << "%";
+	std::cout << " | Elo: " << elo(score) << " [" << lower << ", " << upper << "]";
+
+	if (g_sprt)
+	{
+		double LLR = getLLR();
+
+		double lower_bound = std::log(g_beta / (1.0 - g_alpha));
+		double upper_bound = std::log((1.0 - g_beta) / g_alpha);
+
+		std::cout << std::setprecision(2) << " | LLR: " << LLR << " (" << lower_bound << ", " << upper_bound << ")";
+
+		if (LLR >= upper_bound)
+			std::cout << " H1 accepted";
+
+		else if (LLR <= lower_bound)
+			std::cout << " H0 accepted";
+	}
+
+	std::cout << std::endl;
+}
+
+// Log likelihood ratio of elo1 over elo0 by normal approximation of trinomial results
+double getLLR()
+{
+	int games = g_wins + g_draws + g_losses;
+
+	if (games == 0 || g_wins + g_losses == 0)
+		return 0.0;
+
+	double score = (g_wins + 0.5 * g_draws) / games;
+	double variance = (g_wins * std::pow(1.0 - score, 2) + g_draws * std::pow(0.5 - score, 2) + g_losses * std::pow(score, 2)) / games;
+
+	if (variance <= 0.0)
+		return 0.0;
+
+	double score0 = 1.0 / (1.0 + std::pow(10.0, -g_elo0 / 400.0));
+	double score1 = 1.0 / (1.0 + std::pow(10.0, -g_elo1 / 400.0));
+
+	return (games * (score1 - score0) * (2.0 * score - score0 - score1) / (2.0 * variance));
+}
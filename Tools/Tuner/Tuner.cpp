@@ -0,0 +1,397 @@
+/* ============================================================================
+ * Project:	Gungi3D
+ * 
+ * File:	Tuner.cpp
+ * 
+ * Summary:	Tunes the material weights and hand discount against labelled
+ *		self-play positions by minimizing the error of the expected result
+ *		predicted by evaluation (Texel's method) and writes Game/Weights.h
+ * 
+ * Origin:	N/A
+ * 
+ * Legal:	Unregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved
+ *		Unauthorized duplication, reproduction, modification, and/or
+ *		distribution is strictly prohibited
+ *		All materials, including, but not limited to, code, resources
+ *		(models, textures, etc.), documents, etc. are deliberately
+ *		unlicensed
+ * ============================================================================
+ * 
+ * Samples are lines written by Player::writeSample:
+ *	<board terms>;<hand terms>;<result for active color>
+ * where each set of terms is NUM_WEIGHTS comma separated net piece counts
+ * 
+ * Usage:	Tuner [-o Headers/Game/Weights.h] [-i iterations] [-k scale] [-t threads] <samples> ...
+ */
+
+#include "Game/Weights.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define NUM_TERMS (NUM_WEIGHTS * 2) // Board terms followed by hand terms
+
+#define TUNER_ITERATIONS 1000
+#define TUNER_RATE 2.0 // Largest weight change per iteration
+#define TUNER_PERCENT_RATE 0.2 // Largest hand percent change per iteration
+
+#define TUNER_MIN_SCALE 50.0
+#define TUNER_MAX_SCALE 5000.0
+
+#define TUNER_FIXED 2 // Blank and commander weights are never tuned since neither can be captured
+
+struct Samples
+{
+	std::vector<float> terms; // NUM_TERMS consecutive terms per sample
+	std::vector<float> results;
+};
+
+struct Parameters
+{
+	double weights[NUM_WEIGHTS];
+	double percent;
+};
+
+Samples g_samples;
+
+int g_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+bool load(const std::string &p_path_ref);
+bool write(const std::string &p_path_ref, const Parameters &p_parameters_ref);
+
+double error(const Parameters &p_parameters_ref, double p_scale, double *p_gradient_ptr);
+
+void work(const float *p_coefficients_ptr, double p_scale, std::size_t p_begin, std::size_t p_end, double *p_error_ptr, double *p_gradient_ptr);
+
+double fitScale(const Parameters &p_parameters_ref);
+
+int main(int argc, char **argv)
+{
+	std::string output = "Headers/Game/Weights.h";
+
+	int iterations = TUNER_ITERATIONS;
+	double scale = 0.0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "-o" && i + 1 < argc)
+			output = argv[++i];
+
+		else if (arg == "-i" && i + 1 < argc)
+			iterations = std::atoi(argv[++i]);
+
+		else if (arg == "-k" && i + 1 < argc)
+			scale = std::atof(argv[++i]);
+
+		else if (arg == "-t" && i + 1 < argc)
+			g_threads = std::max(1, std::atoi(argv[++i]));
+
+		else if (!load(arg))
+			return 1;
+	}
+
+	if (g_samples.results.empty())
+	{
+		std::cerr << "ERROR::TUNER::NO_SAMPLES" << std::endl;
+		return 1;
+	}
+
+	Parameters parameters;
+
+	for (int i = 0; i < NUM_WEIGHTS; ++i)
+		parameters.weights[i] = WEIGHTS[i];
+
+	parameters.percent = HAND_PERCENT;
+
+	// Scale is fitted to current weights so that they remain comparable in magnitude
+	if (scale <= 0.0)
+		scale = fitScale(parameters);
+
+	std::cout << "samples " << g_samples.results.size() << " | scale " << scale << " | error " << error(parameters, scale, nullptr) << std::endl;
+
+	// Adam, with step sizes bounded by rate
+	double gradient[NUM_WEIGHTS + 1];
+	double moment1[NUM_WEIGHTS + 1] = {};
+	double moment2[NUM_WEIGHTS + 1] = {};
+
+	for (int i = 1; i <= iterations; ++i)
+	{
+		double e = error(parameters, scale, gradient);
+
+		for (int j = TUNER_FIXED; j <= NUM_WEIGHTS; ++j)
+		{
+			moment1[j] = 0.9 * moment1[j] + 0.1 * gradient[j];
+			moment2[j] = 0.999 * moment2[j] + 0.001 * gradient[j] * gradient[j];
+
+			double step = (moment1[j] / (1.0 - std::pow(0.9, i))) / (std::sqrt(moment2[j] / (1.0 - std::pow(0.999, i))) + 1e-12);
+
+			if (j < NUM_WEIGHTS)
+				parameters.weights[j] = std::max(0.0, parameters.weights[j] - TUNER_RATE * step);
+
+			else
+				parameters.percent = std::min(100.0, std::max(0.0, parameters.percent - TUNER_PERCENT_RATE * step));
+		}
+
+		if (i % 100 == 0 || i == iterations)
+			std::cout << "iteration " << i << " | error " << e << " | hand percent " << parameters.percent << std::endl;
+	}
+
+	return (write(output, parameters) ? 0 : 1);
+}
+
+bool load(const std::string &p_path_ref)
+{
+	std::ifstream file;
+	file.open(p_path_ref, std::ios_base::in);
+
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR::TUNER::LOAD::FILE::OPEN_FAILED >> " << p_path_ref << std::endl;
+		return false;
+	}
+
+	std::string line;
+	float terms[NUM_TERMS];
+
+	while (std::getline(file, line))
+	{
+		const char *ptr = line.c_str();
+		char *end = nullptr;
+
+		int count = 0;
+
+		// Terms are separated by commas and sets of terms by semicolons alike
+		while (count < NUM_TERMS)
+		{
+			long value = std::strtol(ptr, &end, 10);
+
+			if (end == ptr || (*end != ',' && *end != ';'))
+				break;
+
+			terms[count++] = static_cast<float>(value);
+			ptr = end + 1;
+		}
+
+		float result = std::strtof(ptr, &end);
+
+		if (count != NUM_TERMS || end == ptr)
+		{
+			std::cerr << "ERROR::TUNER::LOAD::BAD_SAMPLE >> " << p_path_ref << " >> " << line << std::endl;
+			continue;
+		}
+
+		g_samples.terms.insert(g_samples.terms.end(), terms, terms + NUM_TERMS);
+		g_samples.results.push_back(result);
+	}
+
+	file.close();
+
+	return true;
+}
+
+// Layout matches that of original hand written header so that reruns only change values
+bool write(const std::string &p_path_ref, const Parameters &p_parameters_ref)
+{
+	std::ofstream file;
+	file.open(p_path_ref, std::ios_base::out | std::ios_base::binary);
+
+	if (!file.is_open())
+	{
+		std::cerr << "ERROR::TUNER::WRITE::FILE::OPEN_FAILED >> " << p_path_ref << std::endl;
+		return false;
+	}
+
+	const char *eol = "\r\n";
+
+	file << "/* ============================================================================" << eol;
+	file << " * Project:\tGungi3D" << eol;
+	file << " * " << eol;
+	file << " * File:\tWeights.h" << eol;
+	file << " * " << eol;
+	file << " * Summary:\tMaintains the material weights used in evaluation, as generated" << eol;
+	file << " *\t\tby the tuner in Tools/Tuner from labelled self-play positions" << eol;
+	file << " * " << eol;
+	file << " * Origin:\tN/A" << eol;
+	file << " * " << eol;
+	file << " * Legal:\tUnregistered Copyright (C) 2018 Chris Malnick - All Rights Reserved" << eol;
+	file << " *\t\tUnauthorized duplication, reproduction, modification, and/or" << eol;
+	file << " *\t\tdistribution is strictly prohibited" << eol;
+	file << " *\t\tAll materials, including, but not limited to, code, resources" << eol;
+	file << " *\t\t(models, textures, etc.), documents, etc. are deliberately" << eol;
+	file << " *\t\tunlicensed" << eol;
+	file << " * ============================================================================" << eol;
+	file << " */" << eol << eol;
+
+	file << "#ifndef WEIGHTS_H" << eol;
+	file << "#define WEIGHTS_H" << eol << eol;
+
+	file << "#define NUM_WEIGHTS " << NUM_WEIGHTS << eol;
+	file << "#define HAND_PERCENT " << static_cast<int>(std::lround(p_parameters_ref.percent)) << " // Portion of weight credited to pieces in hand" << eol << eol;
+
+	file << "// Weight values corresponding to piece front and back faces" << eol;
+	file << "static const int WEIGHTS[] =" << eol;
+	file << "{" << eol;
+	file << "\t" << static_cast<int>(std::lround(p_parameters_ref.weights[0])) << "," << eol;
+
+	for (int i = 1; i < NUM_WEIGHTS; ++i)
+	{
+		file << (i % 12 == 1 ? "\t" : " ") << std::lround(p_parameters_ref.weights[i]) << ",";
+
+		if (i % 12 == 0 || i == NUM_WEIGHTS - 1)
+			file << eol;
+	}
+
+	file << "};" << eol << eol;
+	file << "#endif // WEIGHTS_H" << eol;
+
+	file.close();
+
+	return true;
+}
+
+// Mean squared difference between results and those expected by evaluation
+// Gradient with respect to each weight followed by hand percent is optionally computed
+double error(const Parameters &p_parameters_ref, double p_scale, double *p_gradient_ptr)
+{
+	// Evaluation is linear in terms, so each sample reduces to a single dot product
+	alignas(32) float coefficients[NUM_TERMS];
+
+	for (int i = 0; i < NUM_WEIGHTS; ++i)
+	{
+		coefficients[i] = static_cast<float>(p_parameters_ref.weights[i]);
+		coefficients[NUM_WEIGHTS + i] = static_cast<float>(p_parameters_ref.weights[i] * p_parameters_ref.percent / 100.0);
+	}
+
+	std::size_t size = g_samples.results.size();
+	std::size_t chunk = (size + g_threads - 1) / g_threads;
+
+	std::vector<double> errors(g_threads, 0.0);
+	std::vector<double> gradients(g_threads * NUM_TERMS, 0.0);
+
+	std::vector<std::thread> threads;
+
+	for (int i = 0; i < g_threads; ++i)
+	{
+		std::size_t begin = std::min(size, i * chunk);
+		std::size_t end = std::min(size, begin + chunk);
+
+		threads.push_back(std::thread(work, coefficients, p_scale, begin, end, &errors[i], (p_gradient_ptr != nullptr ? &gradients[i * NUM_TERMS] : nullptr)));
+	}
+
+	for (auto &elem : threads)
+		elem.join();
+
+	double total = 0.0;
+
+	for (auto &elem : errors)
+		total += elem;
+
+	if (p_gradient_ptr != nullptr)
+	{
+		double terms[NUM_TERMS] = {};
+
+		for (int i = 0; i < g_threads; ++i)
+		{
+			for (int j = 0; j < NUM_TERMS; ++j)
+				terms[j] += gradients[i * NUM_TERMS + j] / size;
+		}
+
+		p_gradient_ptr[NUM_WEIGHTS] = 0.0;
+
+		for (int i = 0; i < NUM_WEIGHTS; ++i)
+		{
+			p_gradient_ptr[i] = terms[i] + terms[NUM_WEIGHTS + i] * p_parameters_ref.percent / 100.0;
+			p_gradient_ptr[NUM_WEIGHTS] += terms[NUM_WEIGHTS + i] * p_parameters_ref.weights[i] / 100.0;
+		}
+	}
+
+	return (total / size);
+}
+
+// Inner loops are over contiguous terms so that they vectorize
+void work(const float *p_coefficients_ptr, double p_scale, std::size_t p_begin, std::size_t p_end, double *p_error_ptr, double *p_gradient_ptr)
+{
+	float gradient[NUM_TERMS] = {};
+	double total = 0.0;
+
+	float scale = static_cast<float>(1.0 / p_scale);
+
+	for (std::size_t i = p_begin; i < p_end; ++i)
+	{
+		const float *terms_ptr = &g_samples.terms[i * NUM_TERMS];
+
+		float score = 0.0f;
+
+		for (int j = 0; j < NUM_TERMS; ++j)
+			score += p_coefficients_ptr[j] * terms_ptr[j];
+
+		float expected = 1.0f / (1.0f + std::exp(-score * scale));
+		float difference = expected - g_samples.results[i];
+
+		total += difference * difference;
+
+		if (p_gradient_ptr != nullptr)
+		{
+			float factor = 2.0f * difference * expected * (1.0f - expected) * scale;
+
+			for (int j = 0; j < NUM_TERMS; ++j)
+				gradient[j] += factor * terms_ptr[j];
+		}
+	}
+
+	*p_error_ptr = total;
+
+	if (p_gradient_ptr != nullptr)
+	{
+		for (int i = 0; i < NUM_TERMS; ++i)
+			p_gradient_ptr[i] = gradient[i];
+	}
+}
+
+// Golden section search for scale minimizing error of specified parameters
+double fitScale(const Parameters &p_parameters_ref)
+{
+	const double ratio = (std::sqrt(5.0) - 1.0) / 2.0;
+
+	double a = TUNER_MIN_SCALE;
+	double b = TUNER_MAX_SCALE;
+
+	double c = b - ratio * (b - a);
+	double d = a + ratio * (b - a);
+
+	double error_c = error(p_parameters_ref, c, nullptr);
+	double error_d = error(p_parameters_ref, d, nullptr);
+
+	while (b - a > 1.0)
+	{
+		if (error_c < error_d)
+		{
+			b = d;
+			d = c;
+			error_d = error_c;
+
+			c = b - ratio * (b - a);
+			error_c = error(p_parameters_ref, c, nullptr);
+		}
+
+		else
+		{
+			a = c;
+			c = d;
+			error_c = error_d;
+
+			d = a + ratio * (b - a);
+			error_d = error(p_parameters_ref, d, nullptr);
+		}
+	}
+
+	return ((a + b) / 2.0);
+}